@@ -3,11 +3,30 @@ layout (location = 0) out vec4 f_color;
 
 in vec2 v_texCoord;
 in float v_texIndex;
+in vec2 v_worldPos;
 
 uniform sampler2D u_textures[32];
 
+// One texel per tile: 0 = unexplored, 1 = explored, 2 = visible
+layout(binding = 0, r8ui) uniform readonly uimage2D u_visibility;
+uniform int u_visibilityEnabled;
+
 void main()
 {
 	int index = int(v_texIndex);
 	f_color = texture(u_textures[index], v_texCoord);
+
+	if (u_visibilityEnabled != 0) {
+		// The mask only covers part of the world, tiles outside it are always visible
+		ivec2 tile = ivec2(floor(v_worldPos));
+		bool inMask = all(greaterThanEqual(tile, ivec2(0))) && all(lessThan(tile, imageSize(u_visibility)));
+		uint state = inMask ? imageLoad(u_visibility, tile).r : 2u;
+		if (state == 0u) {
+			f_color.rgb = vec3(0.0);
+		} else if (state == 1u) {
+			// Remembered terrain is shown dim and mostly desaturated
+			float luma = dot(f_color.rgb, vec3(0.299, 0.587, 0.114));
+			f_color.rgb = mix(vec3(luma), f_color.rgb, 0.3) * 0.5;
+		}
+	}
 }
\ No newline at end of file
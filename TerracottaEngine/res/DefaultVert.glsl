@@ -6,6 +6,7 @@ layout(location = 2) in float a_texIndex;
 
 out vec2 v_texCoord;
 out float v_texIndex;
+out vec2 v_worldPos;
 
 uniform mat4 u_view;
 uniform mat4 u_projection;
@@ -16,4 +17,5 @@ void main()
 	gl_Position = u_projection * u_view * vec4(a_pos, 1.0);
 	v_texCoord = a_texCoord;
 	v_texIndex = a_texIndex;
+	v_worldPos = a_pos.xy;
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 460 core
+out vec2 v_texCoord;
+
+void main()
+{
+	// One triangle covering the screen, no vertex buffer needed
+	vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	v_texCoord = position;
+	gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 460 core
+layout (location = 0) out vec4 f_color;
+
+in vec2 v_texCoord;
+
+uniform sampler2D u_source;
+uniform vec2 u_direction; // One texel along the blur axis
+
+// 9-tap gaussian in 5 fetches by sampling between texels
+const float OFFSETS[3] = float[](0.0, 1.3846153846, 3.2307692308);
+const float WEIGHTS[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
+
+void main()
+{
+	vec3 result = texture(u_source, v_texCoord).rgb * WEIGHTS[0];
+	for (int i = 1; i < 3; i++) {
+		result += texture(u_source, v_texCoord + u_direction * OFFSETS[i]).rgb * WEIGHTS[i];
+		result += texture(u_source, v_texCoord - u_direction * OFFSETS[i]).rgb * WEIGHTS[i];
+	}
+	f_color = vec4(result, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 460 core
+layout (location = 0) out vec4 f_color;
+
+in vec2 v_texCoord;
+
+uniform sampler2D u_light;
+
+void main()
+{
+	// Blended with GL_DST_COLOR, GL_ZERO so this multiplies the scene
+	f_color = vec4(texture(u_light, v_texCoord).rgb, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 460 core
+layout (location = 0) out vec4 f_color;
+
+in vec2 v_local;
+in vec3 v_color;
+
+void main()
+{
+	// Smooth quadratic falloff reaching zero at the radius
+	float falloff = clamp(1.0 - dot(v_local, v_local), 0.0, 1.0);
+	f_color = vec4(v_color * falloff * falloff, 0.0);
+}
\ No newline at end of file
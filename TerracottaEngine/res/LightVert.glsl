@@ -0,0 +1,22 @@
+#version 460 core
+layout (location = 0) in vec2 a_center;
+layout (location = 1) in float a_radius;
+layout (location = 2) in float a_intensity;
+layout (location = 3) in vec3 a_color;
+
+out vec2 v_local;
+out vec3 v_color;
+
+uniform mat4 u_view;
+uniform mat4 u_projection;
+
+const vec2 CORNERS[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+void main()
+{
+	// One instanced quad per light, sized to its radius
+	vec2 corner = CORNERS[gl_VertexID];
+	gl_Position = u_projection * u_view * vec4(a_center + corner * a_radius, 0.0, 1.0);
+	v_local = corner;
+	v_color = a_color * a_intensity;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#version 460 core
+
+layout(local_size_x = 64) in;
+
+struct Particle
+{
+	vec2 position;
+	vec2 velocity;
+	vec4 color;
+	float life;
+	float maxLife;
+	float size;
+	float padding;
+};
+
+struct EmitRequest
+{
+	vec2 position;
+	vec2 velocity;
+	vec4 color;
+	float spread;
+	float lifetime;
+	float size;
+	uint count;
+};
+
+layout(std430, binding = 1) writeonly buffer ParticlesOut { Particle particlesOut[]; };
+layout(std430, binding = 2) buffer Counters
+{
+	uint vertexCount;
+	uint instanceCount;
+	uint firstVertex;
+	uint baseInstance;
+	uint groupsX, groupsY, groupsZ;
+	uint aliveOut;
+};
+layout(std430, binding = 3) readonly buffer EmitRequests { EmitRequest requests[]; };
+
+uniform uint u_maxParticles;
+uniform uint u_seed;
+
+// PCG hash, returns [0, 1)
+float random(inout uint state)
+{
+	state = state * 747796405u + 2891336453u;
+	uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+	return float((word >> 22u) ^ word) / 4294967296.0;
+}
+
+void main()
+{
+	// One row of workgroups per request
+	EmitRequest request = requests[gl_WorkGroupID.y];
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= request.count)
+		return;
+
+	uint slot = atomicAdd(aliveOut, 1u);
+	if (slot >= u_maxParticles)
+		return; // Full, finalize clamps the count
+
+	uint state = index * 1973u + gl_WorkGroupID.y * 9277u + u_seed * 26699u;
+	float angle = random(state) * 6.28318530718;
+	float speed = sqrt(random(state)) * request.spread;
+
+	Particle p;
+	p.position = request.position;
+	p.velocity = request.velocity + vec2(cos(angle), sin(angle)) * speed;
+	p.color = request.color;
+	p.maxLife = request.lifetime * mix(0.75, 1.25, random(state));
+	p.life = p.maxLife;
+	p.size = request.size;
+	p.padding = 0.0;
+	particlesOut[slot] = p;
+}
\ No newline at end of file
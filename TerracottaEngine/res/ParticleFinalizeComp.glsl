@@ -0,0 +1,35 @@
+#version 460 core
+
+layout(local_size_x = 1) in;
+
+layout(std430, binding = 2) buffer Counters
+{
+	uint vertexCount;
+	uint instanceCount;
+	uint firstVertex;
+	uint baseInstance;
+	uint groupsX, groupsY, groupsZ;
+	uint aliveOut;
+};
+
+uniform uint u_maxParticles;
+
+const uint SIMULATE_WORKGROUP_SIZE = 256;
+
+void main()
+{
+	uint alive = min(aliveOut, u_maxParticles);
+
+	// Indirect draw: one 4 vertex strip per particle
+	vertexCount = 4;
+	instanceCount = alive;
+	firstVertex = 0;
+	baseInstance = 0;
+
+	// Indirect dispatch for the next simulate pass
+	groupsX = (alive + SIMULATE_WORKGROUP_SIZE - 1) / SIMULATE_WORKGROUP_SIZE;
+	groupsY = 1;
+	groupsZ = 1;
+
+	aliveOut = 0;
+}
\ No newline at end of file
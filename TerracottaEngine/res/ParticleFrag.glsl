@@ -0,0 +1,16 @@
+#version 460 core
+
+in vec4 v_color;
+in vec2 v_local;
+
+out vec4 f_color;
+
+void main()
+{
+	// Soft round particle
+	float distanceSq = dot(v_local, v_local);
+	if (distanceSq > 1.0)
+		discard;
+
+	f_color = vec4(v_color.rgb, v_color.a * (1.0 - distanceSq));
+}
\ No newline at end of file
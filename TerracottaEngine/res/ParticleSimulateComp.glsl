@@ -0,0 +1,65 @@
+#version 460 core
+
+layout(local_size_x = 256) in;
+
+struct Particle
+{
+	vec2 position;
+	vec2 velocity;
+	vec4 color;
+	float life;
+	float maxLife;
+	float size;
+	float padding;
+};
+
+layout(std430, binding = 0) readonly buffer ParticlesIn { Particle particlesIn[]; };
+layout(std430, binding = 1) writeonly buffer ParticlesOut { Particle particlesOut[]; };
+layout(std430, binding = 2) buffer Counters
+{
+	uint vertexCount;
+	uint instanceCount; // Live particles in ParticlesIn
+	uint firstVertex;
+	uint baseInstance;
+	uint groupsX, groupsY, groupsZ;
+	uint aliveOut;
+};
+
+uniform float u_deltaTime;
+uniform vec2 u_gravity;
+
+shared uint s_groupAlive;
+shared uint s_groupBase;
+
+void main()
+{
+	if (gl_LocalInvocationIndex == 0)
+		s_groupAlive = 0;
+	barrier();
+
+	// Every thread has to reach the barriers, so dead/out of range threads just don't claim a slot
+	uint index = gl_GlobalInvocationID.x;
+	Particle p;
+	bool alive = false;
+	if (index < instanceCount) {
+		p = particlesIn[index];
+		p.life -= u_deltaTime;
+		alive = p.life > 0.0;
+	}
+
+	// One global atomic per workgroup instead of one per particle
+	uint localSlot = 0;
+	if (alive) {
+		p.velocity += u_gravity * u_deltaTime;
+		p.position += p.velocity * u_deltaTime;
+		localSlot = atomicAdd(s_groupAlive, 1u);
+	}
+	barrier();
+
+	if (gl_LocalInvocationIndex == 0)
+		s_groupBase = atomicAdd(aliveOut, s_groupAlive);
+	barrier();
+
+	if (alive)
+		particlesOut[s_groupBase + localSlot] = p;
+}
\ No newline at end of file
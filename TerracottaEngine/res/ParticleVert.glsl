@@ -0,0 +1,36 @@
+#version 460 core
+
+struct Particle
+{
+	vec2 position;
+	vec2 velocity;
+	vec4 color;
+	float life;
+	float maxLife;
+	float size;
+	float padding;
+};
+
+layout(std430, binding = 0) readonly buffer Particles { Particle particles[]; };
+
+out vec4 v_color;
+out vec2 v_local;
+
+uniform mat4 u_view;
+uniform mat4 u_projection;
+uniform float u_rewind; // Seconds to step back so particles line up with the interpolated camera
+
+const vec2 CORNERS[4] = vec2[](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(-0.5, 0.5), vec2(0.5, 0.5));
+
+void main()
+{
+	// No vertex buffers, everything is pulled from the particle SSBO
+	Particle p = particles[gl_InstanceID];
+	vec2 corner = CORNERS[gl_VertexID];
+	vec2 position = p.position - p.velocity * u_rewind + corner * p.size;
+
+	gl_Position = u_projection * u_view * vec4(position, 0.0, 1.0);
+	v_color = p.color;
+	v_color.a *= clamp(p.life / p.maxLife, 0.0, 1.0);
+	v_local = corner * 2.0;
+}
\ No newline at end of file
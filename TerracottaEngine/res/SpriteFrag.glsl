@@ -0,0 +1,24 @@
+#version 460 core
+layout (location = 0) out vec4 f_color;
+
+in vec2 v_texCoord;
+in vec4 v_color;
+in float v_texIndex;
+in float v_distanceField;
+
+uniform sampler2D u_textures[32];
+
+void main()
+{
+	int index = int(v_texIndex);
+	vec4 texel = texture(u_textures[index], v_texCoord);
+
+	if (v_distanceField > 0.5) {
+		// Glyph edge sits at 0.5, antialias over one screen pixel whatever the scale
+		float distance = texel.r;
+		float width = fwidth(distance);
+		f_color = vec4(v_color.rgb, v_color.a * smoothstep(0.5 - width, 0.5 + width, distance));
+	} else {
+		f_color = texel * v_color;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#version 460 core
+
+layout(location = 0) in vec3 a_pos;
+layout(location = 1) in vec2 a_texCoord;
+layout(location = 2) in vec4 a_color;
+layout(location = 3) in float a_texIndex;
+layout(location = 4) in float a_distanceField;
+
+out vec2 v_texCoord;
+out vec4 v_color;
+out float v_texIndex;
+out float v_distanceField;
+
+uniform mat4 u_view;
+uniform mat4 u_projection;
+
+void main()
+{
+	gl_Position = u_projection * u_view * vec4(a_pos, 1.0);
+	v_texCoord = a_texCoord;
+	v_color = a_color;
+	v_texIndex = a_texIndex;
+	v_distanceField = a_distanceField;
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 // Hot reload for Unix operating systems
 
+#include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <string>
 #include "spdlog/spdlog.h"
@@ -25,10 +27,12 @@ Application::Application(int windowWidth, int windowHeight)
 	SubsystemManager& managerRef = *m_subsystemManager;
 	m_eventSystem = m_subsystemManager->RegisterSubsystem<EventSystem>(managerRef);
 	m_eventSystem->LinkToGLFWWindow(m_window->GetGLFWWindow());
+	m_frameScheduler = m_subsystemManager->RegisterSubsystem<FrameScheduler>(managerRef, *m_window);
 	m_inputSystem = m_subsystemManager->RegisterSubsystem<InputSystem>(managerRef);
 	m_audioSystem = m_subsystemManager->RegisterSubsystem<AudioSystem>(managerRef);
 	m_randomGenerator = m_subsystemManager->RegisterSubsystem<RandomGenerator>(managerRef);
 	m_renderer = m_subsystemManager->RegisterSubsystem<Renderer>(managerRef, *m_window);
+	m_frameCapture = m_subsystemManager->RegisterSubsystem<FrameCaptureSystem>(managerRef, *m_window);
 	m_layers.PushLayer(new DearImGuiLayer(m_window->GetGLFWWindow(), "Main DearImGui Layer"));
 
 	// Create Engine API struct with function pointers
@@ -39,6 +43,9 @@ Application::Application(int windowWidth, int windowHeight)
 		SPDLOG_ERROR("Failed to load the game's shared library!");
 	}
 
+	// Start pacing from here so loading time doesn't count as a stall
+	m_prevTime = glfwGetTime();
+
 	SPDLOG_INFO("Finished creating application.");
 }
 Application::~Application()
@@ -51,29 +58,61 @@ Application::~Application()
 
 void Application::Run()
 {
-	static float prevTime = (float)glfwGetTime(), updateAcc = 0.0f, renderAcc = 0.0f;
-
-	float currTime = (float)glfwGetTime();
-	const float deltaTime = currTime - prevTime;
-	prevTime = currTime;
-	updateAcc += deltaTime;
-	renderAcc += deltaTime;
+	const double currTime = glfwGetTime();
+	const double deltaTime = currTime - m_prevTime;
+	m_prevTime = currTime;
+	m_updateAcc += deltaTime;
+	m_renderAcc += deltaTime;
 
 	glfwPollEvents();
 
-	while (updateAcc >= m_targetUpdateDelay) {
+	// Fixed-step updates. After a long stall (breakpoint, window drag) drop the backlog instead of
+	// spiralling into more and more updates per frame.
+	uint32_t updateSteps = 0;
+	while (m_updateAcc >= m_targetUpdateDelay) {
+		if (updateSteps == MAX_CATCH_UP_STEPS) {
+			SPDLOG_WARN("Update loop fell {:.1f} ms behind, skipping ahead", m_updateAcc * 1000.0);
+			m_updateAcc = std::fmod(m_updateAcc, (double)m_targetUpdateDelay);
+			break;
+		}
 		update(m_targetUpdateDelay);
-		updateAcc -= m_targetUpdateDelay;
+		m_updateAcc -= m_targetUpdateDelay;
+		updateSteps++;
 	}
 
-	while (renderAcc >= m_targetFrameDelay) {
-		render();
-		renderAcc -= m_targetFrameDelay;
+	// Recordings need every frame, even when nothing changed
+	if (m_frameCapture->IsRecording()) {
+		m_frameScheduler->RequestRedraw();
+	}
+
+	const double frameDelay = m_frameScheduler->GetFrameDelay(m_targetFrameDelay);
+	if (frameDelay <= 0.0) {
+		m_renderAcc = 0.0; // Iconified
+	} else if (m_renderAcc >= frameDelay) {
+		if (m_frameScheduler->ShouldRender()) {
+			// How far we are between the last two updates
+			render((float)(m_updateAcc / m_targetUpdateDelay));
+		}
+		// Rendering the same state twice to catch up is wasted work, drop the missed frames
+		m_renderAcc = std::fmod(m_renderAcc, frameDelay);
 	}
 
 	if (glfwWindowShouldClose(m_window->GetGLFWWindow())) {
 		Stop();
+		return;
+	}
+
+	// Sleep until the next update or frame is due instead of spinning. Only frame deadlines need to be hit
+	// exactly, a late update is absorbed by the accumulator.
+	const double nextUpdate = currTime + (m_targetUpdateDelay - m_updateAcc);
+	if (frameDelay > 0.0 && m_frameScheduler->HasPendingFrame()) {
+		const double nextFrame = currTime + (frameDelay - m_renderAcc);
+		if (nextFrame <= nextUpdate) {
+			m_frameScheduler->WaitUntil(nextFrame, true);
+			return;
+		}
 	}
+	m_frameScheduler->WaitUntil(nextUpdate, false);
 }
 
 void Application::Stop()
@@ -91,6 +130,22 @@ void Application::update(const float deltaTime)
 		reloadGameDLL();
 	}
 
+	// Capture keys
+	if (m_inputSystem->IsKeyStartPress(GLFW_KEY_F12)) {
+		m_frameCapture->RequestScreenshot(captureFilename("screenshot", ".tga"));
+	}
+	if (m_inputSystem->IsKeyStartPress(GLFW_KEY_F4)) {
+		bool onDemand = m_frameScheduler->GetRenderMode() == RenderMode::OnDemand;
+		m_frameScheduler->SetRenderMode(onDemand ? RenderMode::Continuous : RenderMode::OnDemand);
+	}
+	if (m_inputSystem->IsKeyStartPress(GLFW_KEY_F11)) {
+		if (m_frameCapture->IsRecording()) {
+			m_frameCapture->StopRecording();
+		} else {
+			m_frameCapture->StartRecording(captureFilename("capture", ".bgra"));
+		}
+	}
+
 	// Audio test keys
 	if (m_inputSystem->IsKeyDown(GLFW_KEY_0)) {
 		m_audioSystem->PlayAudio("../../../../../TerracottaEngine/res/bass.ogg");
@@ -113,10 +168,11 @@ void Application::update(const float deltaTime)
 	m_inputSystem->OnUpdateEnd();
 }
 
-void Application::render()
+void Application::render(const float alpha)
 {
 	// Buffer clears in main renderer
-	m_renderer->OnRender();
+	m_renderer->OnRender(alpha);
+	m_frameCapture->CaptureFrame();
 
 	for (Layer* layer : m_layers) {
 		layer->OnRender();
@@ -126,6 +182,13 @@ void Application::render()
 	glfwSwapBuffers(m_window->GetGLFWWindow());
 }
 
+std::string Application::captureFilename(const char* prefix, const char* extension) const
+{
+	auto now = std::chrono::system_clock::now();
+	auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+	return std::string(prefix) + "_" + std::to_string(timestamp) + extension;
+}
+
 bool Application::loadGameDLL()
 {
 #ifdef _WIN32
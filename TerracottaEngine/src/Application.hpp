@@ -13,6 +13,8 @@
 #include "EventSystem.hpp"
 #include "InputSystem.hpp"
 #include "AudioSystem.hpp"
+#include "FrameCaptureSystem.hpp"
+#include "FrameScheduler.hpp"
 #include "RandomGenerator.hpp"
 
 namespace TerracottaEngine
@@ -48,9 +50,12 @@ public:
 	Renderer* GetRenderer() { return m_renderer; }
 	InputSystem* GetInputSystem() { return m_inputSystem; }
 	RandomGenerator* GetRandomGenerator() { return m_randomGenerator; }
+	FrameCaptureSystem* GetFrameCapture() { return m_frameCapture; }
+	FrameScheduler* GetFrameScheduler() { return m_frameScheduler; }
 private:
 	void update(const float deltaTime);
-	void render();
+	void render(const float alpha);
+	std::string captureFilename(const char* prefix, const char* extension) const;
 
 	// Subsystems
 	std::unique_ptr<SubsystemManager> m_subsystemManager = nullptr;
@@ -59,6 +64,8 @@ private:
 	AudioSystem* m_audioSystem = nullptr;
 	Renderer* m_renderer = nullptr;
 	RandomGenerator* m_randomGenerator = nullptr;
+	FrameCaptureSystem* m_frameCapture = nullptr;
+	FrameScheduler* m_frameScheduler = nullptr;
 
 	// Other systems
 	std::unique_ptr<Window> m_window = nullptr;
@@ -86,5 +93,10 @@ private:
 	bool m_running = true;
 	int m_maxFPS, m_maxUPS;
 	float m_targetFrameDelay, m_targetUpdateDelay;
+
+	// Frame pacing
+	static constexpr uint32_t MAX_CATCH_UP_STEPS = 5;
+	double m_prevTime = 0.0;
+	double m_updateAcc = 0.0, m_renderAcc = 0.0;
 };
 } // namespace TerracottaEngine
\ No newline at end of file
@@ -15,6 +15,7 @@ Camera::Camera(SubsystemManager& subsystem, Window& window) :
 	m_aspect = (float)windowDimensions.x / windowDimensions.y;
 
 	Position = glm::vec3(0.0f, 0.0f, 0.0f);
+	PrevPosition = Position;
 	View = glm::lookAt(Position, Position + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 	updateProjection();
 
@@ -33,6 +34,12 @@ void Camera::Update(const float deltaTime)
 		SPDLOG_ERROR("The InputSystem is not initialized for the camera!");
 	}
 
+	// One more upload after the camera stops so the interpolated view settles on the final position
+	if (PrevPosition != Position) {
+		NeedsUpdate = true;
+	}
+	PrevPosition = Position;
+
 	float moveSpeed = 0.1f;
 
 	// Smooth movement (no snapping)
@@ -67,6 +74,12 @@ void Camera::Update(const float deltaTime)
 	View = glm::lookAt(Position, Position + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 }
 
+glm::mat4 Camera::GetInterpolatedView(float alpha) const
+{
+	glm::vec3 position = glm::mix(PrevPosition, Position, glm::clamp(alpha, 0.0f, 1.0f));
+	return glm::lookAt(position, position + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
 void Camera::registerCallbacks()
 {
 	EventSystem* es = m_managerRef.GetSubsystem<EventSystem>();
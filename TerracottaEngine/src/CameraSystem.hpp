@@ -13,10 +13,15 @@ public:
 
 	bool NeedsUpdate = true;
 	glm::vec3 Position;
+	glm::vec3 PrevPosition; // Position before the last update, for interpolation
 	glm::mat4 View;
 	glm::mat4 Projection;
 
 	void Update(const float deltaTime);
+	// View between the last two updates, alpha = leftover update accumulator / update step
+	glm::mat4 GetInterpolatedView(float alpha) const;
+	// World units covered by the projection, Position is the bottom-left corner
+	glm::vec2 GetViewSize() const { return {m_tilesInHeight * m_zoom * m_aspect, m_tilesInHeight * m_zoom}; }
 
 	// Other stuff later...
 private:
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "glm/glm.hpp"
+
+namespace TerracottaEngine
+{
+// Open-addressing map from signed chunk coordinates to a value, used on both sides of the engine API. Keys are the
+// packed (x, y) pair run through a 64-bit mixer, probing is linear and erase shifts the following run back instead
+// of leaving tombstones, so lookups stay short however much of the world has been streamed in and out.
+template <typename T>
+class ChunkHashMap
+{
+public:
+	static uint64_t PackKey(int32_t x, int32_t y) { return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y); }
+	static glm::ivec2 UnpackKey(uint64_t key) { return {static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFFu)}; }
+
+	T* Find(int32_t x, int32_t y)
+	{
+		size_t slot = findSlot(PackKey(x, y));
+		return slot != NOT_FOUND ? &m_slots[slot].Value : nullptr;
+	}
+	const T* Find(int32_t x, int32_t y) const { return const_cast<ChunkHashMap*>(this)->Find(x, y); }
+
+	// Returns the existing value when the key is already present
+	T& Insert(int32_t x, int32_t y, T value)
+	{
+		if ((m_size + 1) * 4 > m_slots.size() * 3) {
+			rehash(m_slots.empty() ? MIN_CAPACITY : m_slots.size() * 2);
+		}
+
+		const uint64_t key = PackKey(x, y);
+		size_t slot = mix(key) & (m_slots.size() - 1);
+		while (m_slots[slot].Occupied) {
+			if (m_slots[slot].Key == key)
+				return m_slots[slot].Value;
+			slot = (slot + 1) & (m_slots.size() - 1);
+		}
+
+		m_slots[slot].Key = key;
+		m_slots[slot].Value = std::move(value);
+		m_slots[slot].Occupied = true;
+		m_size++;
+		return m_slots[slot].Value;
+	}
+
+	bool Erase(int32_t x, int32_t y)
+	{
+		size_t hole = findSlot(PackKey(x, y));
+		if (hole == NOT_FOUND)
+			return false;
+
+		// Pull later entries of the run back into the hole unless that would put them before their home slot
+		const size_t mask = m_slots.size() - 1;
+		size_t next = (hole + 1) & mask;
+		while (m_slots[next].Occupied) {
+			const size_t home = mix(m_slots[next].Key) & mask;
+			if (((next - home) & mask) >= ((next - hole) & mask)) {
+				m_slots[hole] = std::move(m_slots[next]);
+				hole = next;
+			}
+			next = (next + 1) & mask;
+		}
+
+		m_slots[hole] = Slot();
+		m_size--;
+		return true;
+	}
+
+	// func(glm::ivec2 coordinate, T& value), the map must not be modified while iterating
+	template <typename Func>
+	void ForEach(Func&& func)
+	{
+		for (Slot& slot : m_slots) {
+			if (slot.Occupied) {
+				func(UnpackKey(slot.Key), slot.Value);
+			}
+		}
+	}
+	template <typename Func>
+	void ForEach(Func&& func) const
+	{
+		for (const Slot& slot : m_slots) {
+			if (slot.Occupied) {
+				func(UnpackKey(slot.Key), slot.Value);
+			}
+		}
+	}
+
+	void Clear()
+	{
+		m_slots.clear();
+		m_size = 0;
+	}
+	size_t Size() const { return m_size; }
+	bool Empty() const { return m_size == 0; }
+private:
+	static constexpr size_t MIN_CAPACITY = 64; // Always a power of two
+	static constexpr size_t NOT_FOUND = ~size_t(0);
+
+	struct Slot
+	{
+		uint64_t Key = 0;
+		T Value = T();
+		bool Occupied = false;
+	};
+
+	std::vector<Slot> m_slots;
+	size_t m_size = 0;
+
+	// splitmix64 finalizer, neighbouring chunks land far apart
+	static size_t mix(uint64_t key)
+	{
+		key ^= key >> 30;
+		key *= 0xBF58476D1CE4E5B9ull;
+		key ^= key >> 27;
+		key *= 0x94D049BB133111EBull;
+		key ^= key >> 31;
+		return static_cast<size_t>(key);
+	}
+
+	size_t findSlot(uint64_t key) const
+	{
+		if (m_slots.empty())
+			return NOT_FOUND;
+
+		const size_t mask = m_slots.size() - 1;
+		for (size_t slot = mix(key) & mask; m_slots[slot].Occupied; slot = (slot + 1) & mask) {
+			if (m_slots[slot].Key == key)
+				return slot;
+		}
+		return NOT_FOUND;
+	}
+
+	void rehash(size_t capacity)
+	{
+		std::vector<Slot> old = std::move(m_slots);
+		m_slots.clear();
+		m_slots.resize(capacity);
+		m_size = 0;
+		for (Slot& slot : old) {
+			if (slot.Occupied) {
+				glm::ivec2 coord = UnpackKey(slot.Key);
+				Insert(coord.x, coord.y, std::move(slot.Value));
+			}
+		}
+	}
+};
+} // namespace TerracottaEngine
\ No newline at end of file
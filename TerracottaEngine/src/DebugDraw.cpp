@@ -0,0 +1,228 @@
+#include "DebugDraw.hpp"
+
+#ifdef TERRACOTTA_DEBUG_DRAW
+#include <array>
+#include <cctype>
+#include "glm/gtc/constants.hpp"
+#include "spdlog/spdlog.h"
+
+namespace TerracottaEngine
+{
+// 16-segment display glyphs. Cell is 1 unit wide and 2 units tall, origin bottom-left.
+namespace Segment16
+{
+enum : uint16_t
+{
+	A1 = 1 << 0, // Top left half
+	A2 = 1 << 1, // Top right half
+	B = 1 << 2, // Right upper
+	C = 1 << 3, // Right lower
+	D2 = 1 << 4, // Bottom right half
+	D1 = 1 << 5, // Bottom left half
+	E = 1 << 6, // Left lower
+	F = 1 << 7, // Left upper
+	G1 = 1 << 8, // Middle left half
+	G2 = 1 << 9, // Middle right half
+	H = 1 << 10, // Top-left diagonal
+	I = 1 << 11, // Upper vertical
+	J = 1 << 12, // Top-right diagonal
+	K = 1 << 13, // Bottom-left diagonal
+	L = 1 << 14, // Lower vertical
+	M = 1 << 15 // Bottom-right diagonal
+};
+} // namespace Segment16
+
+static constexpr glm::vec2 SEGMENT_LINES[16][2] = {
+	{{0.0f, 2.0f}, {0.5f, 2.0f}}, // A1
+	{{0.5f, 2.0f}, {1.0f, 2.0f}}, // A2
+	{{1.0f, 2.0f}, {1.0f, 1.0f}}, // B
+	{{1.0f, 1.0f}, {1.0f, 0.0f}}, // C
+	{{1.0f, 0.0f}, {0.5f, 0.0f}}, // D2
+	{{0.5f, 0.0f}, {0.0f, 0.0f}}, // D1
+	{{0.0f, 0.0f}, {0.0f, 1.0f}}, // E
+	{{0.0f, 1.0f}, {0.0f, 2.0f}}, // F
+	{{0.0f, 1.0f}, {0.5f, 1.0f}}, // G1
+	{{0.5f, 1.0f}, {1.0f, 1.0f}}, // G2
+	{{0.0f, 2.0f}, {0.5f, 1.0f}}, // H
+	{{0.5f, 2.0f}, {0.5f, 1.0f}}, // I
+	{{1.0f, 2.0f}, {0.5f, 1.0f}}, // J
+	{{0.0f, 0.0f}, {0.5f, 1.0f}}, // K
+	{{0.5f, 0.0f}, {0.5f, 1.0f}}, // L
+	{{1.0f, 0.0f}, {0.5f, 1.0f}} // M
+};
+
+static constexpr std::array<uint16_t, 128> buildGlyphTable()
+{
+	using namespace Segment16;
+	std::array<uint16_t, 128> glyphs = {};
+	glyphs['0'] = A1 | A2 | B | C | D1 | D2 | E | F | J | K;
+	glyphs['1'] = B | C | J;
+	glyphs['2'] = A1 | A2 | B | G1 | G2 | E | D1 | D2;
+	glyphs['3'] = A1 | A2 | B | C | D1 | D2 | G2;
+	glyphs['4'] = F | G1 | G2 | B | C;
+	glyphs['5'] = A1 | A2 | F | G1 | G2 | C | D1 | D2;
+	glyphs['6'] = A1 | A2 | F | E | D1 | D2 | C | G1 | G2;
+	glyphs['7'] = A1 | A2 | B | C;
+	glyphs['8'] = A1 | A2 | B | C | D1 | D2 | E | F | G1 | G2;
+	glyphs['9'] = A1 | A2 | B | C | D1 | D2 | F | G1 | G2;
+	glyphs['A'] = A1 | A2 | B | C | E | F | G1 | G2;
+	glyphs['B'] = A1 | A2 | B | C | D1 | D2 | I | L | G2;
+	glyphs['C'] = A1 | A2 | F | E | D1 | D2;
+	glyphs['D'] = A1 | A2 | B | C | D1 | D2 | I | L;
+	glyphs['E'] = A1 | A2 | F | E | D1 | D2 | G1;
+	glyphs['F'] = A1 | A2 | F | E | G1;
+	glyphs['G'] = A1 | A2 | F | E | D1 | D2 | C | G2;
+	glyphs['H'] = F | E | B | C | G1 | G2;
+	glyphs['I'] = A1 | A2 | I | L | D1 | D2;
+	glyphs['J'] = B | C | D1 | D2 | E;
+	glyphs['K'] = F | E | G1 | J | M;
+	glyphs['L'] = F | E | D1 | D2;
+	glyphs['M'] = F | E | B | C | H | J;
+	glyphs['N'] = F | E | B | C | H | M;
+	glyphs['O'] = A1 | A2 | B | C | D1 | D2 | E | F;
+	glyphs['P'] = A1 | A2 | B | F | E | G1 | G2;
+	glyphs['Q'] = A1 | A2 | B | C | D1 | D2 | E | F | M;
+	glyphs['R'] = A1 | A2 | B | F | E | G1 | G2 | M;
+	glyphs['S'] = A1 | A2 | F | G1 | G2 | C | D1 | D2;
+	glyphs['T'] = A1 | A2 | I | L;
+	glyphs['U'] = F | E | D1 | D2 | C | B;
+	glyphs['V'] = F | E | K | J;
+	glyphs['W'] = F | E | B | C | K | M;
+	glyphs['X'] = H | J | K | M;
+	glyphs['Y'] = H | J | L;
+	glyphs['Z'] = A1 | A2 | J | K | D1 | D2;
+	glyphs['-'] = G1 | G2;
+	glyphs['_'] = D1 | D2;
+	glyphs['+'] = G1 | G2 | I | L;
+	glyphs['='] = G1 | G2 | D1 | D2;
+	glyphs['/'] = J | K;
+	glyphs['\\'] = H | M;
+	glyphs['|'] = I | L;
+	glyphs['*'] = H | I | J | K | L | M | G1 | G2;
+	glyphs['('] = J | M;
+	glyphs[')'] = H | K;
+	glyphs['.'] = D1;
+	glyphs[','] = K;
+	glyphs[':'] = L;
+	glyphs['?'] = A1 | A2 | B | G2 | L;
+	return glyphs;
+}
+
+static constexpr std::array<uint16_t, 128> GLYPHS = buildGlyphTable();
+static constexpr float GLYPH_ADVANCE = 1.5f; // In glyph widths
+static constexpr size_t INITIAL_VERTEX_CAPACITY = 16384;
+
+DebugDraw::DebugDraw()
+{}
+DebugDraw::~DebugDraw()
+{}
+
+bool DebugDraw::Init()
+{
+	m_shader = std::make_unique<ShaderProgram>();
+	m_shader->InitializeShaderProgram("../../../../../TerracottaEngine/res/DebugVert.glsl", "../../../../../TerracottaEngine/res/DebugFrag.glsl");
+
+	m_vao = std::make_unique<VertexArray>();
+	m_vbo = std::make_unique<BufferObject>(BufferUpdatePolicy::Orphan, BufferGrowPolicy::Double);
+
+	m_vbo->Reserve(INITIAL_VERTEX_CAPACITY * sizeof(DebugVertex));
+	m_vao->AttachVertexBuffer(0, *m_vbo, sizeof(DebugVertex));
+	m_vao->LinkAttribute(0, 0, 3, GL_FLOAT, offsetof(DebugVertex, Position));
+	m_vao->LinkAttribute(1, 0, 4, GL_FLOAT, offsetof(DebugVertex, Color));
+
+	m_vertices.reserve(INITIAL_VERTEX_CAPACITY);
+
+	SPDLOG_INFO("Debug drawing enabled.");
+	return true;
+}
+void DebugDraw::Shutdown()
+{
+	m_vao.reset();
+	m_vbo.reset();
+	m_shader.reset();
+	m_vertices.clear();
+}
+
+void DebugDraw::Clear()
+{
+	if (!m_vertices.empty()) {
+		m_vertices.clear();
+		m_needsUpload = true;
+	}
+}
+
+void DebugDraw::Flush(const glm::mat4& view, const glm::mat4& projection)
+{
+	if (m_vertices.empty())
+		return;
+
+	if (m_needsUpload) {
+		if (m_vbo->Upload(m_vertices.data(), m_vertices.size() * sizeof(DebugVertex))) {
+			m_vao->AttachVertexBuffer(0, *m_vbo, sizeof(DebugVertex));
+		}
+		m_needsUpload = false;
+	}
+
+	m_vao->Bind();
+
+	m_shader->Use();
+	m_shader->UploadUniformMat4("u_view", view);
+	m_shader->UploadUniformMat4("u_projection", projection);
+
+	glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(m_vertices.size()));
+	m_vao->Unbind();
+}
+
+void DebugDraw::Line(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color)
+{
+	m_vertices.push_back({{from, 0.0f}, color});
+	m_vertices.push_back({{to, 0.0f}, color});
+	m_needsUpload = true;
+}
+
+void DebugDraw::Rect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color)
+{
+	Line({min.x, min.y}, {max.x, min.y}, color);
+	Line({max.x, min.y}, {max.x, max.y}, color);
+	Line({max.x, max.y}, {min.x, max.y}, color);
+	Line({min.x, max.y}, {min.x, min.y}, color);
+}
+
+void DebugDraw::Circle(const glm::vec2& center, float radius, const glm::vec4& color, uint32_t segments)
+{
+	if (segments < 3)
+		segments = 3;
+
+	const float step = glm::two_pi<float>() / static_cast<float>(segments);
+	glm::vec2 prev = center + glm::vec2(radius, 0.0f);
+	for (uint32_t i = 1; i <= segments; i++) {
+		float theta = step * static_cast<float>(i);
+		glm::vec2 next = center + radius * glm::vec2(glm::cos(theta), glm::sin(theta));
+		Line(prev, next, color);
+		prev = next;
+	}
+}
+
+void DebugDraw::Text(const glm::vec2& position, std::string_view text, float size, const glm::vec4& color)
+{
+	const float scale = size * 0.5f; // Glyph cells are 2 units tall
+	glm::vec2 pen = position;
+	for (char c : text) {
+		if (c == '\n') {
+			pen.x = position.x;
+			pen.y -= size * 1.5f;
+			continue;
+		}
+
+		unsigned char ch = static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(c)));
+		uint16_t glyph = ch < GLYPHS.size() ? GLYPHS[ch] : 0;
+		for (uint32_t segment = 0; glyph != 0; segment++, glyph >>= 1) {
+			if (glyph & 1) {
+				Line(pen + SEGMENT_LINES[segment][0] * scale, pen + SEGMENT_LINES[segment][1] * scale, color);
+			}
+		}
+		pen.x += GLYPH_ADVANCE * scale;
+	}
+}
+} // namespace TerracottaEngine
+#endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "glm/glm.hpp"
+#include "ShaderProgram.hpp"
+#include "VertexInput.hpp"
+
+// TERRACOTTA_DEBUG_DRAW is only defined for Debug/RelWithDebInfo builds, see TerracottaEngine/CMakeLists.txt.
+// In other builds DebugDraw collapses to empty inline functions so every call compiles away.
+namespace TerracottaEngine
+{
+struct DebugVertex
+{
+	glm::vec3 Position; // X, Y, Z
+	glm::vec4 Color; // R, G, B, A
+};
+
+#ifdef TERRACOTTA_DEBUG_DRAW
+// Accumulates lines into one vertex stream that is drawn with a single glDrawArrays(GL_LINES).
+// Primitives live until the next Clear() (start of every update tick), so they don't flicker when
+// the render rate and update rate differ.
+class DebugDraw
+{
+public:
+	DebugDraw();
+	~DebugDraw();
+
+	bool Init();
+	void Shutdown();
+
+	void Clear();
+	void Flush(const glm::mat4& view, const glm::mat4& projection);
+
+	void Line(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color);
+	void Rect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color);
+	void Circle(const glm::vec2& center, float radius, const glm::vec4& color, uint32_t segments = 24);
+	// Stroke font (16-segment glyphs), size is the glyph height in world units
+	void Text(const glm::vec2& position, std::string_view text, float size, const glm::vec4& color);
+
+	std::unique_ptr<ShaderProgram>& GetShader() { return m_shader; }
+private:
+	std::unique_ptr<ShaderProgram> m_shader = nullptr;
+	std::unique_ptr<VertexArray> m_vao = nullptr;
+	std::unique_ptr<BufferObject> m_vbo = nullptr;
+	std::vector<DebugVertex> m_vertices;
+	bool m_needsUpload = false;
+};
+#else
+class DebugDraw
+{
+public:
+	bool Init() { return true; }
+	void Shutdown() {}
+
+	void Clear() {}
+	void Flush(const glm::mat4&, const glm::mat4&) {}
+
+	void Line(const glm::vec2&, const glm::vec2&, const glm::vec4&) {}
+	void Rect(const glm::vec2&, const glm::vec2&, const glm::vec4&) {}
+	void Circle(const glm::vec2&, float, const glm::vec4&, uint32_t = 24) {}
+	void Text(const glm::vec2&, std::string_view, float, const glm::vec4&) {}
+};
+#endif
+} // namespace TerracottaEngine
\ No newline at end of file
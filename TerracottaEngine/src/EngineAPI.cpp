@@ -28,13 +28,32 @@ static void Impl_InitWorldRendering(uint32_t worldWidthInChunks, uint32_t worldH
 	}
 }
 
-static void Impl_UpdateChunkTiles(uint32_t chunkX, uint32_t chunkY, const RenderTile* tiles, uint32_t tileCount)
+static void Impl_UpdateChunkTiles(int32_t chunkX, int32_t chunkY, const RenderTile* tiles, uint32_t tileCount)
 {
 	if (Application* app = GetApp()) {
 		app->GetRenderer()->UpdateChunkTiles(chunkX, chunkY, reinterpret_cast<const RenderTile*>(tiles), tileCount);
 	}
 }
 
+static void Impl_RemoveChunkTiles(int32_t chunkX, int32_t chunkY)
+{
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->RemoveChunkTiles(chunkX, chunkY);
+	}
+}
+
+static void Impl_GetCameraView(float* outX, float* outY, float* outWidth, float* outHeight)
+{
+	if (Application* app = GetApp()) {
+		const Camera& camera = app->GetRenderer()->GetCamera();
+		const glm::vec2 size = camera.GetViewSize();
+		*outX = camera.Position.x;
+		*outY = camera.Position.y;
+		*outWidth = size.x;
+		*outHeight = size.y;
+	}
+}
+
 static uint32_t Impl_LoadTextureAtlas(const char* path)
 {
 	if (Application* app = GetApp()) {
@@ -43,6 +62,13 @@ static uint32_t Impl_LoadTextureAtlas(const char* path)
 	return 0;
 }
 
+static void Impl_SetTextureBudget(uint32_t megabytes)
+{
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SetTextureBudget(static_cast<size_t>(megabytes) * 1024 * 1024);
+	}
+}
+
 static void Impl_GetNoise2D(uint32_t width, uint32_t height, float* outData)
 {
 	if (Application* app = GetApp()) {
@@ -50,6 +76,28 @@ static void Impl_GetNoise2D(uint32_t width, uint32_t height, float* outData)
 	}
 }
 
+static void Impl_GetNoiseRegion(int32_t originX, int32_t originY, uint32_t width, uint32_t height, float* outData)
+{
+	if (Application* app = GetApp()) {
+		app->GetRandomGenerator()->GetNoiseRegion(originX, originY, width, height, outData);
+	}
+}
+
+static void Impl_SetNoiseSeed(int32_t seed)
+{
+	if (Application* app = GetApp()) {
+		app->GetRandomGenerator()->SetNoiseSeed(seed);
+	}
+}
+
+static int Impl_LoadNoiseGraph(const char* path)
+{
+	if (Application* app = GetApp()) {
+		return app->GetRandomGenerator()->LoadNoiseGraph(path) ? 1 : 0;
+	}
+	return 0;
+}
+
 static int Impl_IsKeyDown(int keyCode)
 {
 	if (Application* app = GetApp()) {
@@ -120,6 +168,149 @@ static void Impl_GetTileUVs(uint32_t atlasId, uint32_t tileId, UVData* outData)
 	}
 }
 
+static void Impl_EmitParticles(const ParticleEmitDesc* desc)
+{
+	if (!desc)
+		return;
+
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->EmitParticles(*desc);
+	}
+}
+
+static void Impl_SubmitSprite(const SpriteDesc* sprite)
+{
+	if (!sprite)
+		return;
+
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SubmitSprite(*sprite);
+	}
+}
+
+static void Impl_SubmitLight(const LightDesc* light)
+{
+	if (!light)
+		return;
+
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SubmitLight(*light);
+	}
+}
+
+static void Impl_SetAmbientLight(float r, float g, float b)
+{
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SetAmbientLight(r, g, b);
+	}
+}
+
+static uint32_t Impl_LoadFont(const char* path)
+{
+	if (Application* app = GetApp()) {
+		return app->GetRenderer()->LoadFont(path);
+	}
+	return INVALID_FONT_ID;
+}
+
+static void Impl_SubmitText(const TextDesc* text)
+{
+	if (!text)
+		return;
+
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SubmitText(*text);
+	}
+}
+
+static float Impl_MeasureText(uint32_t fontId, const char* text, float size)
+{
+	if (Application* app = GetApp()) {
+		return app->GetRenderer()->MeasureText(fontId, text, size);
+	}
+	return 0.0f;
+}
+
+static void Impl_SubmitMinimap(const MinimapDesc* minimap)
+{
+	if (!minimap)
+		return;
+
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SubmitMinimap(*minimap);
+	}
+}
+
+static void Impl_SetWorldOverview(int enabled)
+{
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SetWorldOverview(enabled != 0);
+	}
+}
+
+static void Impl_UpdateVisibility(int x, int y, uint32_t width, uint32_t height, const uint8_t* states)
+{
+	if (!states)
+		return;
+
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->UpdateVisibility(x, y, width, height, states);
+	}
+}
+
+static void Impl_FillVisibility(uint8_t state)
+{
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->FillVisibility(state);
+	}
+}
+
+static void Impl_SetVisibilityEnabled(int enabled)
+{
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->SetVisibilityEnabled(enabled != 0);
+	}
+}
+
+static void Impl_DebugDrawLine(float x0, float y0, float x1, float y1, DebugColor color)
+{
+#ifdef TERRACOTTA_DEBUG_DRAW
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->GetDebugDraw().Line({x0, y0}, {x1, y1}, {color.R, color.G, color.B, color.A});
+	}
+#endif
+}
+
+static void Impl_DebugDrawRect(float minX, float minY, float maxX, float maxY, DebugColor color)
+{
+#ifdef TERRACOTTA_DEBUG_DRAW
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->GetDebugDraw().Rect({minX, minY}, {maxX, maxY}, {color.R, color.G, color.B, color.A});
+	}
+#endif
+}
+
+static void Impl_DebugDrawCircle(float x, float y, float radius, DebugColor color)
+{
+#ifdef TERRACOTTA_DEBUG_DRAW
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->GetDebugDraw().Circle({x, y}, radius, {color.R, color.G, color.B, color.A});
+	}
+#endif
+}
+
+static void Impl_DebugDrawText(float x, float y, const char* text, float size, DebugColor color)
+{
+#ifdef TERRACOTTA_DEBUG_DRAW
+	if (!text)
+		return;
+
+	if (Application* app = GetApp()) {
+		app->GetRenderer()->GetDebugDraw().Text({x, y}, text, size, {color.R, color.G, color.B, color.A});
+	}
+#endif
+}
+
 } // namespace TerracottaEngine
 
 extern "C" {
@@ -131,16 +322,38 @@ EngineAPI EngineAPI_Create(void* appPtr)
 	EngineAPI api;
 	api.InitWorldRendering = TerracottaEngine::Impl_InitWorldRendering;
 	api.UpdateChunkTiles = TerracottaEngine::Impl_UpdateChunkTiles;
+	api.RemoveChunkTiles = TerracottaEngine::Impl_RemoveChunkTiles;
+	api.GetCameraView = TerracottaEngine::Impl_GetCameraView;
 	api.LoadTextureAtlas = TerracottaEngine::Impl_LoadTextureAtlas;
 	api.GetAtlasInfo = TerracottaEngine::Impl_GetAtlasInfo;
 	api.GetTileUVs = TerracottaEngine::Impl_GetTileUVs;
+	api.SetTextureBudget = TerracottaEngine::Impl_SetTextureBudget;
 	api.GetNoise2D = TerracottaEngine::Impl_GetNoise2D;
+	api.GetNoiseRegion = TerracottaEngine::Impl_GetNoiseRegion;
+	api.SetNoiseSeed = TerracottaEngine::Impl_SetNoiseSeed;
+	api.LoadNoiseGraph = TerracottaEngine::Impl_LoadNoiseGraph;
 	api.IsKeyDown = TerracottaEngine::Impl_IsKeyDown;
 	api.IsKeyStartPress = TerracottaEngine::Impl_IsKeyStartPress;
 	api.IsKeyEndPress = TerracottaEngine::Impl_IsKeyEndPress;
 	api.GetMousePosition = TerracottaEngine::Impl_GetMousePosition;
 	api.IsMouseButtonDown = TerracottaEngine::Impl_IsMouseButtonDown;
 	api.GetTotalTime = TerracottaEngine::Impl_GetTotalTime;
+	api.EmitParticles = TerracottaEngine::Impl_EmitParticles;
+	api.SubmitSprite = TerracottaEngine::Impl_SubmitSprite;
+	api.SubmitLight = TerracottaEngine::Impl_SubmitLight;
+	api.SetAmbientLight = TerracottaEngine::Impl_SetAmbientLight;
+	api.LoadFont = TerracottaEngine::Impl_LoadFont;
+	api.SubmitText = TerracottaEngine::Impl_SubmitText;
+	api.MeasureText = TerracottaEngine::Impl_MeasureText;
+	api.SubmitMinimap = TerracottaEngine::Impl_SubmitMinimap;
+	api.SetWorldOverview = TerracottaEngine::Impl_SetWorldOverview;
+	api.UpdateVisibility = TerracottaEngine::Impl_UpdateVisibility;
+	api.FillVisibility = TerracottaEngine::Impl_FillVisibility;
+	api.SetVisibilityEnabled = TerracottaEngine::Impl_SetVisibilityEnabled;
+	api.DebugDrawLine = TerracottaEngine::Impl_DebugDrawLine;
+	api.DebugDrawRect = TerracottaEngine::Impl_DebugDrawRect;
+	api.DebugDrawCircle = TerracottaEngine::Impl_DebugDrawCircle;
+	api.DebugDrawText = TerracottaEngine::Impl_DebugDrawText;
 
 	return api;
 }
@@ -9,18 +9,48 @@ extern "C" {
 
 typedef struct EngineAPI
 {
+	// Chunks may be anywhere, the size only bounds the minimap and fog of war starting at chunk (0, 0)
 	void (*InitWorldRendering)(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks);
-	void (*UpdateChunkTiles)(uint32_t chunkX, uint32_t chunkY, const RenderTile* tiles, uint32_t tileCount);
+	void (*UpdateChunkTiles)(int32_t chunkX, int32_t chunkY, const RenderTile* tiles, uint32_t tileCount);
+	void (*RemoveChunkTiles)(int32_t chunkX, int32_t chunkY);
+	// Bottom-left corner and size of the camera's view in world units
+	void (*GetCameraView)(float* outX, float* outY, float* outWidth, float* outHeight);
 	uint32_t (*LoadTextureAtlas)(const char* path);
 	int (*GetAtlasInfo)(uint32_t atlasId, AtlasInfo* outInfo);
 	void (*GetTileUVs)(uint32_t atlasId, uint32_t tileId, UVData* outData);
+	// Least recently used atlases are evicted past this much VRAM and reloaded when drawn again
+	void (*SetTextureBudget)(uint32_t megabytes);
 	void (*GetNoise2D)(uint32_t width, uint32_t height, float* outData);
+	// Noise at world tile coordinates, so each chunk can be generated on its own and still match its neighbours.
+	// Safe to call from worker threads as long as the seed isn't changed meanwhile.
+	void (*GetNoiseRegion)(int32_t originX, int32_t originY, uint32_t width, uint32_t height, float* outData);
+	void (*SetNoiseSeed)(int32_t seed);
+	// Replaces plain noise in GetNoiseRegion with a JSON noise graph, 0 (keeping the old one) if it doesn't compile
+	int (*LoadNoiseGraph)(const char* path);
 	int (*IsKeyDown)(int keyCode);
 	int (*IsKeyStartPress)(int keyCode);
 	int (*IsKeyEndPress)(int keyCode);
 	void (*GetMousePosition)(float* outX, float* outY);
 	int (*IsMouseButtonDown)(int button);
 	float (*GetTotalTime)(void);
+	void (*EmitParticles)(const ParticleEmitDesc* desc);
+	void (*SubmitSprite)(const SpriteDesc* sprite);
+	void (*SubmitLight)(const LightDesc* light);
+	void (*SetAmbientLight)(float r, float g, float b);
+	uint32_t (*LoadFont)(const char* path); // INVALID_FONT_ID on failure
+	void (*SubmitText)(const TextDesc* text);
+	float (*MeasureText)(uint32_t fontId, const char* text, float size);
+	void (*SubmitMinimap)(const MinimapDesc* minimap);
+	void (*SetWorldOverview)(int enabled);
+	// Fog of war, states are width * height VISIBILITY_* bytes in tile coordinates
+	void (*UpdateVisibility)(int x, int y, uint32_t width, uint32_t height, const uint8_t* states);
+	void (*FillVisibility)(uint8_t state);
+	void (*SetVisibilityEnabled)(int enabled);
+	// Debug drawing (no-ops when the engine is built without TERRACOTTA_DEBUG_DRAW)
+	void (*DebugDrawLine)(float x0, float y0, float x1, float y1, DebugColor color);
+	void (*DebugDrawRect)(float minX, float minY, float maxX, float maxY, DebugColor color);
+	void (*DebugDrawCircle)(float x, float y, float radius, DebugColor color);
+	void (*DebugDrawText)(float x, float y, const char* text, float size, DebugColor color);
 } EngineAPI;
 
 EngineAPI EngineAPI_Create(void* appPtr);
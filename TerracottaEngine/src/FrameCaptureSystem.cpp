@@ -0,0 +1,316 @@
+#include <cstring>
+#include <string>
+#include "spdlog/spdlog.h"
+#include "FrameCaptureSystem.hpp"
+
+namespace TerracottaEngine
+{
+FrameCaptureSystem::FrameCaptureSystem(SubsystemManager& manager, Window& appWindow) :
+	Subsystem(manager), m_appWindow(&appWindow)
+{}
+FrameCaptureSystem::~FrameCaptureSystem()
+{}
+
+bool FrameCaptureSystem::Init()
+{
+	m_stopWorker = false;
+	m_worker = std::thread(&FrameCaptureSystem::workerLoop, this);
+
+	SPDLOG_INFO("FrameCaptureSystem initialization complete.");
+	return true;
+}
+void FrameCaptureSystem::OnUpdate(const float deltaTime)
+{
+
+}
+void FrameCaptureSystem::Shutdown()
+{
+	if (m_recording) {
+		StopRecording();
+	}
+
+	// Let the GPU finish whatever is still in flight so nothing gets lost
+	while (!m_inFlight.empty()) {
+		CaptureSlot& slot = m_slots[m_inFlight.front()];
+		glClientWaitSync(slot.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+		collectFinishedReadbacks();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_stopWorker = true;
+	}
+	m_jobCondition.notify_one();
+	if (m_worker.joinable()) {
+		m_worker.join();
+	}
+
+	releaseSlots();
+	SPDLOG_INFO("FrameCaptureSystem shutdown complete.");
+}
+
+void FrameCaptureSystem::RequestScreenshot(const Filepath& path)
+{
+	m_pendingScreenshot = path;
+}
+
+void FrameCaptureSystem::StartRecording(const Filepath& path)
+{
+	if (m_recording) {
+		SPDLOG_WARN("Already recording, ignoring StartRecording(\"{}\")", path.string());
+		return;
+	}
+
+	// The file is opened with the first frame, once its size is known
+	m_recordingPath = path;
+	m_recording = true;
+	m_droppedFrames = 0;
+	SPDLOG_INFO("Started recording raw BGRA video");
+}
+
+void FrameCaptureSystem::StopRecording()
+{
+	if (!m_recording)
+		return;
+
+	m_recording = false;
+	closeVideoFile();
+	SPDLOG_INFO("Stopped recording ({} frames dropped)", m_droppedFrames);
+}
+
+void FrameCaptureSystem::CaptureFrame()
+{
+	// Always drain, even when nothing new is requested
+	collectFinishedReadbacks();
+
+	bool wantsScreenshot = !m_pendingScreenshot.empty();
+	if (!wantsScreenshot && !m_recording)
+		return;
+
+	int width, height;
+	glfwGetFramebufferSize(m_appWindow->GetGLFWWindow(), &width, &height);
+	if (width <= 0 || height <= 0)
+		return; // Minimized
+
+	if (width != m_width || height != m_height) {
+		// Buffers can only be reallocated once the worker is done with all of them
+		if (!allSlotsFree() || !resizeSlots(width, height)) {
+			m_droppedFrames++;
+			return;
+		}
+	}
+
+	if (wantsScreenshot) {
+		const Filepath path = std::move(m_pendingScreenshot);
+		m_pendingScreenshot.clear();
+		submitReadback(CaptureJobType::Screenshot, path);
+	}
+	if (m_recording) {
+		// A raw stream has no header, every frame in a file has to be the same size
+		if (m_videoPath.empty() || m_width != m_videoWidth || m_height != m_videoHeight) {
+			closeVideoFile();
+			openVideoFile(m_width, m_height);
+		}
+		submitReadback(CaptureJobType::VideoFrame, {});
+	}
+}
+
+void FrameCaptureSystem::openVideoFile(int width, int height)
+{
+	Filepath path = m_recordingPath;
+	path.replace_filename(m_recordingPath.stem().string() + "_" + std::to_string(width) + "x" + std::to_string(height) + m_recordingPath.extension().string());
+
+	// Frames of the old size are all written by now, resizing waits for every slot to be free
+	pushJob({CaptureJobType::OpenVideo, 0, path});
+	m_videoPath = std::move(path);
+	m_videoWidth = width;
+	m_videoHeight = height;
+	SPDLOG_INFO("Recording {}x{} frames to \"{}\"", width, height, m_videoPath.string());
+}
+
+void FrameCaptureSystem::closeVideoFile()
+{
+	if (m_videoPath.empty())
+		return;
+
+	pushJob({CaptureJobType::CloseVideo, 0, {}});
+	SPDLOG_INFO("Finished \"{}\". Convert with: ffmpeg -f rawvideo -pixel_format bgra -video_size {}x{} -i \"{}\" -vf vflip out.mp4",
+		m_videoPath.string(), m_videoWidth, m_videoHeight, m_videoPath.string());
+	m_videoPath.clear();
+}
+
+bool FrameCaptureSystem::resizeSlots(int width, int height)
+{
+	releaseSlots();
+
+	GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+	GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	for (CaptureSlot& slot : m_slots) {
+		glCreateBuffers(1, &slot.Buffer);
+		glNamedBufferStorage(slot.Buffer, size, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+		slot.Mapped = static_cast<uint8_t*>(glMapNamedBufferRange(slot.Buffer, 0, size, flags));
+		if (!slot.Mapped) {
+			SPDLOG_ERROR("Failed to persistently map a {}x{} capture buffer!", width, height);
+			releaseSlots();
+			return false;
+		}
+		slot.Width = width;
+		slot.Height = height;
+	}
+
+	m_width = width;
+	m_height = height;
+	SPDLOG_INFO("Allocated {} capture buffers of {}x{}", SLOT_COUNT, width, height);
+	return true;
+}
+
+void FrameCaptureSystem::releaseSlots()
+{
+	for (CaptureSlot& slot : m_slots) {
+		if (slot.Fence) {
+			glDeleteSync(slot.Fence);
+			slot.Fence = nullptr;
+		}
+		if (slot.Buffer) {
+			glUnmapNamedBuffer(slot.Buffer);
+			glDeleteBuffers(1, &slot.Buffer);
+			slot.Buffer = 0;
+		}
+		slot.Mapped = nullptr;
+		slot.State = CaptureSlotState::Free;
+	}
+	m_width = m_height = 0;
+}
+
+bool FrameCaptureSystem::allSlotsFree() const
+{
+	for (const CaptureSlot& slot : m_slots) {
+		if (slot.State != CaptureSlotState::Free)
+			return false;
+	}
+	return true;
+}
+
+void FrameCaptureSystem::submitReadback(CaptureJobType type, const Filepath& path)
+{
+	CaptureSlot& slot = m_slots[m_nextSlot];
+	if (slot.State != CaptureSlotState::Free) {
+		// Never wait on the GPU or the encoder, a dropped frame is cheaper than a hitch
+		m_droppedFrames++;
+		if (type == CaptureJobType::Screenshot) {
+			m_pendingScreenshot = path; // Try again next frame
+		}
+		return;
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_sourceFramebuffer);
+	glReadBuffer(m_sourceFramebuffer == 0 ? GL_BACK : GL_COLOR_ATTACHMENT0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	// BGRA bottom-up is the native readback layout on most drivers and exactly what TGA stores
+	glReadPixels(0, 0, slot.Width, slot.Height, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+	slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.State = CaptureSlotState::InFlight;
+	m_inFlight.push_back(m_nextSlot);
+
+	// Remember what the readback was for until it lands
+	m_slotJobs[m_nextSlot] = {type, m_nextSlot, path};
+	m_nextSlot = (m_nextSlot + 1) % SLOT_COUNT;
+}
+
+void FrameCaptureSystem::collectFinishedReadbacks()
+{
+	// Readbacks complete in submission order, stop at the first one the GPU hasn't reached
+	while (!m_inFlight.empty()) {
+		uint32_t slotIndex = m_inFlight.front();
+		CaptureSlot& slot = m_slots[slotIndex];
+
+		GLenum result = glClientWaitSync(slot.Fence, 0, 0);
+		if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+			break;
+
+		glDeleteSync(slot.Fence);
+		slot.Fence = nullptr;
+		slot.State = CaptureSlotState::Encoding;
+		m_inFlight.pop_front();
+
+		pushJob(m_slotJobs[slotIndex]);
+	}
+}
+
+void FrameCaptureSystem::pushJob(CaptureJob job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobMutex);
+		m_jobs.push_back(std::move(job));
+	}
+	m_jobCondition.notify_one();
+}
+
+void FrameCaptureSystem::workerLoop()
+{
+	while (true) {
+		CaptureJob job;
+		{
+			std::unique_lock<std::mutex> lock(m_jobMutex);
+			m_jobCondition.wait(lock, [this] { return m_stopWorker || !m_jobs.empty(); });
+			if (m_jobs.empty())
+				break; // Only exits once every queued frame is written
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		switch (job.Type) {
+		case CaptureJobType::OpenVideo:
+			m_videoStream.open(job.Path, std::ios::binary | std::ios::trunc);
+			if (!m_videoStream) {
+				SPDLOG_ERROR("Failed to open video capture file \"{}\"", job.Path.string());
+			}
+			break;
+		case CaptureJobType::CloseVideo:
+			m_videoStream.close();
+			break;
+		case CaptureJobType::VideoFrame: {
+			CaptureSlot& slot = m_slots[job.SlotIndex];
+			if (m_videoStream) {
+				m_videoStream.write(reinterpret_cast<const char*>(slot.Mapped), static_cast<std::streamsize>(slot.Width) * slot.Height * 4);
+			}
+			slot.State = CaptureSlotState::Free;
+			break;
+		}
+		case CaptureJobType::Screenshot: {
+			CaptureSlot& slot = m_slots[job.SlotIndex];
+			writeTGA(job.Path, slot);
+			slot.State = CaptureSlotState::Free;
+			break;
+		}
+		}
+	}
+}
+
+void FrameCaptureSystem::writeTGA(const Filepath& path, const CaptureSlot& slot) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		SPDLOG_ERROR("Failed to create screenshot file \"{}\"", path.string());
+		return;
+	}
+
+	// Uncompressed true-color, 32 bpp, origin bottom-left with 8 alpha bits
+	uint8_t header[18] = {};
+	header[2] = 2;
+	header[12] = static_cast<uint8_t>(slot.Width & 0xFF);
+	header[13] = static_cast<uint8_t>((slot.Width >> 8) & 0xFF);
+	header[14] = static_cast<uint8_t>(slot.Height & 0xFF);
+	header[15] = static_cast<uint8_t>((slot.Height >> 8) & 0xFF);
+	header[16] = 32;
+	header[17] = 8;
+
+	file.write(reinterpret_cast<const char*>(header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(slot.Mapped), static_cast<std::streamsize>(slot.Width) * slot.Height * 4);
+	SPDLOG_INFO("Saved screenshot \"{}\" ({}x{})", path.string(), slot.Width, slot.Height);
+}
+} // namespace TerracottaEngine
\ No newline at end of file
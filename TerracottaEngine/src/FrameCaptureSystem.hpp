@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include "glad/glad.h"
+#include "Subsystem.hpp"
+#include "Window.hpp"
+
+namespace TerracottaEngine
+{
+using Filepath = std::filesystem::path;
+
+enum class CaptureSlotState : uint8_t
+{
+	Free,
+	InFlight, // glReadPixels issued, waiting on the fence
+	Encoding // Owned by the worker thread
+};
+
+enum class CaptureJobType : uint8_t
+{
+	Screenshot,
+	VideoFrame,
+	OpenVideo,
+	CloseVideo
+};
+
+// Reads back frames through a ring of persistently mapped PBOs so glReadPixels never stalls the GPU.
+// Encoding and disk writes happen on a worker thread straight out of the mapped memory.
+class FrameCaptureSystem : public Subsystem
+{
+public:
+	FrameCaptureSystem(SubsystemManager& manager, Window& appWindow);
+	~FrameCaptureSystem();
+
+	bool Init() override;
+	void OnUpdate(const float deltaTime) override;
+	void Shutdown() override;
+
+	// Call after the game has rendered, before debug layers and the buffer swap
+	void CaptureFrame();
+
+	// Screenshots are written as uncompressed .tga, video as raw BGRA streams. A recording starts a new file each time
+	// the framebuffer changes size, named after the path with the size added (capture_1280x720.bgra).
+	void RequestScreenshot(const Filepath& path);
+	void StartRecording(const Filepath& path);
+	void StopRecording();
+	bool IsRecording() const { return m_recording; }
+
+	// 0 reads the default framebuffer's back buffer
+	void SetSourceFramebuffer(GLuint framebuffer) { m_sourceFramebuffer = framebuffer; }
+	uint32_t GetDroppedFrameCount() const { return m_droppedFrames; }
+private:
+	static constexpr uint32_t SLOT_COUNT = 4;
+
+	struct CaptureSlot
+	{
+		GLuint Buffer = 0;
+		uint8_t* Mapped = nullptr;
+		GLsync Fence = nullptr;
+		std::atomic<CaptureSlotState> State = CaptureSlotState::Free;
+		int Width = 0, Height = 0;
+	};
+
+	struct CaptureJob
+	{
+		CaptureJobType Type;
+		uint32_t SlotIndex = 0;
+		Filepath Path;
+	};
+
+	Window* m_appWindow = nullptr;
+	std::array<CaptureSlot, SLOT_COUNT> m_slots;
+	uint32_t m_nextSlot = 0;
+	std::array<CaptureJob, SLOT_COUNT> m_slotJobs; // What each in-flight readback is for
+	std::deque<uint32_t> m_inFlight; // Submission order
+	int m_width = 0, m_height = 0;
+	GLuint m_sourceFramebuffer = 0;
+
+	Filepath m_pendingScreenshot;
+	bool m_recording = false;
+	uint32_t m_droppedFrames = 0;
+	Filepath m_recordingPath; // As passed to StartRecording
+	Filepath m_videoPath; // File frames are currently written to, empty until the first recorded frame
+	int m_videoWidth = 0, m_videoHeight = 0;
+
+	// Worker thread
+	std::thread m_worker;
+	std::mutex m_jobMutex;
+	std::condition_variable m_jobCondition;
+	std::deque<CaptureJob> m_jobs;
+	bool m_stopWorker = false;
+	std::ofstream m_videoStream; // Only touched by the worker
+
+	bool resizeSlots(int width, int height);
+	void releaseSlots();
+	bool allSlotsFree() const;
+	void submitReadback(CaptureJobType type, const Filepath& path);
+	void openVideoFile(int width, int height);
+	void closeVideoFile();
+	void collectFinishedReadbacks();
+	void pushJob(CaptureJob job);
+	void workerLoop();
+	void writeTGA(const Filepath& path, const CaptureSlot& slot) const;
+};
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <thread>
+#include "spdlog/spdlog.h"
+#include "FrameScheduler.hpp"
+
+namespace TerracottaEngine
+{
+FrameScheduler::FrameScheduler(SubsystemManager& manager, Window& appWindow) :
+	Subsystem(manager), m_appWindow(&appWindow)
+{}
+FrameScheduler::~FrameScheduler()
+{}
+
+bool FrameScheduler::Init()
+{
+	GLFWwindow* glfwWindow = m_appWindow->GetGLFWWindow();
+	m_focused = glfwGetWindowAttrib(glfwWindow, GLFW_FOCUSED) == GLFW_TRUE;
+	m_iconified = glfwGetWindowAttrib(glfwWindow, GLFW_ICONIFIED) == GLFW_TRUE;
+
+	registerCallbacks();
+	SPDLOG_INFO("FrameScheduler initialization complete.");
+	return true;
+}
+void FrameScheduler::OnUpdate(const float deltaTime)
+{
+
+}
+void FrameScheduler::Shutdown()
+{
+	SPDLOG_INFO("FrameScheduler shutdown complete.");
+}
+
+void FrameScheduler::SetRenderMode(RenderMode mode)
+{
+	m_renderMode = mode;
+	m_redrawRequested = true;
+	SPDLOG_INFO("Render mode set to {}", mode == RenderMode::OnDemand ? "on-demand" : "continuous");
+}
+
+void FrameScheduler::SetUnfocusedFPS(int fps)
+{
+	m_unfocusedFrameDelay = 1.0f / (float)std::max(fps, 1);
+}
+
+float FrameScheduler::GetFrameDelay(float targetFrameDelay) const
+{
+	if (m_iconified)
+		return 0.0f;
+
+	if (!m_focused)
+		return std::max(targetFrameDelay, m_unfocusedFrameDelay);
+
+	return targetFrameDelay;
+}
+
+bool FrameScheduler::ShouldRender()
+{
+	if (m_iconified)
+		return false;
+
+	bool render = m_renderMode == RenderMode::Continuous || m_redrawRequested;
+	m_redrawRequested = false;
+	return render;
+}
+
+bool FrameScheduler::HasPendingFrame() const
+{
+	if (m_iconified)
+		return false;
+
+	return m_renderMode == RenderMode::Continuous || m_redrawRequested;
+}
+
+void FrameScheduler::WaitUntil(double deadline, bool precise)
+{
+	// Nobody is looking, frame timing doesn't matter
+	if (!m_focused || m_iconified)
+		precise = false;
+
+	double now = glfwGetTime();
+	const double margin = precise ? m_spinMargin : 0.0;
+	const double sleepTime = deadline - now - margin;
+	if (sleepTime > 0.0) {
+		glfwWaitEventsTimeout(sleepTime);
+
+		double wokeAt = glfwGetTime();
+		double overshoot = wokeAt - (now + sleepTime);
+		if (overshoot < 0.0)
+			return; // Woken up early by an event, let the caller handle it
+
+		if (precise) {
+			m_spinMargin = std::clamp(std::max(overshoot * 1.25, m_spinMargin * 0.99), MIN_SPIN_MARGIN, MAX_SPIN_MARGIN);
+		}
+		now = wokeAt;
+	}
+
+	if (!precise)
+		return;
+
+	while (now < deadline) {
+		std::this_thread::yield();
+		now = glfwGetTime();
+	}
+}
+
+void FrameScheduler::registerCallbacks()
+{
+	EventSystem* es = m_manager.GetSubsystem<EventSystem>();
+	if (!es) {
+		SPDLOG_ERROR("The EventSystem is not initialized for the frame scheduler!");
+		return;
+	}
+
+	es->AddListener<WindowFocusEvent>([this](const WindowFocusEvent& e)
+	{
+		m_focused = e.Focused;
+		m_redrawRequested = true;
+	});
+	es->AddListener<WindowIconifyEvent>([this](const WindowIconifyEvent& e)
+	{
+		m_iconified = e.Iconified;
+		m_redrawRequested = true;
+	});
+
+	// Anything that can change what is on screen wakes up on-demand rendering
+	es->AddListener<WindowSizeEvent>([this](const WindowSizeEvent& e) { m_redrawRequested = true; });
+	es->AddListener<WindowMaximizeEvent>([this](const WindowMaximizeEvent& e) { m_redrawRequested = true; });
+	es->AddListener<WindowContentScaleEvent>([this](const WindowContentScaleEvent& e) { m_redrawRequested = true; });
+	es->AddListener<KeyPressEvent>([this](const KeyPressEvent& e) { m_redrawRequested = true; });
+	es->AddListener<KeyRepeatEvent>([this](const KeyRepeatEvent& e) { m_redrawRequested = true; });
+	es->AddListener<KeyReleaseEvent>([this](const KeyReleaseEvent& e) { m_redrawRequested = true; });
+	es->AddListener<MouseButtonPressEvent>([this](const MouseButtonPressEvent& e) { m_redrawRequested = true; });
+	es->AddListener<MouseButtonReleaseEvent>([this](const MouseButtonReleaseEvent& e) { m_redrawRequested = true; });
+}
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Subsystem.hpp"
+#include "EventSystem.hpp"
+#include "Window.hpp"
+
+namespace TerracottaEngine
+{
+enum class RenderMode : uint8_t
+{
+	Continuous, // Render at the target frame rate
+	OnDemand // Only render after RequestRedraw() or a window/input event (editor/tooling)
+};
+
+// Decides when Application renders and puts the main thread to sleep between frames.
+// Rendering stops while the window is iconified and drops to a low rate while it is unfocused.
+class FrameScheduler : public Subsystem
+{
+public:
+	FrameScheduler(SubsystemManager& manager, Window& appWindow);
+	~FrameScheduler();
+
+	bool Init() override;
+	void OnUpdate(const float deltaTime) override;
+	void Shutdown() override;
+
+	void SetRenderMode(RenderMode mode);
+	RenderMode GetRenderMode() const { return m_renderMode; }
+	void SetUnfocusedFPS(int fps);
+
+	// Something visible changed, only matters in RenderMode::OnDemand
+	void RequestRedraw() { m_redrawRequested = true; }
+
+	// Seconds between frames for the current window state, 0 while rendering is paused
+	float GetFrameDelay(float targetFrameDelay) const;
+	// Returns true if the frame that is due should actually be rendered. Consumes the redraw request.
+	bool ShouldRender();
+	bool HasPendingFrame() const;
+
+	// Blocks until the deadline (glfwGetTime() seconds) or until the OS delivers an event (input, focus, resize...).
+	// Precise waits sleep until just before the deadline and spin the rest, the OS timer alone overshoots by up to a tick.
+	void WaitUntil(double deadline, bool precise);
+
+	bool IsFocused() const { return m_focused; }
+	bool IsIconified() const { return m_iconified; }
+private:
+	Window* m_appWindow = nullptr;
+	RenderMode m_renderMode = RenderMode::Continuous;
+	bool m_redrawRequested = true;
+	bool m_focused = true;
+	bool m_iconified = false;
+	float m_unfocusedFrameDelay = 1.0f / 10.0f;
+
+	// How much earlier than the deadline to wake up, grows with the worst oversleep seen and slowly decays
+	static constexpr double MIN_SPIN_MARGIN = 0.0005, MAX_SPIN_MARGIN = 0.02;
+	double m_spinMargin = 0.002;
+
+	void registerCallbacks();
+};
+} // namespace TerracottaEngine
\ No newline at end of file
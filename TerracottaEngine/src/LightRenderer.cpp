@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstddef>
+#include "spdlog/spdlog.h"
+#include "LightRenderer.hpp"
+
+namespace TerracottaEngine
+{
+static constexpr size_t INITIAL_LIGHT_CAPACITY = 1024;
+
+LightRenderer::LightRenderer()
+{}
+LightRenderer::~LightRenderer()
+{}
+
+bool LightRenderer::Init()
+{
+	m_lightShader = std::make_unique<ShaderProgram>();
+	m_lightShader->InitializeShaderProgram("../../../../../TerracottaEngine/res/LightVert.glsl", "../../../../../TerracottaEngine/res/LightFrag.glsl");
+	m_blurShader = std::make_unique<ShaderProgram>();
+	m_blurShader->InitializeShaderProgram("../../../../../TerracottaEngine/res/FullscreenVert.glsl", "../../../../../TerracottaEngine/res/LightBlurFrag.glsl");
+	m_compositeShader = std::make_unique<ShaderProgram>();
+	m_compositeShader->InitializeShaderProgram("../../../../../TerracottaEngine/res/FullscreenVert.glsl", "../../../../../TerracottaEngine/res/LightCompositeFrag.glsl");
+
+	// One quad per light, corners come from gl_VertexID so only the instance data needs a buffer
+	m_lightVAO = std::make_unique<VertexArray>();
+	m_instanceVBO = std::make_unique<BufferObject>(BufferUpdatePolicy::Orphan, BufferGrowPolicy::Double);
+	m_instanceVBO->Reserve(INITIAL_LIGHT_CAPACITY * sizeof(PointLight));
+	m_lightVAO->AttachVertexBuffer(0, *m_instanceVBO, sizeof(PointLight));
+	m_lightVAO->SetBindingDivisor(0, 1);
+	m_lightVAO->LinkAttribute(0, 0, 2, GL_FLOAT, offsetof(PointLight, Position));
+	m_lightVAO->LinkAttribute(1, 0, 1, GL_FLOAT, offsetof(PointLight, Radius));
+	m_lightVAO->LinkAttribute(2, 0, 1, GL_FLOAT, offsetof(PointLight, Intensity));
+	m_lightVAO->LinkAttribute(3, 0, 3, GL_FLOAT, offsetof(PointLight, Color));
+
+	glCreateVertexArrays(1, &m_emptyVAO);
+	m_lights.reserve(INITIAL_LIGHT_CAPACITY);
+
+	SPDLOG_INFO("Light renderer initialized.");
+	return true;
+}
+void LightRenderer::Shutdown()
+{
+	if (m_emptyVAO) {
+		glDeleteVertexArrays(1, &m_emptyVAO);
+		m_emptyVAO = 0;
+	}
+	m_lightVAO.reset();
+	m_instanceVBO.reset();
+	m_lightShader.reset();
+	m_blurShader.reset();
+	m_compositeShader.reset();
+	m_lights.clear();
+}
+
+void LightRenderer::SetResolutionDivisor(uint32_t divisor)
+{
+	m_divisor = std::clamp(divisor, 1u, 8u);
+}
+
+void LightRenderer::Submit(const PointLight& light)
+{
+	if (light.Radius <= 0.0f || light.Intensity <= 0.0f)
+		return;
+
+	m_lights.push_back(light);
+	m_needsUpload = true;
+}
+
+void LightRenderer::Clear()
+{
+	if (!m_lights.empty()) {
+		m_lights.clear();
+		m_needsUpload = true;
+	}
+}
+
+void LightRenderer::AddPasses(RenderGraph& graph, const glm::mat4& view, const glm::mat4& projection)
+{
+	const glm::ivec2 backbufferSize = graph.GetSize(RenderGraph::BACKBUFFER);
+	if (!m_enabled || backbufferSize.x <= 0 || backbufferSize.y <= 0)
+		return;
+
+	// 16F so many overlapping lights don't band or clip before the composite. The vertical blur's output can
+	// reuse the accumulation buffer's memory, it's dead by then.
+	RenderTargetDesc desc;
+	desc.Width = std::max(backbufferSize.x / (int)m_divisor, 1);
+	desc.Height = std::max(backbufferSize.y / (int)m_divisor, 1);
+	desc.Format = GL_RGBA16F;
+	const RenderResource lightBuffer = graph.CreateTarget("LightBuffer", desc);
+	const RenderResource blurredX = graph.CreateTarget("LightBlurX", desc);
+	const RenderResource blurredXY = graph.CreateTarget("LightBlurXY", desc);
+	const glm::vec2 texelSize = {1.0f / desc.Width, 1.0f / desc.Height};
+
+	graph.AddPass("LightAccumulate", [this, view, projection](const RenderGraph&) { accumulate(view, projection); }).Write(lightBuffer);
+	graph.AddPass("LightBlurX", [this, lightBuffer, texelSize](const RenderGraph& g) { blur(g.GetTexture(lightBuffer), {texelSize.x, 0.0f}); })
+		.Read(lightBuffer)
+		.Write(blurredX);
+	graph.AddPass("LightBlurY", [this, blurredX, texelSize](const RenderGraph& g) { blur(g.GetTexture(blurredX), {0.0f, texelSize.y}); })
+		.Read(blurredX)
+		.Write(blurredXY);
+	graph.AddPass("LightComposite", [this, blurredXY](const RenderGraph& g) { composite(g.GetTexture(blurredXY)); })
+		.Read(blurredXY)
+		.Write(RenderGraph::BACKBUFFER);
+}
+
+void LightRenderer::accumulate(const glm::mat4& view, const glm::mat4& projection)
+{
+	if (m_needsUpload) {
+		if (m_instanceVBO->Upload(m_lights.data(), m_lights.size() * sizeof(PointLight))) {
+			m_lightVAO->AttachVertexBuffer(0, *m_instanceVBO, sizeof(PointLight));
+		}
+		m_needsUpload = false;
+	}
+
+	// Splat lights additively on top of the ambient term
+	const GLfloat ambient[4] = {m_ambient.r, m_ambient.g, m_ambient.b, 1.0f};
+	glClearBufferfv(GL_COLOR, 0, ambient);
+	if (m_lights.empty())
+		return;
+
+	glBlendFunc(GL_ONE, GL_ONE);
+	m_lightShader->Use();
+	m_lightShader->UploadUniformMat4("u_view", view);
+	m_lightShader->UploadUniformMat4("u_projection", projection);
+	m_lightVAO->Bind();
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_lights.size()));
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void LightRenderer::blur(GLuint source, const glm::vec2& texelStep)
+{
+	glDisable(GL_BLEND);
+	glBindVertexArray(m_emptyVAO);
+	m_blurShader->Use();
+	m_blurShader->UploadUniformInt("u_source", 0);
+	m_blurShader->UploadUniformVec2("u_direction", texelStep);
+	glBindTextureUnit(0, source);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_BLEND);
+}
+
+void LightRenderer::composite(GLuint lightTexture)
+{
+	// Multiply over the scene, the bilinear upsample comes for free
+	glBlendFunc(GL_DST_COLOR, GL_ZERO);
+	glBindVertexArray(m_emptyVAO);
+	m_compositeShader->Use();
+	m_compositeShader->UploadUniformInt("u_light", 0);
+	glBindTextureUnit(0, lightTexture);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	// Back to the renderer's defaults
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glBindVertexArray(0);
+}
+} // namespace TerracottaEngine
\ No newline at end of file
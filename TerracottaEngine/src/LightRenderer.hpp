@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+#include "RenderGraph.hpp"
+#include "ShaderProgram.hpp"
+#include "VertexInput.hpp"
+
+namespace TerracottaEngine
+{
+struct PointLight
+{
+	glm::vec2 Position;
+	float Radius;
+	float Intensity;
+	glm::vec3 Color;
+};
+
+// 2D lighting at a fraction of the framebuffer resolution. Point lights are splatted as additive instanced quads
+// into a low-res light buffer that starts at the ambient color, blurred, then multiplied over the scene.
+// Cost scales with the light buffer size and light count, never with the number of tiles.
+class LightRenderer
+{
+public:
+	LightRenderer();
+	~LightRenderer();
+
+	bool Init();
+	void Shutdown();
+
+	void SetEnabled(bool enabled) { m_enabled = enabled; }
+	bool IsEnabled() const { return m_enabled; }
+	// Light buffer is framebuffer size / divisor (2 = half, 4 = quarter)
+	void SetResolutionDivisor(uint32_t divisor);
+	void SetAmbient(const glm::vec3& ambient) { m_ambient = ambient; }
+
+	void Submit(const PointLight& light);
+	void Clear();
+
+	// Accumulate -> horizontal blur -> vertical blur -> multiply over the backbuffer, the buffers are graph transients
+	void AddPasses(RenderGraph& graph, const glm::mat4& view, const glm::mat4& projection);
+
+	std::unique_ptr<ShaderProgram>& GetLightShader() { return m_lightShader; }
+	std::unique_ptr<ShaderProgram>& GetBlurShader() { return m_blurShader; }
+	std::unique_ptr<ShaderProgram>& GetCompositeShader() { return m_compositeShader; }
+private:
+	std::unique_ptr<ShaderProgram> m_lightShader = nullptr;
+	std::unique_ptr<ShaderProgram> m_blurShader = nullptr;
+	std::unique_ptr<ShaderProgram> m_compositeShader = nullptr;
+	std::unique_ptr<VertexArray> m_lightVAO = nullptr;
+	std::unique_ptr<BufferObject> m_instanceVBO = nullptr;
+	GLuint m_emptyVAO = 0; // Fullscreen passes generate their triangle from gl_VertexID
+
+	uint32_t m_divisor = 2;
+
+	std::vector<PointLight> m_lights;
+	bool m_needsUpload = false;
+	bool m_enabled = false;
+	glm::vec3 m_ambient = {1.0f, 1.0f, 1.0f};
+
+	void accumulate(const glm::mat4& view, const glm::mat4& projection);
+	void blur(GLuint source, const glm::vec2& texelStep);
+	void composite(GLuint lightTexture);
+};
+} // namespace TerracottaEngine
\ No newline at end of file
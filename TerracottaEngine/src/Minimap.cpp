@@ -0,0 +1,58 @@
+#include <cmath>
+#include "spdlog/spdlog.h"
+#include "Minimap.hpp"
+
+namespace TerracottaEngine
+{
+Minimap::Minimap()
+{}
+Minimap::~Minimap()
+{}
+
+bool Minimap::Init(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks)
+{
+	m_widthInTiles = worldWidthInChunks * CHUNK_SIZE;
+	m_heightInTiles = worldHeightInChunks * CHUNK_SIZE;
+	if (m_widthInTiles == 0 || m_heightInTiles == 0) {
+		SPDLOG_ERROR("Cannot create a minimap for an empty world");
+		return false;
+	}
+
+	// Nearest filtering keeps one crisp pixel per tile when zoomed in
+	m_texture = std::make_unique<Texture>(m_widthInTiles, m_heightInTiles, GL_RGBA8, GL_RGBA, nullptr, GL_NEAREST);
+	const glm::u8vec4 clearColor(0);
+	glClearTexImage(m_texture->GetID(), 0, GL_RGBA, GL_UNSIGNED_BYTE, &clearColor);
+
+	SPDLOG_INFO("Minimap initialized at {}x{} ({} KiB)", m_widthInTiles, m_heightInTiles, m_widthInTiles * m_heightInTiles * 4 / 1024);
+	return true;
+}
+void Minimap::Shutdown()
+{
+	m_texture.reset();
+	m_widthInTiles = m_heightInTiles = 0;
+}
+
+void Minimap::UpdateChunk(int32_t chunkX, int32_t chunkY, const RenderTile* tiles, uint32_t tileCount, const TileColorFunc& tileColor)
+{
+	// Chunks outside the mapped region just aren't recorded
+	if (!m_texture || chunkX < 0 || chunkY < 0 || (chunkX + 1) * CHUNK_SIZE > (int32_t)m_widthInTiles || (chunkY + 1) * CHUNK_SIZE > (int32_t)m_heightInTiles)
+		return;
+
+	// Tiles are placed by their world position, missing ones stay transparent
+	m_staging.fill(glm::u8vec4(0));
+	const int originX = chunkX * CHUNK_SIZE;
+	const int originY = chunkY * CHUNK_SIZE;
+	for (uint32_t i = 0; i < tileCount; i++) {
+		int localX = static_cast<int>(std::floor(tiles[i].X)) - originX;
+		int localY = static_cast<int>(std::floor(tiles[i].Y)) - originY;
+		if (localX < 0 || localX >= CHUNK_SIZE || localY < 0 || localY >= CHUNK_SIZE)
+			continue;
+
+		m_staging[localY * CHUNK_SIZE + localX] = tileColor(tiles[i]);
+	}
+
+	m_texture->Bind();
+	glTexSubImage2D(GL_TEXTURE_2D, 0, originX, originY, CHUNK_SIZE, CHUNK_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, m_staging.data());
+	Texture::Unbind();
+}
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include "glm/glm.hpp"
+#include "SharedDataTypes.h"
+#include "Textures.hpp"
+
+namespace TerracottaEngine
+{
+using TileColorFunc = std::function<glm::u8vec4(const RenderTile& tile)>;
+
+// One RGBA8 texel per world tile. Only the 16x16 block of a re-submitted chunk is rewritten, so keeping it current
+// costs one small glTexSubImage2D per chunk update and drawing the whole world is a single textured quad.
+class Minimap
+{
+public:
+	Minimap();
+	~Minimap();
+
+	bool Init(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks);
+	void Shutdown();
+
+	void UpdateChunk(int32_t chunkX, int32_t chunkY, const RenderTile* tiles, uint32_t tileCount, const TileColorFunc& tileColor);
+
+	const Texture* GetTexture() const { return m_texture.get(); }
+	glm::uvec2 GetSizeInTiles() const { return {m_widthInTiles, m_heightInTiles}; }
+private:
+	std::unique_ptr<Texture> m_texture = nullptr;
+	uint32_t m_widthInTiles = 0, m_heightInTiles = 0;
+	std::array<glm::u8vec4, TILES_PER_CHUNK> m_staging;
+};
+} // namespace TerracottaEngine
\ No newline at end of file
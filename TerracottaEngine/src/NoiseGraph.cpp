@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include "spdlog/spdlog.h"
+#include "NoiseGraph.hpp"
+
+namespace TerracottaEngine
+{
+namespace
+{
+// Virtual registers 0 and 1 are the sample coordinates, filled in before every batch
+constexpr uint16_t COORD_X = 0;
+constexpr uint16_t COORD_Y = 1;
+constexpr int32_t MAX_OCTAVES = 16;
+
+// Node parameters, all optional unless noted:
+//   simplex/value:    frequency, seed (offset from the world seed)
+//   fbm/ridged:       noise ("simplex"/"value"), frequency, octaves, lacunarity, gain, seed
+//   warp:             input (required), plus the fbm parameters and amplitude (in tiles) for the offsets
+//   remap:            input (required), from [min, max], to [min, max], clamp
+//   blend:            a, b, weight (all required)
+//   select:           a, b, control (all required), threshold, falloff
+class GraphCompiler
+{
+public:
+	explicit GraphCompiler(const json& description) :
+		m_nodes(description.contains("nodes") ? description["nodes"] : json::object())
+	{}
+
+	bool Compile(const json& output, uint16_t& outRegister) { return compileInput(output, COORD_X, COORD_Y, "output", outRegister); }
+
+	std::vector<NoiseInstruction>& GetInstructions() { return m_instructions; }
+	uint32_t GetRegisterCount() const { return m_nextRegister; }
+private:
+	json m_nodes;
+	std::vector<NoiseInstruction> m_instructions;
+	uint32_t m_nextRegister = 2;
+	// Named nodes are compiled once per coordinate set, so sharing one is free unless it's warped differently
+	std::map<std::tuple<std::string, uint16_t, uint16_t>, uint16_t> m_compiledNodes;
+	std::set<std::string> m_inProgress;
+
+	bool allocate(uint16_t& outRegister)
+	{
+		if (m_nextRegister > UINT16_MAX) {
+			SPDLOG_ERROR("Noise graph is too large");
+			return false;
+		}
+		outRegister = static_cast<uint16_t>(m_nextRegister++);
+		return true;
+	}
+
+	bool compileInput(const json& input, uint16_t coordX, uint16_t coordY, const std::string& where, uint16_t& outRegister)
+	{
+		if (input.is_number()) {
+			NoiseInstruction constant;
+			constant.Op = NoiseOp::Constant;
+			constant.Value = input.get<float>();
+			if (!allocate(constant.Output))
+				return false;
+			m_instructions.push_back(constant);
+			outRegister = constant.Output;
+			return true;
+		}
+
+		if (input.is_string()) {
+			const std::string name = input.get<std::string>();
+			const auto key = std::make_tuple(name, coordX, coordY);
+			if (auto compiled = m_compiledNodes.find(key); compiled != m_compiledNodes.end()) {
+				outRegister = compiled->second;
+				return true;
+			}
+			if (!m_nodes.contains(name)) {
+				SPDLOG_ERROR("Noise graph {}: no node named \"{}\"", where, name);
+				return false;
+			}
+			if (!m_inProgress.insert(name).second) {
+				SPDLOG_ERROR("Noise graph node \"{}\" depends on itself", name);
+				return false;
+			}
+
+			const bool compiled = compileNode(m_nodes[name], coordX, coordY, name, outRegister);
+			m_inProgress.erase(name);
+			if (compiled) {
+				m_compiledNodes[key] = outRegister;
+			}
+			return compiled;
+		}
+
+		if (input.is_object())
+			return compileNode(input, coordX, coordY, where, outRegister);
+
+		SPDLOG_ERROR("Noise graph {}: expected a node, node name or number", where);
+		return false;
+	}
+
+	bool compileRequiredInput(const json& node, const char* key, uint16_t coordX, uint16_t coordY, const std::string& where, uint16_t& outRegister)
+	{
+		if (!node.contains(key)) {
+			SPDLOG_ERROR("Noise graph {}: \"{}\" node needs \"{}\"", where, node.value("type", ""), key);
+			return false;
+		}
+		return compileInput(node[key], coordX, coordY, where + "." + key, outRegister);
+	}
+
+	static bool parseKernel(const std::string& name, const std::string& where, NoiseKernelType& outKernel)
+	{
+		if (name == "simplex") {
+			outKernel = NoiseKernelType::OpenSimplex2;
+		} else if (name == "value") {
+			outKernel = NoiseKernelType::Value;
+		} else {
+			SPDLOG_ERROR("Noise graph {}: unknown noise \"{}\"", where, name);
+			return false;
+		}
+		return true;
+	}
+
+	static void readFractal(const json& node, NoiseInstruction& instruction)
+	{
+		instruction.Frequency = node.value("frequency", instruction.Frequency);
+		instruction.Octaves = std::clamp(node.value("octaves", 1), 1, MAX_OCTAVES);
+		instruction.Lacunarity = node.value("lacunarity", instruction.Lacunarity);
+		instruction.Gain = node.value("gain", instruction.Gain);
+	}
+
+	static void readRange(const json& node, const char* key, float& outMin, float& outMax)
+	{
+		if (node.contains(key)) {
+			const std::vector<float> range = node[key].get<std::vector<float>>();
+			if (range.size() == 2) {
+				outMin = range[0];
+				outMax = range[1];
+			}
+		}
+	}
+
+	bool compileNode(const json& node, uint16_t coordX, uint16_t coordY, const std::string& where, uint16_t& outRegister)
+	{
+		const std::string type = node.value("type", "");
+		NoiseInstruction instruction;
+		instruction.CoordX = coordX;
+		instruction.CoordY = coordY;
+		instruction.SeedOffset = node.value("seed", 0);
+
+		if (type == "simplex" || type == "value") {
+			instruction.Op = NoiseOp::Source;
+			parseKernel(type, where, instruction.Kernel);
+			instruction.Frequency = node.value("frequency", instruction.Frequency);
+		} else if (type == "fbm" || type == "ridged") {
+			instruction.Op = type == "fbm" ? NoiseOp::FBm : NoiseOp::Ridged;
+			if (!parseKernel(node.value("noise", "simplex"), where, instruction.Kernel) || !allocate(instruction.Scratch))
+				return false;
+			readFractal(node, instruction);
+		} else if (type == "warp") {
+			// Warped coordinates are registers of their own, the input is compiled against them
+			instruction.Op = NoiseOp::Warp;
+			if (!parseKernel(node.value("noise", "simplex"), where, instruction.Kernel))
+				return false;
+			readFractal(node, instruction);
+			instruction.Amplitude = node.value("amplitude", instruction.Amplitude);
+			if (!allocate(instruction.Output) || !allocate(instruction.OutputY) || !allocate(instruction.Scratch))
+				return false;
+			m_instructions.push_back(instruction);
+			return compileRequiredInput(node, "input", instruction.Output, instruction.OutputY, where, outRegister);
+		} else if (type == "remap") {
+			instruction.Op = NoiseOp::Remap;
+			if (!compileRequiredInput(node, "input", coordX, coordY, where, instruction.Inputs[0]))
+				return false;
+			readRange(node, "from", instruction.FromMin, instruction.FromMax);
+			readRange(node, "to", instruction.ToMin, instruction.ToMax);
+			instruction.Clamp = node.value("clamp", false);
+			if (instruction.FromMin == instruction.FromMax) {
+				SPDLOG_ERROR("Noise graph {}: remap \"from\" range is empty", where);
+				return false;
+			}
+		} else if (type == "blend" || type == "select") {
+			instruction.Op = type == "blend" ? NoiseOp::Blend : NoiseOp::Select;
+			const char* third = type == "blend" ? "weight" : "control";
+			if (!compileRequiredInput(node, "a", coordX, coordY, where, instruction.Inputs[0])
+				|| !compileRequiredInput(node, "b", coordX, coordY, where, instruction.Inputs[1])
+				|| !compileRequiredInput(node, third, coordX, coordY, where, instruction.Inputs[2]))
+				return false;
+			instruction.Threshold = node.value("threshold", instruction.Threshold);
+			instruction.Falloff = std::max(node.value("falloff", instruction.Falloff), 0.0f);
+		} else {
+			SPDLOG_ERROR("Noise graph {}: unknown node type \"{}\"", where, type);
+			return false;
+		}
+
+		if (!allocate(instruction.Output))
+			return false;
+		m_instructions.push_back(instruction);
+		outRegister = instruction.Output;
+		return true;
+	}
+};
+
+template <typename Func>
+void forEachRead(const NoiseInstruction& instruction, Func&& func)
+{
+	switch (instruction.Op) {
+	case NoiseOp::Source:
+	case NoiseOp::FBm:
+	case NoiseOp::Ridged:
+	case NoiseOp::Warp:
+		func(instruction.CoordX);
+		func(instruction.CoordY);
+		break;
+	case NoiseOp::Remap:
+		func(instruction.Inputs[0]);
+		break;
+	case NoiseOp::Blend:
+	case NoiseOp::Select:
+		func(instruction.Inputs[0]);
+		func(instruction.Inputs[1]);
+		func(instruction.Inputs[2]);
+		break;
+	default:
+		break;
+	}
+}
+
+template <typename Func>
+void forEachWrite(NoiseInstruction& instruction, Func&& func)
+{
+	func(instruction.Output);
+	if (instruction.Op == NoiseOp::Warp)
+		func(instruction.OutputY);
+	if (instruction.Op == NoiseOp::FBm || instruction.Op == NoiseOp::Ridged || instruction.Op == NoiseOp::Warp)
+		func(instruction.Scratch);
+}
+
+// Sums octaves into out, scaled like FastNoiseLite's fractals so the total stays around [-1, 1]
+void accumulateFractal(const NoiseInstruction& instruction, int seed, bool ridged, const float* xs, const float* ys, size_t count, float* out, float* scratch)
+{
+	float amplitude = instruction.Gain;
+	float fractalAmplitude = 1.0f;
+	for (int32_t octave = 1; octave < instruction.Octaves; octave++) {
+		fractalAmplitude += amplitude;
+		amplitude *= instruction.Gain;
+	}
+
+	std::fill(out, out + count, 0.0f);
+	amplitude = 1.0f / fractalAmplitude;
+	float frequency = instruction.Frequency;
+	for (int32_t octave = 0; octave < instruction.Octaves; octave++) {
+		GenerateNoisePoints(instruction.Kernel, seed + octave, frequency, xs, ys, count, scratch);
+		if (ridged) {
+			for (size_t i = 0; i < count; i++)
+				out[i] += (std::abs(scratch[i]) * -2.0f + 1.0f) * amplitude;
+		} else {
+			for (size_t i = 0; i < count; i++)
+				out[i] += scratch[i] * amplitude;
+		}
+		frequency *= instruction.Lacunarity;
+		amplitude *= instruction.Gain;
+	}
+}
+} // namespace
+
+std::unique_ptr<NoiseGraph> NoiseGraph::LoadFromFile(const Filepath& path)
+{
+	std::ifstream jsonFile(path);
+	if (!jsonFile) {
+		SPDLOG_ERROR("Failed to open noise graph \"{}\"", path.string());
+		return nullptr;
+	}
+
+	json description = json::parse(jsonFile, nullptr, false);
+	if (description.is_discarded()) {
+		SPDLOG_ERROR("Noise graph \"{}\" isn't valid JSON", path.string());
+		return nullptr;
+	}
+
+	std::unique_ptr<NoiseGraph> graph = Compile(description);
+	if (graph) {
+		SPDLOG_INFO("Compiled noise graph \"{}\": {} instructions, {} registers", path.filename().string(), graph->GetInstructionCount(), graph->GetRegisterCount());
+	}
+	return graph;
+}
+
+std::unique_ptr<NoiseGraph> NoiseGraph::Compile(const json& description)
+{
+	if (!description.is_object() || !description.contains("output")) {
+		SPDLOG_ERROR("Noise graph needs an \"output\" node");
+		return nullptr;
+	}
+
+	GraphCompiler compiler(description);
+	uint16_t output = 0;
+	try {
+		if (!compiler.Compile(description["output"], output))
+			return nullptr;
+	} catch (const json::exception& e) {
+		SPDLOG_ERROR("Noise graph has a badly typed parameter: {}", e.what());
+		return nullptr;
+	}
+
+	// Map virtual registers onto as few buffers as possible: each is freed after the last instruction that reads it.
+	// Outputs are assigned before inputs are freed so nothing is ever written while it's being read.
+	std::vector<NoiseInstruction>& instructions = compiler.GetInstructions();
+	const uint32_t virtualCount = compiler.GetRegisterCount();
+	std::vector<int64_t> lastRead(virtualCount, -1);
+	for (size_t i = 0; i < instructions.size(); i++) {
+		forEachRead(instructions[i], [&](uint16_t reg) { lastRead[reg] = static_cast<int64_t>(i); });
+	}
+	lastRead[output] = static_cast<int64_t>(instructions.size());
+
+	std::vector<uint16_t> physical(virtualCount, 0);
+	std::vector<bool> released(virtualCount, false);
+	std::vector<uint16_t> freeRegisters;
+	uint32_t physicalCount = 2;
+	physical[COORD_X] = COORD_X;
+	physical[COORD_Y] = COORD_Y;
+
+	auto release = [&](uint16_t reg)
+	{
+		if (!released[reg]) {
+			released[reg] = true;
+			freeRegisters.push_back(physical[reg]);
+		}
+	};
+
+	for (size_t i = 0; i < instructions.size(); i++) {
+		NoiseInstruction& instruction = instructions[i];
+		const int64_t index = static_cast<int64_t>(i);
+
+		forEachWrite(instruction, [&](uint16_t& reg)
+		{
+			if (!freeRegisters.empty()) {
+				physical[reg] = freeRegisters.back();
+				freeRegisters.pop_back();
+			} else {
+				physical[reg] = static_cast<uint16_t>(physicalCount++);
+			}
+		});
+		forEachRead(instruction, [&](uint16_t reg)
+		{
+			if (lastRead[reg] == index)
+				release(reg);
+		});
+		forEachWrite(instruction, [&](uint16_t& reg)
+		{
+			if (lastRead[reg] <= index)
+				release(reg); // Scratch, or a result nothing reads
+		});
+
+		// Rewrite in place now that every register of this instruction is mapped
+		forEachWrite(instruction, [&](uint16_t& reg) { reg = physical[reg]; });
+		instruction.CoordX = physical[instruction.CoordX];
+		instruction.CoordY = physical[instruction.CoordY];
+		for (uint16_t& input : instruction.Inputs)
+			input = physical[input];
+	}
+
+	std::unique_ptr<NoiseGraph> graph = std::make_unique<NoiseGraph>();
+	graph->m_instructions = std::move(instructions);
+	graph->m_registerCount = physicalCount;
+	graph->m_output = physical[output];
+	return graph;
+}
+
+void NoiseGraph::Evaluate(int seed, int originX, int originY, int width, int height, float* outData, NoiseArena& arena) const
+{
+	if (width <= 0 || height <= 0)
+		return;
+
+	// Whole rows per batch, as many as fit
+	const int rowsPerBatch = std::max(1, static_cast<int>(MAX_BATCH_SAMPLES) / width);
+	const size_t stride = static_cast<size_t>(rowsPerBatch) * width;
+	float* registers = arena.Acquire(stride * m_registerCount);
+	float* xs = registers + COORD_X * stride;
+	float* ys = registers + COORD_Y * stride;
+
+	for (int row = 0; row < height; row += rowsPerBatch) {
+		const int rows = std::min(rowsPerBatch, height - row);
+		size_t i = 0;
+		for (int y = 0; y < rows; y++) {
+			for (int x = 0; x < width; x++, i++) {
+				xs[i] = static_cast<float>(originX + x);
+				ys[i] = static_cast<float>(originY + row + y);
+			}
+		}
+
+		evaluateBatch(seed, registers, stride, i);
+		const float* result = registers + m_output * stride;
+		std::copy(result, result + i, outData + static_cast<size_t>(row) * width);
+	}
+}
+
+void NoiseGraph::evaluateBatch(int seed, float* registers, size_t stride, size_t count) const
+{
+	auto reg = [registers, stride](uint16_t index) { return registers + index * stride; };
+
+	for (const NoiseInstruction& instruction : m_instructions) {
+		float* out = reg(instruction.Output);
+		const float* xs = reg(instruction.CoordX);
+		const float* ys = reg(instruction.CoordY);
+		const int nodeSeed = seed + instruction.SeedOffset;
+
+		switch (instruction.Op) {
+		case NoiseOp::Constant:
+			std::fill(out, out + count, instruction.Value);
+			break;
+		case NoiseOp::Source:
+			GenerateNoisePoints(instruction.Kernel, nodeSeed, instruction.Frequency, xs, ys, count, out);
+			break;
+		case NoiseOp::FBm:
+		case NoiseOp::Ridged:
+			accumulateFractal(instruction, nodeSeed, instruction.Op == NoiseOp::Ridged, xs, ys, count, out, reg(instruction.Scratch));
+			break;
+		case NoiseOp::Warp: {
+			// Y offsets use the seeds after X's octaves so the two don't correlate
+			float* outY = reg(instruction.OutputY);
+			accumulateFractal(instruction, nodeSeed, false, xs, ys, count, out, reg(instruction.Scratch));
+			accumulateFractal(instruction, nodeSeed + instruction.Octaves, false, xs, ys, count, outY, reg(instruction.Scratch));
+			for (size_t i = 0; i < count; i++) {
+				out[i] = xs[i] + out[i] * instruction.Amplitude;
+				outY[i] = ys[i] + outY[i] * instruction.Amplitude;
+			}
+			break;
+		}
+		case NoiseOp::Remap: {
+			const float* in = reg(instruction.Inputs[0]);
+			const float scale = (instruction.ToMax - instruction.ToMin) / (instruction.FromMax - instruction.FromMin);
+			const float low = std::min(instruction.ToMin, instruction.ToMax);
+			const float high = std::max(instruction.ToMin, instruction.ToMax);
+			for (size_t i = 0; i < count; i++)
+				out[i] = instruction.ToMin + (in[i] - instruction.FromMin) * scale;
+			if (instruction.Clamp) {
+				for (size_t i = 0; i < count; i++)
+					out[i] = std::clamp(out[i], low, high);
+			}
+			break;
+		}
+		case NoiseOp::Blend: {
+			const float* a = reg(instruction.Inputs[0]);
+			const float* b = reg(instruction.Inputs[1]);
+			const float* weight = reg(instruction.Inputs[2]);
+			for (size_t i = 0; i < count; i++)
+				out[i] = a[i] + (b[i] - a[i]) * weight[i];
+			break;
+		}
+		case NoiseOp::Select: {
+			const float* a = reg(instruction.Inputs[0]);
+			const float* b = reg(instruction.Inputs[1]);
+			const float* control = reg(instruction.Inputs[2]);
+			if (instruction.Falloff <= 0.0f) {
+				for (size_t i = 0; i < count; i++)
+					out[i] = control[i] < instruction.Threshold ? a[i] : b[i];
+				break;
+			}
+			// Hermite blend across threshold +- falloff
+			const float lower = instruction.Threshold - instruction.Falloff;
+			const float inverseWidth = 1.0f / (2.0f * instruction.Falloff);
+			for (size_t i = 0; i < count; i++) {
+				const float t = std::clamp((control[i] - lower) * inverseWidth, 0.0f, 1.0f);
+				out[i] = a[i] + (b[i] - a[i]) * (t * t * (3.0f - 2.0f * t));
+			}
+			break;
+		}
+		}
+	}
+}
+} // namespace TerracottaEngine
\ No newline at end of file
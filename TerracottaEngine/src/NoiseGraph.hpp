@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include "nlohmann/json.hpp"
+#include "NoiseKernels.hpp"
+
+namespace TerracottaEngine
+{
+using json = nlohmann::json;
+using Filepath = std::filesystem::path;
+
+enum class NoiseOp : uint8_t
+{
+	Constant,
+	Source, // One noise sample
+	FBm, // Octaves summed
+	Ridged, // Octaves of 1 - 2|n| summed
+	Warp, // Offsets the coordinates by FBm noise, writes an X and a Y register
+	Remap, // Linear range change, optionally clamped
+	Blend, // Lerp between two inputs by a third
+	Select // Picks between two inputs by a control value, smoothed over the falloff
+};
+
+// One step of a compiled graph. Registers are whole sample buffers.
+struct NoiseInstruction
+{
+	NoiseOp Op = NoiseOp::Constant;
+	NoiseKernelType Kernel = NoiseKernelType::OpenSimplex2;
+	uint16_t Output = 0;
+	uint16_t OutputY = 0; // Warp only
+	uint16_t Scratch = 0; // Octave samples for FBm, Ridged and Warp
+	uint16_t CoordX = 0, CoordY = 0;
+	uint16_t Inputs[3] = {}; // Remap: value. Blend: a, b, weight. Select: a, b, control.
+
+	int32_t SeedOffset = 0;
+	int32_t Octaves = 1;
+	float Frequency = 0.01f;
+	float Lacunarity = 2.0f;
+	float Gain = 0.5f;
+	float Amplitude = 1.0f; // Warp distance in tiles
+	float Value = 0.0f; // Constant
+	float FromMin = -1.0f, FromMax = 1.0f, ToMin = 0.0f, ToMax = 1.0f;
+	bool Clamp = false;
+	float Threshold = 0.0f, Falloff = 0.0f;
+};
+
+// Per-thread scratch memory for evaluating graphs, grows to the largest graph and batch it has seen and then
+// just gets reused
+class NoiseArena
+{
+public:
+	float* Acquire(size_t floatCount)
+	{
+		if (m_buffer.size() < floatCount)
+			m_buffer.resize(floatCount);
+		return m_buffer.data();
+	}
+private:
+	std::vector<float> m_buffer;
+};
+
+// A tree of noise nodes described in JSON, compiled into a flat instruction list that runs over whole batches of
+// samples at a time: sources go through the SIMD kernels, everything else is a plain loop over buffers.
+//
+// {
+//   "nodes": { "hills": { "type": "fbm", "noise": "simplex", "frequency": 0.02, "octaves": 4 }, ... },
+//   "output": { "type": "warp", "input": "hills", "frequency": 0.05, "amplitude": 4 }
+// }
+//
+// Inputs are either a nested node, the name of an entry in "nodes", or a number. Node types are "simplex" and
+// "value" (sources), "fbm", "ridged", "warp", "remap", "blend" and "select"; see NoiseGraph.cpp for parameters.
+class NoiseGraph
+{
+public:
+	static constexpr uint32_t MAX_BATCH_SAMPLES = 4096; // Bounds arena size, a chunk is one batch
+
+	// nullptr (and an error logged) if the file or graph is invalid
+	static std::unique_ptr<NoiseGraph> LoadFromFile(const Filepath& path);
+	static std::unique_ptr<NoiseGraph> Compile(const json& description);
+
+	// Same layout as RandomGenerator::GetNoiseRegion. Const and allocation free once the arena has grown,
+	// so any number of threads can evaluate one graph with their own arenas.
+	void Evaluate(int seed, int originX, int originY, int width, int height, float* outData, NoiseArena& arena) const;
+
+	size_t GetInstructionCount() const { return m_instructions.size(); }
+	uint32_t GetRegisterCount() const { return m_registerCount; }
+private:
+	std::vector<NoiseInstruction> m_instructions;
+	uint32_t m_registerCount = 0;
+	uint16_t m_output = 0;
+
+	void evaluateBatch(int seed, float* registers, size_t stride, size_t count) const;
+};
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "NoiseKernelsImpl.hpp"
+
+#ifdef TERRACOTTA_NOISE_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+namespace TerracottaEngine
+{
+#ifdef TERRACOTTA_NOISE_X86
+// Defined in NoiseKernelsSSE41.cpp/NoiseKernelsAVX2.cpp, each built with its own instruction set enabled
+void GenerateNoiseGridSSE41(const NoiseGridDesc& desc, float* outData);
+void GenerateNoiseGridAVX2(const NoiseGridDesc& desc, float* outData);
+void GenerateNoisePointsSSE41(NoiseKernelType type, int seed, float frequency, const float* xs, const float* ys, size_t count, float* outData);
+void GenerateNoisePointsAVX2(NoiseKernelType type, int seed, float frequency, const float* xs, const float* ys, size_t count, float* outData);
+#endif
+
+static SimdLevel detectSimdLevel()
+{
+#if defined(TERRACOTTA_NOISE_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	if (maxLeaf < 1)
+		return SimdLevel::Scalar;
+
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	// The OS also has to save the YMM registers on context switches
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+		__cpuidex(info, 7, 0);
+		if (info[1] & (1 << 5))
+			return SimdLevel::AVX2;
+	}
+	return sse41 ? SimdLevel::SSE41 : SimdLevel::Scalar;
+#elif defined(TERRACOTTA_NOISE_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return SimdLevel::AVX2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return SimdLevel::SSE41;
+	return SimdLevel::Scalar;
+#else
+	return SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel GetNoiseSimdLevel()
+{
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+	switch (level) {
+	case SimdLevel::AVX2: return "AVX2";
+	case SimdLevel::SSE41: return "SSE4.1";
+	default: return "Scalar";
+	}
+}
+
+void GenerateNoiseGrid(const NoiseGridDesc& desc, float* outData)
+{
+	GenerateNoiseGrid(desc, outData, GetNoiseSimdLevel());
+}
+
+void GenerateNoiseGrid(const NoiseGridDesc& desc, float* outData, SimdLevel level)
+{
+	if (desc.Width <= 0 || desc.Height <= 0)
+		return;
+
+	// Never run above what the CPU supports, even if asked to
+	if (level > GetNoiseSimdLevel())
+		level = GetNoiseSimdLevel();
+
+	switch (level) {
+#ifdef TERRACOTTA_NOISE_X86
+	case SimdLevel::AVX2:
+		GenerateNoiseGridAVX2(desc, outData);
+		break;
+	case SimdLevel::SSE41:
+		GenerateNoiseGridSSE41(desc, outData);
+		break;
+#endif
+	default:
+		generateNoiseGrid<ScalarLanes>(desc, outData);
+		break;
+	}
+}
+
+void GenerateNoisePoints(NoiseKernelType type, int seed, float frequency, const float* xs, const float* ys, size_t count, float* outData)
+{
+	switch (GetNoiseSimdLevel()) {
+#ifdef TERRACOTTA_NOISE_X86
+	case SimdLevel::AVX2:
+		GenerateNoisePointsAVX2(type, seed, frequency, xs, ys, count, outData);
+		break;
+	case SimdLevel::SSE41:
+		GenerateNoisePointsSSE41(type, seed, frequency, xs, ys, count, outData);
+		break;
+#endif
+	default:
+		generateNoisePoints<ScalarLanes>(type, seed, frequency, xs, ys, count, outData);
+		break;
+	}
+}
+} // namespace TerracottaEngine
\ No newline at end of file
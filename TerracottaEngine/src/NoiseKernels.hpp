@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace TerracottaEngine
+{
+enum class SimdLevel : uint8_t
+{
+	Scalar,
+	SSE41, // 4 lanes
+	AVX2 // 8 lanes
+};
+
+enum class NoiseKernelType : uint8_t
+{
+	OpenSimplex2,
+	Value
+};
+
+// Integer grid of samples at (OriginX + x, OriginY + y), scaled by Frequency
+struct NoiseGridDesc
+{
+	NoiseKernelType Type = NoiseKernelType::OpenSimplex2;
+	int Seed = 0;
+	float Frequency = 0.01f;
+	int OriginX = 0, OriginY = 0;
+	int Width = 0, Height = 0;
+};
+
+// Best instruction set the CPU and OS support, detected once
+SimdLevel GetNoiseSimdLevel();
+const char* GetSimdLevelName(SimdLevel level);
+
+// Fills Width * Height floats row-major, several samples per instruction. Every lane count gives exactly the
+// same values as FastNoiseLite::GetNoise with the same settings (and no fractal), so results never depend on
+// which machine generated them.
+void GenerateNoiseGrid(const NoiseGridDesc& desc, float* outData);
+void GenerateNoiseGrid(const NoiseGridDesc& desc, float* outData, SimdLevel level);
+// Same noise at arbitrary positions (before frequency scaling), for warped coordinates. A position on the integer
+// grid gives exactly the value GenerateNoiseGrid does there.
+void GenerateNoisePoints(NoiseKernelType type, int seed, float frequency, const float* xs, const float* ys, size_t count, float* outData);
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,57 @@
+// Compiled with AVX2 enabled (see CMakeLists.txt), only called once the CPU has been checked for it
+#include "NoiseKernelsImpl.hpp"
+
+#ifdef TERRACOTTA_NOISE_X86
+#include <immintrin.h>
+
+namespace TerracottaEngine
+{
+namespace
+{
+struct AVX2Lanes
+{
+	static constexpr int WIDTH = 8;
+	using Float = __m256;
+	using Int = __m256i;
+	using Mask = __m256;
+
+	static Float Splat(float v) { return _mm256_set1_ps(v); }
+	static Int Splat(int32_t v) { return _mm256_set1_epi32(v); }
+	static Int LaneIndex() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+	static Float Load(const float* in) { return _mm256_loadu_ps(in); }
+	static void Store(float* out, Float v) { _mm256_storeu_ps(out, v); }
+
+	// Separate multiply and add everywhere, fusing them would change the results
+	static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+	static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+	static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+	static Int Add(Int a, Int b) { return _mm256_add_epi32(a, b); }
+	static Int Mul(Int a, Int b) { return _mm256_mullo_epi32(a, b); }
+	static Int Xor(Int a, Int b) { return _mm256_xor_si256(a, b); }
+	static Int And(Int a, Int b) { return _mm256_and_si256(a, b); }
+	template <int N> static Int ShiftRight(Int a) { return _mm256_srai_epi32(a, N); }
+	template <int N> static Int ShiftLeft(Int a) { return _mm256_slli_epi32(a, N); }
+
+	static Mask Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Mask LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static Float Select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+	static Int Select(Mask m, Int a, Int b) { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m)); }
+
+	static Float ToFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+	// Truncate, then take one off negative values (the all-ones compare mask is -1)
+	static Int FastFloor(Float f) { return _mm256_add_epi32(_mm256_cvttps_epi32(f), _mm256_castps_si256(_mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ))); }
+	static Float Gather(const float* table, Int index) { return _mm256_i32gather_ps(table, index, 4); }
+};
+} // namespace
+
+void GenerateNoiseGridAVX2(const NoiseGridDesc& desc, float* outData)
+{
+	generateNoiseGrid<AVX2Lanes>(desc, outData);
+}
+
+void GenerateNoisePointsAVX2(NoiseKernelType type, int seed, float frequency, const float* xs, const float* ys, size_t count, float* outData)
+{
+	generateNoisePoints<AVX2Lanes>(type, seed, frequency, xs, ys, count, outData);
+}
+} // namespace TerracottaEngine
+#endif
\ No newline at end of file
@@ -0,0 +1,256 @@
+#pragma once
+// Lane-generic noise kernels, included by one translation unit per instruction set.
+// Everything here has internal linkage so a copy compiled with AVX2 enabled can never be linked into a caller
+// running on a CPU without it.
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "NoiseKernels.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TERRACOTTA_NOISE_X86
+#endif
+
+namespace TerracottaEngine
+{
+namespace
+{
+// Same hashing constants as FastNoiseLite, results have to match it bit for bit
+constexpr int32_t PRIME_X = 501125321;
+constexpr int32_t PRIME_Y = 1136930381;
+constexpr int32_t HASH_MULTIPLIER = 0x27d4eb2d;
+
+// Copy of FastNoiseLite's 2D gradient table, which is private to it
+alignas(32) constexpr std::array<float, 256> GRADIENTS_2D = {
+	0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+	0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+	0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+	-0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+	-0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+	-0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+	0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+	0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+	0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+	-0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+	-0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+	-0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+	0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+	0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+	0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+	-0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+	-0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+	-0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+	0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+	0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+	0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+	-0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+	-0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+	-0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+	0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+	0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+	0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+	-0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+	-0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+	-0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+	0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+	-0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f};
+
+// One lane, used for row tails and as the fallback everywhere
+struct ScalarLanes
+{
+	static constexpr int WIDTH = 1;
+	using Float = float;
+	using Int = int32_t;
+	using Mask = bool;
+
+	static Float Splat(float v) { return v; }
+	static Int Splat(int32_t v) { return v; }
+	static Int LaneIndex() { return 0; }
+	static Float Load(const float* in) { return *in; }
+	static void Store(float* out, Float v) { *out = v; }
+
+	static Float Add(Float a, Float b) { return a + b; }
+	static Float Sub(Float a, Float b) { return a - b; }
+	static Float Mul(Float a, Float b) { return a * b; }
+	// Integer math wraps like FastNoiseLite's does in practice
+	static Int Add(Int a, Int b) { return static_cast<Int>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b)); }
+	static Int Mul(Int a, Int b) { return static_cast<Int>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b)); }
+	static Int Xor(Int a, Int b) { return a ^ b; }
+	static Int And(Int a, Int b) { return a & b; }
+	template <int N> static Int ShiftRight(Int a) { return a >> N; }
+	template <int N> static Int ShiftLeft(Int a) { return static_cast<Int>(static_cast<uint32_t>(a) << N); }
+
+	static Mask Greater(Float a, Float b) { return a > b; }
+	static Mask LessEqual(Float a, Float b) { return a <= b; }
+	static Float Select(Mask m, Float a, Float b) { return m ? a : b; }
+	static Int Select(Mask m, Int a, Int b) { return m ? a : b; }
+
+	static Float ToFloat(Int a) { return static_cast<float>(a); }
+	static Int FastFloor(Float f) { return f >= 0 ? static_cast<int>(f) : static_cast<int>(f) - 1; }
+	static Float Gather(const float* table, Int index) { return table[index]; }
+};
+
+template <typename L>
+typename L::Float gradCoord(typename L::Int seed, typename L::Int xPrimed, typename L::Int yPrimed, typename L::Float xd, typename L::Float yd)
+{
+	using Int = typename L::Int;
+	Int hash = L::Mul(L::Xor(L::Xor(seed, xPrimed), yPrimed), L::Splat(HASH_MULTIPLIER));
+	hash = L::Xor(hash, L::template ShiftRight<15>(hash));
+	hash = L::And(hash, L::Splat(int32_t(127 << 1)));
+
+	// Index is always even, so hash | 1 is the next float
+	return L::Add(L::Mul(xd, L::Gather(GRADIENTS_2D.data(), hash)), L::Mul(yd, L::Gather(GRADIENTS_2D.data() + 1, hash)));
+}
+
+template <typename L>
+typename L::Float valCoord(typename L::Int seed, typename L::Int xPrimed, typename L::Int yPrimed)
+{
+	using Int = typename L::Int;
+	Int hash = L::Mul(L::Xor(L::Xor(seed, xPrimed), yPrimed), L::Splat(HASH_MULTIPLIER));
+	hash = L::Mul(hash, hash);
+	hash = L::Xor(hash, L::template ShiftLeft<19>(hash));
+	return L::Mul(L::ToFloat(hash), L::Splat(1 / 2147483648.0f));
+}
+
+// (a * a) * (a * a) * gradient, zero outside the corner's radius
+template <typename L>
+typename L::Float simplexCorner(typename L::Float a, typename L::Float gradient)
+{
+	using Float = typename L::Float;
+	const Float zero = L::Splat(0.0f);
+	const Float a2 = L::Mul(a, a);
+	return L::Select(L::LessEqual(a, zero), zero, L::Mul(L::Mul(a2, a2), gradient));
+}
+
+// OpenSimplex2 on already skewed coordinates, both triangle halves evaluated and blended per lane
+template <typename L>
+typename L::Float singleSimplex(typename L::Int seed, typename L::Float x, typename L::Float y)
+{
+	using Float = typename L::Float;
+	using Int = typename L::Int;
+	const float SQRT3 = 1.7320508075688772935274463415059f;
+	const float G2 = (3 - SQRT3) / 6;
+
+	Int i = L::FastFloor(x);
+	Int j = L::FastFloor(y);
+	const Float xi = L::Sub(x, L::ToFloat(i));
+	const Float yi = L::Sub(y, L::ToFloat(j));
+
+	const Float t = L::Mul(L::Add(xi, yi), L::Splat(G2));
+	const Float x0 = L::Sub(xi, t);
+	const Float y0 = L::Sub(yi, t);
+
+	i = L::Mul(i, L::Splat(PRIME_X));
+	j = L::Mul(j, L::Splat(PRIME_Y));
+	const Int i2 = L::Add(i, L::Splat(PRIME_X));
+	const Int j2 = L::Add(j, L::Splat(PRIME_Y));
+
+	const Float half = L::Splat(0.5f);
+	const Float a = L::Sub(L::Sub(half, L::Mul(x0, x0)), L::Mul(y0, y0));
+	const Float n0 = simplexCorner<L>(a, gradCoord<L>(seed, i, j, x0, y0));
+
+	const Float c = L::Add(L::Mul(L::Splat((float)(2 * (1 - 2 * G2) * (1 / G2 - 2))), t), L::Add(L::Splat((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2))), a));
+	const Float x2 = L::Add(x0, L::Splat(2 * (float)G2 - 1));
+	const Float y2 = L::Add(y0, L::Splat(2 * (float)G2 - 1));
+	const Float n2 = simplexCorner<L>(c, gradCoord<L>(seed, i2, j2, x2, y2));
+
+	const typename L::Mask upper = L::Greater(y0, x0);
+	const Float x1 = L::Select(upper, L::Add(x0, L::Splat((float)G2)), L::Add(x0, L::Splat((float)G2 - 1)));
+	const Float y1 = L::Select(upper, L::Add(y0, L::Splat((float)G2 - 1)), L::Add(y0, L::Splat((float)G2)));
+	const Int i1 = L::Select(upper, i, i2);
+	const Int j1 = L::Select(upper, j2, j);
+	const Float b = L::Sub(L::Sub(half, L::Mul(x1, x1)), L::Mul(y1, y1));
+	const Float n1 = simplexCorner<L>(b, gradCoord<L>(seed, i1, j1, x1, y1));
+
+	return L::Mul(L::Add(L::Add(n0, n1), n2), L::Splat(99.83685446303647f));
+}
+
+template <typename L>
+typename L::Float interpHermite(typename L::Float t)
+{
+	return L::Mul(L::Mul(t, t), L::Sub(L::Splat(3.0f), L::Mul(L::Splat(2.0f), t)));
+}
+
+template <typename L>
+typename L::Float lerp(typename L::Float a, typename L::Float b, typename L::Float t)
+{
+	return L::Add(a, L::Mul(t, L::Sub(b, a)));
+}
+
+template <typename L>
+typename L::Float singleValue(typename L::Int seed, typename L::Float x, typename L::Float y)
+{
+	using Float = typename L::Float;
+	using Int = typename L::Int;
+
+	Int x0 = L::FastFloor(x);
+	Int y0 = L::FastFloor(y);
+	const Float xs = interpHermite<L>(L::Sub(x, L::ToFloat(x0)));
+	const Float ys = interpHermite<L>(L::Sub(y, L::ToFloat(y0)));
+
+	x0 = L::Mul(x0, L::Splat(PRIME_X));
+	y0 = L::Mul(y0, L::Splat(PRIME_Y));
+	const Int x1 = L::Add(x0, L::Splat(PRIME_X));
+	const Int y1 = L::Add(y0, L::Splat(PRIME_Y));
+
+	const Float xf0 = lerp<L>(valCoord<L>(seed, x0, y0), valCoord<L>(seed, x1, y0), xs);
+	const Float xf1 = lerp<L>(valCoord<L>(seed, x0, y1), valCoord<L>(seed, x1, y1), xs);
+	return lerp<L>(xf0, xf1, ys);
+}
+
+// Frequency scale and skew exactly as FastNoiseLite::TransformNoiseCoordinate does them
+template <typename L>
+typename L::Float sampleNoise(NoiseKernelType type, int seed, float frequency, typename L::Float x, typename L::Float y)
+{
+	using Float = typename L::Float;
+	x = L::Mul(x, L::Splat(frequency));
+	y = L::Mul(y, L::Splat(frequency));
+	const typename L::Int seedLanes = L::Splat(int32_t(seed));
+
+	switch (type) {
+	case NoiseKernelType::Value:
+		return singleValue<L>(seedLanes, x, y);
+	case NoiseKernelType::OpenSimplex2:
+	default: {
+		const float SQRT3 = (float)1.7320508075688772935274463415059;
+		const float F2 = 0.5f * (SQRT3 - 1);
+		const Float t = L::Mul(L::Add(x, y), L::Splat(F2));
+		x = L::Add(x, t);
+		y = L::Add(y, t);
+		return singleSimplex<L>(seedLanes, x, y);
+	}
+	}
+}
+
+// Full-width groups across each row, then the leftover samples one at a time
+template <typename L>
+void generateNoiseGrid(const NoiseGridDesc& desc, float* outData)
+{
+	for (int y = 0; y < desc.Height; y++) {
+		float* row = outData + static_cast<size_t>(y) * desc.Width;
+		const typename L::Float gridY = L::ToFloat(L::Splat(int32_t(desc.OriginY + y)));
+
+		int x = 0;
+		for (; x + L::WIDTH <= desc.Width; x += L::WIDTH) {
+			const typename L::Float gridX = L::ToFloat(L::Add(L::Splat(int32_t(desc.OriginX + x)), L::LaneIndex()));
+			L::Store(row + x, sampleNoise<L>(desc.Type, desc.Seed, desc.Frequency, gridX, gridY));
+		}
+		for (; x < desc.Width; x++) {
+			row[x] = sampleNoise<ScalarLanes>(desc.Type, desc.Seed, desc.Frequency, static_cast<float>(desc.OriginX + x), static_cast<float>(desc.OriginY + y));
+		}
+	}
+}
+
+template <typename L>
+void generateNoisePoints(NoiseKernelType type, int seed, float frequency, const float* xs, const float* ys, size_t count, float* outData)
+{
+	size_t i = 0;
+	for (; i + L::WIDTH <= count; i += L::WIDTH) {
+		L::Store(outData + i, sampleNoise<L>(type, seed, frequency, L::Load(xs + i), L::Load(ys + i)));
+	}
+	for (; i < count; i++) {
+		outData[i] = sampleNoise<ScalarLanes>(type, seed, frequency, xs[i], ys[i]);
+	}
+}
+} // namespace
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,62 @@
+// Compiled with SSE4.1 enabled (see CMakeLists.txt), only called once the CPU has been checked for it
+#include "NoiseKernelsImpl.hpp"
+
+#ifdef TERRACOTTA_NOISE_X86
+#include <smmintrin.h>
+
+namespace TerracottaEngine
+{
+namespace
+{
+struct SSE41Lanes
+{
+	static constexpr int WIDTH = 4;
+	using Float = __m128;
+	using Int = __m128i;
+	using Mask = __m128;
+
+	static Float Splat(float v) { return _mm_set1_ps(v); }
+	static Int Splat(int32_t v) { return _mm_set1_epi32(v); }
+	static Int LaneIndex() { return _mm_setr_epi32(0, 1, 2, 3); }
+	static Float Load(const float* in) { return _mm_loadu_ps(in); }
+	static void Store(float* out, Float v) { _mm_storeu_ps(out, v); }
+
+	static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+	static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+	static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+	static Int Add(Int a, Int b) { return _mm_add_epi32(a, b); }
+	static Int Mul(Int a, Int b) { return _mm_mullo_epi32(a, b); }
+	static Int Xor(Int a, Int b) { return _mm_xor_si128(a, b); }
+	static Int And(Int a, Int b) { return _mm_and_si128(a, b); }
+	template <int N> static Int ShiftRight(Int a) { return _mm_srai_epi32(a, N); }
+	template <int N> static Int ShiftLeft(Int a) { return _mm_slli_epi32(a, N); }
+
+	static Mask Greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+	static Mask LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+	static Float Select(Mask m, Float a, Float b) { return _mm_blendv_ps(b, a, m); }
+	static Int Select(Mask m, Int a, Int b) { return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b), _mm_castsi128_ps(a), m)); }
+
+	static Float ToFloat(Int a) { return _mm_cvtepi32_ps(a); }
+	// Truncate, then take one off negative values (the all-ones compare mask is -1)
+	static Int FastFloor(Float f) { return _mm_add_epi32(_mm_cvttps_epi32(f), _mm_castps_si128(_mm_cmplt_ps(f, _mm_setzero_ps()))); }
+	// No gather before AVX2
+	static Float Gather(const float* table, Int index)
+	{
+		alignas(16) int32_t lanes[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+		return _mm_setr_ps(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+	}
+};
+} // namespace
+
+void GenerateNoiseGridSSE41(const NoiseGridDesc& desc, float* outData)
+{
+	generateNoiseGrid<SSE41Lanes>(desc, outData);
+}
+
+void GenerateNoisePointsSSE41(NoiseKernelType type, int seed, float frequency, const float* xs, const float* ys, size_t count, float* outData)
+{
+	generateNoisePoints<SSE41Lanes>(type, seed, frequency, xs, ys, count, outData);
+}
+} // namespace TerracottaEngine
+#endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstddef>
+#include "spdlog/spdlog.h"
+#include "ParticleSystem.hpp"
+
+namespace TerracottaEngine
+{
+// SSBO binding points shared by all particle shaders
+static constexpr GLuint PARTICLES_IN_BINDING = 0;
+static constexpr GLuint PARTICLES_OUT_BINDING = 1;
+static constexpr GLuint COUNTERS_BINDING = 2;
+static constexpr GLuint EMIT_REQUESTS_BINDING = 3;
+
+ParticleSystem::ParticleSystem()
+{}
+ParticleSystem::~ParticleSystem()
+{}
+
+bool ParticleSystem::Init(uint32_t maxParticles)
+{
+	m_maxParticles = maxParticles;
+
+	m_emitShader = std::make_unique<ShaderProgram>();
+	m_emitShader->InitializeComputeProgram("../../../../../TerracottaEngine/res/ParticleEmitComp.glsl");
+	m_simulateShader = std::make_unique<ShaderProgram>();
+	m_simulateShader->InitializeComputeProgram("../../../../../TerracottaEngine/res/ParticleSimulateComp.glsl");
+	m_finalizeShader = std::make_unique<ShaderProgram>();
+	m_finalizeShader->InitializeComputeProgram("../../../../../TerracottaEngine/res/ParticleFinalizeComp.glsl");
+	m_renderShader = std::make_unique<ShaderProgram>();
+	m_renderShader->InitializeShaderProgram("../../../../../TerracottaEngine/res/ParticleVert.glsl", "../../../../../TerracottaEngine/res/ParticleFrag.glsl");
+
+	// Particle storage never touches the CPU after allocation
+	glCreateBuffers(2, m_particleBuffers);
+	for (GLuint buffer : m_particleBuffers) {
+		glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(maxParticles) * sizeof(GPUParticle), nullptr, 0);
+	}
+
+	GPUParticleCounters counters = {};
+	counters.VertexCount = 4; // One triangle strip quad per instance
+	counters.GroupsY = 1;
+	counters.GroupsZ = 1;
+	glCreateBuffers(1, &m_counterBuffer);
+	glNamedBufferStorage(m_counterBuffer, sizeof(GPUParticleCounters), &counters, 0);
+
+	glCreateBuffers(1, &m_emitBuffer);
+	glNamedBufferStorage(m_emitBuffer, MAX_EMIT_REQUESTS * sizeof(GPUEmitRequest), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	glCreateVertexArrays(1, &m_emptyVAO);
+
+	m_pendingEmits.reserve(MAX_EMIT_REQUESTS);
+
+	SPDLOG_INFO("Particle system initialized with room for {} particles ({} KiB per buffer).", maxParticles, maxParticles * sizeof(GPUParticle) / 1024);
+	return true;
+}
+void ParticleSystem::Shutdown()
+{
+	if (m_particleBuffers[0]) {
+		glDeleteBuffers(2, m_particleBuffers);
+		m_particleBuffers[0] = m_particleBuffers[1] = 0;
+	}
+	if (m_counterBuffer) {
+		glDeleteBuffers(1, &m_counterBuffer);
+		m_counterBuffer = 0;
+	}
+	if (m_emitBuffer) {
+		glDeleteBuffers(1, &m_emitBuffer);
+		m_emitBuffer = 0;
+	}
+	if (m_emptyVAO) {
+		glDeleteVertexArrays(1, &m_emptyVAO);
+		m_emptyVAO = 0;
+	}
+
+	m_emitShader.reset();
+	m_simulateShader.reset();
+	m_finalizeShader.reset();
+	m_renderShader.reset();
+	m_pendingEmits.clear();
+}
+
+void ParticleSystem::Emit(const ParticleEmitDesc& desc)
+{
+	if (desc.Count == 0 || desc.Lifetime <= 0.0f)
+		return;
+
+	if (m_pendingEmits.size() >= MAX_EMIT_REQUESTS) {
+		SPDLOG_WARN("Too many particle emit requests this update, dropping {} particles", desc.Count);
+		return;
+	}
+
+	GPUEmitRequest request;
+	request.Position = {desc.X, desc.Y};
+	request.Velocity = {desc.VelocityX, desc.VelocityY};
+	request.Color = {desc.R, desc.G, desc.B, desc.A};
+	request.Spread = desc.Spread;
+	request.Lifetime = desc.Lifetime;
+	request.Size = desc.Size;
+	request.Count = std::min(desc.Count, m_maxParticles);
+	m_pendingEmits.push_back(request);
+
+	m_pendingMaxCount = std::max(m_pendingMaxCount, request.Count);
+	// Lifetimes are jittered by up to 25% on the GPU, plus one step for the final compaction
+	m_lifetimeRemaining = std::max(m_lifetimeRemaining, desc.Lifetime * 1.25f + 0.1f);
+}
+
+void ParticleSystem::Update(const float deltaTime)
+{
+	m_lastDeltaTime = deltaTime;
+	if (!HasLiveParticles() && m_pendingEmits.empty())
+		return;
+
+	m_lifetimeRemaining = std::max(m_lifetimeRemaining - deltaTime, 0.0f);
+
+	const uint32_t in = m_current, out = 1 - m_current;
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PARTICLES_IN_BINDING, m_particleBuffers[in]);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PARTICLES_OUT_BINDING, m_particleBuffers[out]);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COUNTERS_BINDING, m_counterBuffer);
+
+	// Simulate and compact the survivors into the other buffer, sized by what finalize wrote last step
+	m_simulateShader->Use();
+	m_simulateShader->UploadUniformFloat("u_deltaTime", deltaTime);
+	m_simulateShader->UploadUniformVec2("u_gravity", m_gravity);
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, m_counterBuffer);
+	glDispatchComputeIndirect(offsetof(GPUParticleCounters, GroupsX));
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	// Append new particles behind the survivors, one workgroup row per request
+	if (!m_pendingEmits.empty()) {
+		glNamedBufferSubData(m_emitBuffer, 0, m_pendingEmits.size() * sizeof(GPUEmitRequest), m_pendingEmits.data());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, EMIT_REQUESTS_BINDING, m_emitBuffer);
+
+		m_emitShader->Use();
+		m_emitShader->UploadUniformUInt("u_maxParticles", m_maxParticles);
+		m_emitShader->UploadUniformUInt("u_seed", m_seed++);
+		glDispatchCompute((m_pendingMaxCount + EMIT_WORKGROUP_SIZE - 1) / EMIT_WORKGROUP_SIZE, static_cast<GLuint>(m_pendingEmits.size()), 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		m_pendingEmits.clear();
+		m_pendingMaxCount = 0;
+	}
+
+	// Turn the append counter into next step's draw/dispatch arguments
+	m_finalizeShader->Use();
+	m_finalizeShader->UploadUniformUInt("u_maxParticles", m_maxParticles);
+	glDispatchCompute(1, 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+	glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+	m_current = out;
+}
+
+void ParticleSystem::Render(const glm::mat4& view, const glm::mat4& projection, const float alpha)
+{
+	if (!HasLiveParticles())
+		return;
+
+	m_renderShader->Use();
+	m_renderShader->UploadUniformMat4("u_view", view);
+	m_renderShader->UploadUniformMat4("u_projection", projection);
+	// Positions are from the latest update, step them back to line up with the interpolated camera
+	m_renderShader->UploadUniformFloat("u_rewind", (1.0f - alpha) * m_lastDeltaTime);
+
+	glBindVertexArray(m_emptyVAO);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PARTICLES_IN_BINDING, m_particleBuffers[m_current]);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_counterBuffer);
+	glDrawArraysIndirect(GL_TRIANGLE_STRIP, nullptr);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+#include "ShaderProgram.hpp"
+#include "SharedDataTypes.h"
+
+namespace TerracottaEngine
+{
+// std430 layouts, must match the particle shaders in TerracottaEngine/res
+struct GPUParticle
+{
+	glm::vec2 Position;
+	glm::vec2 Velocity;
+	glm::vec4 Color;
+	float Life; // Seconds left
+	float MaxLife;
+	float Size;
+	float Padding;
+};
+static_assert(sizeof(GPUParticle) == 48, "GPUParticle must match the std430 Particle struct");
+
+struct GPUEmitRequest
+{
+	glm::vec2 Position;
+	glm::vec2 Velocity;
+	glm::vec4 Color;
+	float Spread; // Random velocity added on top, in units/second
+	float Lifetime;
+	float Size;
+	uint32_t Count;
+};
+static_assert(sizeof(GPUEmitRequest) == 48, "GPUEmitRequest must match the std430 EmitRequest struct");
+
+struct GPUParticleCounters
+{
+	// DrawArraysIndirectCommand
+	GLuint VertexCount;
+	GLuint InstanceCount; // Live particles
+	GLuint FirstVertex;
+	GLuint BaseInstance;
+	// DispatchIndirectCommand for the next simulate pass
+	GLuint GroupsX, GroupsY, GroupsZ;
+	GLuint AliveOut; // Append counter for this step
+};
+
+// GPU-only particle system. Particles live in two SSBOs that are ping-ponged every update:
+// simulate compacts the survivors from one into the other, emit appends new particles behind them,
+// and a single-thread finalize pass writes the indirect draw/dispatch arguments. The CPU never reads a particle back.
+class ParticleSystem
+{
+public:
+	ParticleSystem();
+	~ParticleSystem();
+
+	bool Init(uint32_t maxParticles = 1 << 18);
+	void Shutdown();
+
+	// Queued requests are consumed by the next Update()
+	void Emit(const ParticleEmitDesc& desc);
+	void Update(const float deltaTime);
+	// alpha is how far rendering is between the last two updates
+	void Render(const glm::mat4& view, const glm::mat4& projection, const float alpha);
+
+	// Conservative, based on the longest lifetime emitted recently (the real count never leaves the GPU)
+	bool HasLiveParticles() const { return m_lifetimeRemaining > 0.0f; }
+	void SetGravity(const glm::vec2& gravity) { m_gravity = gravity; }
+private:
+	static constexpr uint32_t WORKGROUP_SIZE = 256;
+	static constexpr uint32_t EMIT_WORKGROUP_SIZE = 64;
+	static constexpr uint32_t MAX_EMIT_REQUESTS = 256;
+
+	std::unique_ptr<ShaderProgram> m_emitShader = nullptr;
+	std::unique_ptr<ShaderProgram> m_simulateShader = nullptr;
+	std::unique_ptr<ShaderProgram> m_finalizeShader = nullptr;
+	std::unique_ptr<ShaderProgram> m_renderShader = nullptr;
+
+	GLuint m_particleBuffers[2] = {0, 0};
+	GLuint m_counterBuffer = 0;
+	GLuint m_emitBuffer = 0;
+	GLuint m_emptyVAO = 0; // Vertices are pulled from the SSBO
+	uint32_t m_current = 0; // Buffer holding the live particles
+	uint32_t m_maxParticles = 0;
+
+	std::vector<GPUEmitRequest> m_pendingEmits;
+	uint32_t m_pendingMaxCount = 0;
+	glm::vec2 m_gravity = {0.0f, -9.8f};
+	float m_lastDeltaTime = 0.0f;
+	float m_lifetimeRemaining = 0.0f;
+	uint32_t m_seed = 0;
+};
+} // namespace TerracottaEngine
\ No newline at end of file
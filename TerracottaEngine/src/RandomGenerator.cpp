@@ -1,6 +1,7 @@
 #include <ctime>
 #include "spdlog/spdlog.h"
 #include "RandomGenerator.hpp"
+#include "NoiseKernels.hpp"
 
 namespace TerracottaEngine
 {
@@ -20,10 +21,12 @@ bool RandomGenerator::Init()
 		m_randomGen = std::mt19937(m_seed);
 	}
 
-	m_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+	m_noise.SetNoiseType(m_noiseType);
 	m_noise.SetSeed(m_seed);
 	m_noise.SetFrequency(m_frequency);
-	
+
+	SPDLOG_INFO("Noise kernels using {}", GetSimdLevelName(GetNoiseSimdLevel()));
+
 	return true;
 }
 void RandomGenerator::OnUpdate(const float deltaTime)
@@ -47,13 +50,55 @@ int RandomGenerator::GenerateRandomInt(int min, int max)
 
 void RandomGenerator::GetNoise2D(int width, int height, float* outData)
 {
-	std::vector<float> noise(width * height);
+	GetNoiseRegion(0, 0, width, height, outData);
+}
+void RandomGenerator::GetNoiseRegion(int originX, int originY, int width, int height, float* outData) const
+{
+	if (m_noiseGraph) {
+		// One arena per calling thread, sized by the first few chunks and reused after that
+		thread_local NoiseArena arena;
+		m_noiseGraph->Evaluate(m_seed, originX, originY, width, height, outData, arena);
+		return;
+	}
+
+	// The kernels match FastNoiseLite exactly, so which path runs never changes the world
+	if (m_noiseType == FastNoiseLite::NoiseType_OpenSimplex2 || m_noiseType == FastNoiseLite::NoiseType_Value) {
+		NoiseGridDesc desc;
+		desc.Type = m_noiseType == FastNoiseLite::NoiseType_Value ? NoiseKernelType::Value : NoiseKernelType::OpenSimplex2;
+		desc.Seed = m_seed;
+		desc.Frequency = m_frequency;
+		desc.OriginX = originX;
+		desc.OriginY = originY;
+		desc.Width = width;
+		desc.Height = height;
+		GenerateNoiseGrid(desc, outData);
+		return;
+	}
+
 	int i = 0;
 	for (int y = 0; y < height; y++) {
 		for (int x = 0; x < width; x++) {
-			noise[i++] = m_noise.GetNoise((float)x, (float)y);
+			outData[i++] = m_noise.GetNoise((float)(originX + x), (float)(originY + y));
 		}
 	}
-	std::memcpy(outData, noise.data(), noise.size() * sizeof(float));
+}
+void RandomGenerator::SetNoiseSeed(int seed)
+{
+	m_seed = seed;
+	m_noise.SetSeed(seed);
+}
+void RandomGenerator::SetNoiseType(FastNoiseLite::NoiseType noiseType)
+{
+	m_noiseType = noiseType;
+	m_noise.SetNoiseType(noiseType);
+}
+bool RandomGenerator::LoadNoiseGraph(const Filepath& path)
+{
+	std::unique_ptr<NoiseGraph> graph = NoiseGraph::LoadFromFile(path);
+	if (!graph)
+		return false;
+
+	m_noiseGraph = std::move(graph);
+	return true;
 }
 } // namespace TerracottaEngine
\ No newline at end of file
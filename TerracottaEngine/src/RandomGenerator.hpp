@@ -1,7 +1,9 @@
 #pragma once
 #include <random>
 #include <vector>
+#include <memory>
 #include "fastnoiselite/FastNoiseLite.h"
+#include "NoiseGraph.hpp"
 #include "Subsystem.hpp"
 
 namespace TerracottaEngine
@@ -20,12 +22,26 @@ public:
 	int GenerateRandomInt();
 	int GenerateRandomInt(int min, int max);
 
+	// Both write straight into outData. With a noise graph loaded it's evaluated instead, otherwise OpenSimplex2 and
+	// Value noise run on the SIMD kernels and other types per sample.
 	void GetNoise2D(int width, int length, float* outData);
+	// Samples world coordinates originX.. and originY.., row-major. The same coordinate always gives the same value
+	// for a given seed, so regions generated separately (or on other threads) line up exactly.
+	void GetNoiseRegion(int originX, int originY, int width, int height, float* outData) const;
+	void SetNoiseSeed(int seed);
+	int GetNoiseSeed() const { return m_seed; }
+	void SetNoiseType(FastNoiseLite::NoiseType noiseType);
+	FastNoiseLite::NoiseType GetNoiseType() const { return m_noiseType; }
+	// Like the seed, don't change the graph while other threads are sampling
+	bool LoadNoiseGraph(const Filepath& path);
+	void ClearNoiseGraph() { m_noiseGraph.reset(); }
 private:
 	std::mt19937 m_randomGen;
 	FastNoiseLite m_noise;
 	int m_seed;
 	float m_frequency;
+	FastNoiseLite::NoiseType m_noiseType = FastNoiseLite::NoiseType_OpenSimplex2;
+	std::unique_ptr<NoiseGraph> m_noiseGraph;
 	std::random_device m_rd;
 };
 } // namespace TerracottaEngine
\ No newline at end of file
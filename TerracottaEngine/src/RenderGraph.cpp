@@ -0,0 +1,345 @@
+#include <algorithm>
+#include "spdlog/spdlog.h"
+#include "RenderGraph.hpp"
+
+namespace TerracottaEngine
+{
+static size_t BytesPerPixel(GLenum format)
+{
+	switch (format) {
+	case GL_R8: return 1;
+	case GL_RG8: return 2;
+	case GL_RGBA16F: return 8;
+	case GL_RGBA32F: return 16;
+	default: return 4;
+	}
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(RenderResource resource)
+{
+	if (resource == BACKBUFFER || resource >= m_graph.m_resources.size()) {
+		SPDLOG_ERROR("Pass \"{}\" can't read resource {}", m_graph.m_passes[m_pass].Name, resource);
+		return *this;
+	}
+
+	m_graph.m_passes[m_pass].Reads.push_back(resource);
+	return *this;
+}
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(RenderResource resource)
+{
+	Pass& pass = m_graph.m_passes[m_pass];
+	if (resource >= m_graph.m_resources.size()) {
+		SPDLOG_ERROR("Pass \"{}\" can't write resource {}", pass.Name, resource);
+		return *this;
+	}
+	if (pass.Target != NO_TARGET) {
+		SPDLOG_WARN("Pass \"{}\" already renders into \"{}\"", pass.Name, m_graph.m_resources[pass.Target].Name);
+	}
+
+	pass.Target = resource;
+	return *this;
+}
+
+RenderGraph::RenderGraph()
+{}
+RenderGraph::~RenderGraph()
+{}
+
+void RenderGraph::Shutdown()
+{
+	for (PhysicalTarget& target : m_pool) {
+		glDeleteFramebuffers(1, &target.Framebuffer);
+		glDeleteTextures(1, &target.Texture);
+	}
+	m_pool.clear();
+
+	for (TimerFrame& frame : m_timerFrames) {
+		if (!frame.Queries.empty()) {
+			glDeleteQueries(static_cast<GLsizei>(frame.Queries.size()), frame.Queries.data());
+		}
+		frame = TimerFrame();
+	}
+
+	m_resources.clear();
+	m_passes.clear();
+	m_timings.clear();
+}
+
+void RenderGraph::Begin(int backbufferWidth, int backbufferHeight)
+{
+	m_passes.clear();
+	m_resources.clear();
+
+	Resource backbuffer;
+	backbuffer.Name = "Backbuffer";
+	backbuffer.Desc.Width = backbufferWidth;
+	backbuffer.Desc.Height = backbufferHeight;
+	m_resources.push_back(backbuffer);
+}
+
+RenderResource RenderGraph::CreateTarget(const char* name, const RenderTargetDesc& desc)
+{
+	Resource resource;
+	resource.Name = name;
+	resource.Desc = desc;
+	resource.Desc.Width = std::max(desc.Width, 1);
+	resource.Desc.Height = std::max(desc.Height, 1);
+	m_resources.push_back(resource);
+	return static_cast<RenderResource>(m_resources.size() - 1);
+}
+
+RenderGraph::PassBuilder RenderGraph::AddPass(const char* name, ExecuteFunc execute)
+{
+	Pass pass;
+	pass.Name = name;
+	pass.Execute = std::move(execute);
+	m_passes.push_back(std::move(pass));
+	return PassBuilder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+}
+
+void RenderGraph::Execute()
+{
+	cullAndSort();
+
+	// Lifetimes over the execution order, a target is only held from its first pass to its last
+	for (uint32_t i = 0; i < m_order.size(); i++) {
+		const Pass& pass = m_passes[m_order[i]];
+		auto markUse = [&](RenderResource resource)
+		{
+			Resource& r = m_resources[resource];
+			if (r.FirstUse < 0) {
+				r.FirstUse = static_cast<int>(i);
+			}
+			r.LastUse = static_cast<int>(i);
+		};
+		for (RenderResource read : pass.Reads) {
+			markUse(read);
+		}
+		markUse(pass.Target);
+	}
+
+	// Skip timing this frame if the queries from TIMER_FRAMES ago still aren't back
+	TimerFrame& timer = m_timerFrames[m_frameIndex++ % TIMER_FRAMES];
+	if (timer.Pending) {
+		collectTimings(timer);
+	}
+	const bool timed = !timer.Pending;
+	if (timed) {
+		if (timer.Queries.size() < m_order.size()) {
+			const size_t oldSize = timer.Queries.size();
+			timer.Queries.resize(m_order.size());
+			glCreateQueries(GL_TIME_ELAPSED, static_cast<GLsizei>(m_order.size() - oldSize), timer.Queries.data() + oldSize);
+		}
+		timer.Names.resize(m_order.size());
+		timer.Count = static_cast<uint32_t>(m_order.size());
+		timer.Pending = !m_order.empty();
+	}
+
+	for (uint32_t i = 0; i < m_order.size(); i++) {
+		const Pass& pass = m_passes[m_order[i]];
+
+		// Targets come out of the pool right before their first pass, and go back after their last one
+		for (Resource& resource : m_resources) {
+			if (resource.FirstUse == static_cast<int>(i) && &resource != &m_resources[BACKBUFFER]) {
+				resource.Physical = acquireTarget(resource.Desc);
+			}
+		}
+
+		const Resource& target = m_resources[pass.Target];
+		glBindFramebuffer(GL_FRAMEBUFFER, pass.Target == BACKBUFFER ? 0 : m_pool[target.Physical].Framebuffer);
+		glViewport(0, 0, target.Desc.Width, target.Desc.Height);
+
+		if (timed) {
+			timer.Names[i] = pass.Name;
+			glBeginQuery(GL_TIME_ELAPSED, timer.Queries[i]);
+		}
+		pass.Execute(*this);
+		if (timed) {
+			glEndQuery(GL_TIME_ELAPSED);
+		}
+
+		for (Resource& resource : m_resources) {
+			if (resource.LastUse == static_cast<int>(i) && resource.Physical >= 0) {
+				m_pool[resource.Physical].InUse = false;
+			}
+		}
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	releaseUnusedTargets();
+}
+
+GLuint RenderGraph::GetTexture(RenderResource resource) const
+{
+	if (resource >= m_resources.size() || m_resources[resource].Physical < 0)
+		return 0;
+
+	return m_pool[m_resources[resource].Physical].Texture;
+}
+
+glm::ivec2 RenderGraph::GetSize(RenderResource resource) const
+{
+	if (resource >= m_resources.size())
+		return glm::ivec2(0);
+
+	return {m_resources[resource].Desc.Width, m_resources[resource].Desc.Height};
+}
+
+size_t RenderGraph::GetTransientBytes() const
+{
+	size_t total = 0;
+	for (const PhysicalTarget& target : m_pool) {
+		total += static_cast<size_t>(target.Desc.Width) * target.Desc.Height * BytesPerPixel(target.Desc.Format);
+	}
+	return total;
+}
+
+void RenderGraph::cullAndSort()
+{
+	const uint32_t passCount = static_cast<uint32_t>(m_passes.size());
+
+	// Walk back from the backbuffer, a pass survives if it writes something a surviving pass reads
+	std::vector<bool> neededResource(m_resources.size(), false);
+	std::vector<bool> neededPass(passCount, false);
+	neededResource[BACKBUFFER] = true;
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (uint32_t p = 0; p < passCount; p++) {
+			if (neededPass[p] || m_passes[p].Target == NO_TARGET || !neededResource[m_passes[p].Target])
+				continue;
+
+			neededPass[p] = true;
+			for (RenderResource read : m_passes[p].Reads) {
+				neededResource[read] = true;
+			}
+			changed = true;
+		}
+	}
+
+	// Readers wait for every writer of what they read, writers of the same target keep declaration order
+	std::vector<std::vector<uint32_t>> dependents(passCount);
+	std::vector<uint32_t> dependencyCount(passCount, 0);
+	auto addEdge = [&](uint32_t from, uint32_t to)
+	{
+		dependents[from].push_back(to);
+		dependencyCount[to]++;
+	};
+	for (uint32_t p = 0; p < passCount; p++) {
+		if (!neededPass[p])
+			continue;
+
+		for (uint32_t w = 0; w < passCount; w++) {
+			if (w == p || !neededPass[w])
+				continue;
+
+			const RenderResource written = m_passes[w].Target;
+			const bool reads = std::find(m_passes[p].Reads.begin(), m_passes[p].Reads.end(), written) != m_passes[p].Reads.end();
+			if (reads || (w < p && written == m_passes[p].Target)) {
+				addEdge(w, p);
+			}
+		}
+	}
+
+	// Kahn's algorithm, always taking the earliest declared ready pass so independent passes keep their order
+	m_order.clear();
+	std::vector<bool> scheduled(passCount, false);
+	while (true) {
+		uint32_t next = passCount;
+		for (uint32_t p = 0; p < passCount; p++) {
+			if (neededPass[p] && !scheduled[p] && dependencyCount[p] == 0) {
+				next = p;
+				break;
+			}
+		}
+		if (next == passCount)
+			break;
+
+		scheduled[next] = true;
+		m_order.push_back(next);
+		for (uint32_t dependent : dependents[next]) {
+			dependencyCount[dependent]--;
+		}
+	}
+
+	// A cycle leaves passes unscheduled, run them in declaration order rather than dropping them
+	for (uint32_t p = 0; p < passCount; p++) {
+		if (neededPass[p] && !scheduled[p]) {
+			if (!m_warnedCycle) {
+				SPDLOG_ERROR("Render graph has a dependency cycle through pass \"{}\"", m_passes[p].Name);
+				m_warnedCycle = true;
+			}
+			m_order.push_back(p);
+		}
+	}
+}
+
+int RenderGraph::acquireTarget(const RenderTargetDesc& desc)
+{
+	for (size_t i = 0; i < m_pool.size(); i++) {
+		if (!m_pool[i].InUse && m_pool[i].Desc == desc) {
+			m_pool[i].InUse = true;
+			m_pool[i].UnusedFrames = 0;
+			return static_cast<int>(i);
+		}
+	}
+
+	PhysicalTarget target;
+	target.Desc = desc;
+	target.InUse = true;
+	glCreateTextures(GL_TEXTURE_2D, 1, &target.Texture);
+	glTextureStorage2D(target.Texture, 1, desc.Format, desc.Width, desc.Height);
+	glTextureParameteri(target.Texture, GL_TEXTURE_MIN_FILTER, desc.Filter);
+	glTextureParameteri(target.Texture, GL_TEXTURE_MAG_FILTER, desc.Filter);
+	glTextureParameteri(target.Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(target.Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glCreateFramebuffers(1, &target.Framebuffer);
+	glNamedFramebufferTexture(target.Framebuffer, GL_COLOR_ATTACHMENT0, target.Texture, 0);
+	if (glCheckNamedFramebufferStatus(target.Framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		SPDLOG_ERROR("Render target of {}x{} is incomplete!", desc.Width, desc.Height);
+	}
+
+	m_pool.push_back(target);
+	SPDLOG_INFO("Allocated {}x{} render target, {} pooled ({} KiB)", desc.Width, desc.Height, m_pool.size(), GetTransientBytes() / 1024);
+	return static_cast<int>(m_pool.size() - 1);
+}
+
+void RenderGraph::releaseUnusedTargets()
+{
+	for (PhysicalTarget& target : m_pool) {
+		target.UnusedFrames++;
+	}
+	for (const Resource& resource : m_resources) {
+		if (resource.Physical >= 0) {
+			m_pool[resource.Physical].UnusedFrames = 0;
+		}
+	}
+
+	// Mostly leftovers from a window resize
+	auto stale = [](const PhysicalTarget& target) { return target.UnusedFrames > UNUSED_TARGET_FRAMES; };
+	for (PhysicalTarget& target : m_pool) {
+		if (stale(target)) {
+			glDeleteFramebuffers(1, &target.Framebuffer);
+			glDeleteTextures(1, &target.Texture);
+		}
+	}
+	m_pool.erase(std::remove_if(m_pool.begin(), m_pool.end(), stale), m_pool.end());
+}
+
+void RenderGraph::collectTimings(TimerFrame& frame)
+{
+	GLint available = 0;
+	glGetQueryObjectiv(frame.Queries[frame.Count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+		return;
+
+	m_timings.resize(frame.Count);
+	for (uint32_t i = 0; i < frame.Count; i++) {
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(frame.Queries[i], GL_QUERY_RESULT, &nanoseconds);
+		m_timings[i] = {frame.Names[i], static_cast<float>(nanoseconds / 1.0e6)};
+	}
+	frame.Pending = false;
+}
+} // namespace TerracottaEngine
\ No newline at end of file
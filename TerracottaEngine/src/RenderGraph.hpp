@@ -0,0 +1,122 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+namespace TerracottaEngine
+{
+using RenderResource = uint32_t;
+
+struct RenderTargetDesc
+{
+	int Width = 0, Height = 0;
+	GLenum Format = GL_RGBA8;
+	GLint Filter = GL_LINEAR;
+
+	bool operator==(const RenderTargetDesc& other) const = default;
+};
+
+struct RenderPassTiming
+{
+	std::string Name;
+	float Milliseconds;
+};
+
+// Declared from scratch every frame. Passes name the targets they read and the one they render into, then Execute()
+// drops passes nothing reaches the backbuffer through, orders the rest by dependency, and hands transient targets
+// out of a pool so targets whose lifetimes don't overlap share the same texture. Each pass gets a GPU timer query.
+class RenderGraph
+{
+public:
+	static constexpr RenderResource BACKBUFFER = 0; // Default framebuffer, the graph's only output
+	using ExecuteFunc = std::function<void(const RenderGraph& graph)>;
+
+	class PassBuilder
+	{
+	public:
+		// Sampled by the pass, it runs after every pass that writes the target
+		PassBuilder& Read(RenderResource resource);
+		// Bound as the pass's framebuffer with the viewport set to its size
+		PassBuilder& Write(RenderResource resource);
+	private:
+		friend class RenderGraph;
+		PassBuilder(RenderGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+		RenderGraph& m_graph;
+		uint32_t m_pass;
+	};
+
+	RenderGraph();
+	~RenderGraph();
+
+	void Shutdown();
+
+	void Begin(int backbufferWidth, int backbufferHeight);
+	RenderResource CreateTarget(const char* name, const RenderTargetDesc& desc);
+	PassBuilder AddPass(const char* name, ExecuteFunc execute);
+	void Execute();
+
+	// Only valid for targets the executing pass declared
+	GLuint GetTexture(RenderResource resource) const;
+	glm::ivec2 GetSize(RenderResource resource) const;
+
+	// Results lag a couple of frames behind so reading them never stalls
+	const std::vector<RenderPassTiming>& GetPassTimings() const { return m_timings; }
+	size_t GetTransientBytes() const;
+private:
+	static constexpr uint32_t TIMER_FRAMES = 3;
+	static constexpr uint32_t UNUSED_TARGET_FRAMES = 60; // Pooled targets nobody asked for this long are freed
+	static constexpr uint32_t NO_TARGET = 0xFFFFFFFF;
+
+	struct Resource
+	{
+		std::string Name;
+		RenderTargetDesc Desc;
+		int Physical = -1;
+		int FirstUse = -1, LastUse = -1; // Positions in the execution order
+	};
+
+	struct Pass
+	{
+		std::string Name;
+		ExecuteFunc Execute;
+		std::vector<RenderResource> Reads;
+		RenderResource Target = NO_TARGET;
+	};
+
+	struct PhysicalTarget
+	{
+		RenderTargetDesc Desc;
+		GLuint Texture = 0;
+		GLuint Framebuffer = 0;
+		bool InUse = false;
+		uint32_t UnusedFrames = 0;
+	};
+
+	struct TimerFrame
+	{
+		std::vector<std::string> Names;
+		std::vector<GLuint> Queries;
+		uint32_t Count = 0;
+		bool Pending = false;
+	};
+
+	std::vector<Resource> m_resources;
+	std::vector<Pass> m_passes;
+	std::vector<PhysicalTarget> m_pool;
+	std::vector<uint32_t> m_order;
+
+	TimerFrame m_timerFrames[TIMER_FRAMES];
+	uint32_t m_frameIndex = 0;
+	std::vector<RenderPassTiming> m_timings;
+	bool m_warnedCycle = false;
+
+	void cullAndSort();
+	int acquireTarget(const RenderTargetDesc& desc);
+	void releaseUnusedTargets();
+	void collectTimings(TimerFrame& frame);
+};
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -5,7 +5,7 @@
 namespace TerracottaEngine
 {
 
-ChunkRenderProxy::ChunkRenderProxy(uint32_t chunkX, uint32_t chunkY) :
+ChunkRenderProxy::ChunkRenderProxy(int32_t chunkX, int32_t chunkY) :
 	m_chunkX(chunkX), m_chunkY(chunkY)
 {
 	m_vertices.reserve(256 * 4); // 16x16 tiles * 4 verts
@@ -21,12 +21,17 @@ void ChunkRenderProxy::UpdateFromRenderTiles(const RenderTile* tiles, uint32_t t
 {
 	m_vertices.clear();
 	m_indices.clear();
+	m_textureSlotMask = 0;
 
 	SPDLOG_DEBUG("Chunk ({}, {}) updating with {} tiles", m_chunkX, m_chunkY, tileCount);
 
 	// Convert RenderTile[] to Vertex[] and indices
 	for (uint32_t i = 0; i < tileCount; ++i) {
 		const RenderTile& tile = tiles[i];
+		const uint32_t slot = static_cast<uint32_t>(tile.TextureIndex);
+		if (slot < 32) {
+			m_textureSlotMask |= 1u << slot;
+		}
 
 		// Quad corners
 		glm::vec3 positions[4]
@@ -67,48 +72,29 @@ ChunkRenderProxyManager::~ChunkRenderProxyManager()
 	Shutdown();
 }
 
-void ChunkRenderProxyManager::InitializeChunks(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks)
+void ChunkRenderProxyManager::Init()
 {
-	m_worldWidthInChunks = worldWidthInChunks;
-	m_worldHeightInChunks = worldHeightInChunks;
-
-	uint32_t totalChunks = worldWidthInChunks * worldHeightInChunks;
-	m_renderProxies.clear();
-	m_renderProxies.reserve(totalChunks);
-
-	for (uint32_t y = 0; y < worldHeightInChunks; y++) {
-		for (uint32_t x = 0; x < worldWidthInChunks; x++) {
-			m_renderProxies.push_back(std::make_unique<ChunkRenderProxy>(x, y));
-		}
-	}
+	m_renderProxies.Clear();
 
 	// Create single VAO/VBO/EBO for entire world
+	// Rebuilds rewrite everything, orphan so the upload never waits on the previous frame's draw
 	m_vao = std::make_unique<VertexArray>();
-	m_vbo = std::make_unique<BufferObject>(GL_ARRAY_BUFFER);
-	m_ebo = std::make_unique<BufferObject>(GL_ELEMENT_ARRAY_BUFFER);
+	m_vbo = std::make_unique<BufferObject>(BufferUpdatePolicy::Orphan, BufferGrowPolicy::Double);
+	m_ebo = std::make_unique<BufferObject>(BufferUpdatePolicy::Orphan, BufferGrowPolicy::Double);
 
-	// Set up vertex attributes
-	m_vao->Bind();
-	m_vbo->Bind();
-	m_vao->LinkAttribute(0, 3, GL_FLOAT, sizeof(Vertex), (void*)offsetof(Vertex, Position));
-	m_vao->LinkAttribute(1, 2, GL_FLOAT, sizeof(Vertex), (void*)offsetof(Vertex, TextureCoord));
-	m_vao->LinkAttribute(2, 1, GL_FLOAT, sizeof(Vertex), (void*)offsetof(Vertex, TextureIndex));
-	m_vao->Unbind();
-
-	// Reserve staging buffer space (assume max 256 tiles per chunk)
-	uint32_t maxVertices = totalChunks * 256 * 4;
-	uint32_t maxIndices = totalChunks * 256 * 6;
-	m_vertexBuffer.reserve(maxVertices);
-	m_indexBuffer.reserve(maxIndices);
+	// Set up vertex attributes, buffers are attached once they have storage
+	m_vao->LinkAttribute(0, 0, 3, GL_FLOAT, offsetof(Vertex, Position));
+	m_vao->LinkAttribute(1, 0, 2, GL_FLOAT, offsetof(Vertex, TextureCoord));
+	m_vao->LinkAttribute(2, 0, 1, GL_FLOAT, offsetof(Vertex, TextureIndex));
 
 	m_needsRebuild = true;
 
-	SPDLOG_INFO("Initialized {} chunk render proxies ({}x{}) with shared buffers", totalChunks, worldWidthInChunks, worldHeightInChunks);
+	SPDLOG_INFO("Initialized chunk render proxies with shared buffers");
 }
 
 void ChunkRenderProxyManager::Shutdown()
 {
-	m_renderProxies.clear();
+	m_renderProxies.Clear();
 	m_vao.reset();
 	m_vbo.reset();
 	m_ebo.reset();
@@ -116,23 +102,37 @@ void ChunkRenderProxyManager::Shutdown()
 	m_indexBuffer.clear();
 }
 
-ChunkRenderProxy* ChunkRenderProxyManager::GetChunk(uint32_t chunkX, uint32_t chunkY)
+ChunkRenderProxy* ChunkRenderProxyManager::GetChunk(int32_t chunkX, int32_t chunkY)
+{
+	std::unique_ptr<ChunkRenderProxy>* proxy = m_renderProxies.Find(chunkX, chunkY);
+	return proxy ? proxy->get() : nullptr;
+}
+
+ChunkRenderProxy* ChunkRenderProxyManager::GetOrCreateChunk(int32_t chunkX, int32_t chunkY)
 {
-	uint32_t index = chunkY * m_worldWidthInChunks + chunkX;
-	if (index >= m_renderProxies.size()) {
-		SPDLOG_ERROR("Invalid chunk coordinates ({}, {})", chunkX, chunkY);
-		return nullptr;
+	if (ChunkRenderProxy* proxy = GetChunk(chunkX, chunkY))
+		return proxy;
+
+	m_needsRebuild = true;
+	return m_renderProxies.Insert(chunkX, chunkY, std::make_unique<ChunkRenderProxy>(chunkX, chunkY)).get();
+}
+
+void ChunkRenderProxyManager::RemoveChunk(int32_t chunkX, int32_t chunkY)
+{
+	if (m_renderProxies.Erase(chunkX, chunkY)) {
+		m_needsRebuild = true;
 	}
-	return m_renderProxies[index].get();
 }
 
 void ChunkRenderProxyManager::RebuildBuffers()
 {
 	m_vertexBuffer.clear();
 	m_indexBuffer.clear();
+	m_textureSlotMask = 0;
 
 	// Gather all chunk data into staging buffers
-	for (auto& chunk : m_renderProxies) {
+	m_renderProxies.ForEach([this](glm::ivec2, std::unique_ptr<ChunkRenderProxy>& chunk)
+	{
 		const auto& chunkVertices = chunk->GetVertices();
 		const auto& chunkIndices = chunk->GetIndices();
 
@@ -150,17 +150,17 @@ void ChunkRenderProxyManager::RebuildBuffers()
 		// Tell chunk where its data lives in the buffer
 		chunk->SetBufferRange(vertexOffset, indexOffset, static_cast<uint32_t>(chunkIndices.size()));
 		chunk->ClearDirty();
-	}
+		m_textureSlotMask |= chunk->GetTextureSlotMask();
+	});
 
 	// Upload to GPU
-	if (!m_vertexBuffer.empty()) {
-		m_vbo->Bind();
-		m_vbo->BufferInitData(m_vertexBuffer.size() * sizeof(Vertex), m_vertexBuffer.data(), GL_STATIC_DRAW);
+	// Storage only gets reallocated when the world outgrows it
+	if (!m_vertexBuffer.empty() && m_vbo->Upload(m_vertexBuffer.data(), m_vertexBuffer.size() * sizeof(Vertex))) {
+		m_vao->AttachVertexBuffer(0, *m_vbo, sizeof(Vertex));
 	}
 
-	if (!m_indexBuffer.empty()) {
-		m_ebo->Bind();
-		m_ebo->BufferInitData(m_indexBuffer.size() * sizeof(uint32_t), m_indexBuffer.data(), GL_STATIC_DRAW);
+	if (!m_indexBuffer.empty() && m_ebo->Upload(m_indexBuffer.data(), m_indexBuffer.size() * sizeof(uint32_t))) {
+		m_vao->AttachIndexBuffer(*m_ebo);
 	}
 
 	m_needsRebuild = false;
@@ -172,12 +172,7 @@ void ChunkRenderProxyManager::UploadDirtyChunks()
 {
 	// Check if any chunks are dirty
 	bool anyDirty = false;
-	for (auto& chunk : m_renderProxies) {
-		if (chunk->IsDirty()) {
-			anyDirty = true;
-			break;
-		}
-	}
+	m_renderProxies.ForEach([&anyDirty](glm::ivec2, const std::unique_ptr<ChunkRenderProxy>& chunk) { anyDirty |= chunk->IsDirty(); });
 
 	// If any chunks changed, rebuild entire buffer
 	// TODO: Optimize to only update changed chunks
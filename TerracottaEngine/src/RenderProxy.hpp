@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include "ChunkHashMap.hpp"
 #include "VertexInput.hpp"
 #include "SharedDataTypes.h"
 
@@ -11,7 +12,7 @@ namespace TerracottaEngine
 class ChunkRenderProxy
 {
 public:
-	ChunkRenderProxy(uint32_t chunkX, uint32_t chunkY);
+	ChunkRenderProxy(int32_t chunkX, int32_t chunkY);
 	~ChunkRenderProxy();
 
 	// Called when game sends new tile data
@@ -23,8 +24,10 @@ public:
 	// Getters for manager to access data
 	const std::vector<Vertex>& GetVertices() const { return m_vertices; }
 	const std::vector<uint32_t>& GetIndices() const { return m_indices; }
-	uint32_t GetChunkX() const { return m_chunkX; }
-	uint32_t GetChunkY() const { return m_chunkY; }
+	int32_t GetChunkX() const { return m_chunkX; }
+	int32_t GetChunkY() const { return m_chunkY; }
+	// Bit N set when any tile samples atlas slot N
+	uint32_t GetTextureSlotMask() const { return m_textureSlotMask; }
 
 	// Set by manager after upload
 	void SetBufferRange(uint32_t vertexOffset, uint32_t indexOffset, uint32_t indexCount)
@@ -38,11 +41,12 @@ public:
 	uint32_t GetIndexOffset() const { return m_indexOffset; }
 	uint32_t GetIndexCount() const { return m_indexCount; }
 private:
-	uint32_t m_chunkX, m_chunkY;
+	int32_t m_chunkX, m_chunkY;
 
 	// CPU-side data
 	std::vector<Vertex> m_vertices;
 	std::vector<uint32_t> m_indices;
+	uint32_t m_textureSlotMask = 0;
 
 	// Range in the shared buffers (set by manager)
 	uint32_t m_vertexOffset = 0;
@@ -58,19 +62,24 @@ public:
 	ChunkRenderProxyManager();
 	~ChunkRenderProxyManager();
 
-	void InitializeChunks(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks);
+	void Init();
 	void Shutdown();
 
-	ChunkRenderProxy* GetChunk(uint32_t chunkX, uint32_t chunkY);
+	// Proxies exist only for chunks the game has sent, so the world can extend in any direction
+	ChunkRenderProxy* GetChunk(int32_t chunkX, int32_t chunkY);
+	ChunkRenderProxy* GetOrCreateChunk(int32_t chunkX, int32_t chunkY);
+	void RemoveChunk(int32_t chunkX, int32_t chunkY);
+	size_t GetChunkCount() const { return m_renderProxies.Size(); }
 
 	// Called by Renderer each frame
 	void UploadDirtyChunks();
 	void RenderAll();
+
+	// Atlas slots the world pass samples, so unused atlases can be evicted
+	uint32_t GetTextureSlotMask() const { return m_textureSlotMask; }
 private:
 	// Chunk storage
-	std::vector<std::unique_ptr<ChunkRenderProxy>> m_renderProxies;
-	uint32_t m_worldWidthInChunks = 0;
-	uint32_t m_worldHeightInChunks = 0;
+	ChunkHashMap<std::unique_ptr<ChunkRenderProxy>> m_renderProxies;
 
 	// For the entire world
 	std::unique_ptr<VertexArray> m_vao;
@@ -80,6 +89,7 @@ private:
 	// CPU-side staging buffers
 	std::vector<Vertex> m_vertexBuffer;
 	std::vector<uint32_t> m_indexBuffer;
+	uint32_t m_textureSlotMask = 0;
 
 	bool m_needsRebuild = true;
 
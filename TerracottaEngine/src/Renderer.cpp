@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "glad/glad.h"
 #include "spdlog/spdlog.h"
 #include "glm/gtc/matrix_transform.hpp"
@@ -28,21 +29,38 @@ bool Renderer::Init()
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Create shader
+	ShaderProgram::QueryParallelCompileSupport();
 	m_renderer2D.Shader = std::make_unique<ShaderProgram>();
 	m_renderer2D.Shader->InitializeShaderProgram("../../../../../TerracottaEngine/res/DefaultVert.glsl", "../../../../../TerracottaEngine/res/DefaultFrag.glsl");
-
-	// Set up texture samplers
-	int samplers[Renderer2D::MAX_TEXTURES];
-	for (int i = 0; i < Renderer2D::MAX_TEXTURES; i++) {
-		samplers[i] = i;
-	}
-
-	m_renderer2D.Shader->Use();
-	m_renderer2D.Shader->UploadUniformIntArray("u_textures", Renderer2D::MAX_TEXTURES, samplers);
-
-	// Initialize camera matrices
-	m_renderer2D.Shader->UploadUniformMat4("u_view", m_camera.View);
-	m_renderer2D.Shader->UploadUniformMat4("u_projection", m_camera.Projection);
+	uploadDefaultShaderUniforms(*m_renderer2D.Shader);
+
+	// Rebuilt programs need their samplers and camera matrices again
+	m_shaderReloader.Watch(m_renderer2D.Shader, [this](ShaderProgram& shader)
+	{
+		uploadDefaultShaderUniforms(shader);
+		requestRedraw();
+	});
+
+	m_sprites.Init();
+	m_shaderReloader.Watch(m_sprites.GetShader(), [this](ShaderProgram& shader)
+	{
+		m_sprites.UploadSamplers(shader);
+		requestRedraw();
+	});
+	m_lights.Init();
+	m_shaderReloader.Watch(m_lights.GetLightShader(), [this](ShaderProgram&) { requestRedraw(); });
+	m_shaderReloader.Watch(m_lights.GetBlurShader(), [this](ShaderProgram&) { requestRedraw(); });
+	m_shaderReloader.Watch(m_lights.GetCompositeShader(), [this](ShaderProgram&) { requestRedraw(); });
+	m_particles.Init();
+
+	m_textureResidency.Init();
+	const glm::u8vec4 fallbackColor(128, 128, 128, 255);
+	m_fallbackTexture = std::make_unique<Texture>(1, 1, GL_RGBA8, GL_RGBA, &fallbackColor, GL_NEAREST);
+
+#ifdef TERRACOTTA_DEBUG_DRAW
+	m_debugDraw.Init();
+	m_shaderReloader.Watch(m_debugDraw.GetShader(), [this](ShaderProgram&) { requestRedraw(); });
+#endif
 
 	// Initialize texture slot 0 with debug texture (for testing)
 	for (uint32_t i = 0; i < Renderer2D::MAX_TEXTURES; i++) {
@@ -61,6 +79,17 @@ bool Renderer::Init()
 }
 void Renderer::Shutdown()
 {
+	m_debugDraw.Shutdown();
+	m_particles.Shutdown();
+	m_lights.Shutdown();
+	m_sprites.Shutdown();
+	m_fonts.clear();
+	m_minimap.Shutdown();
+	m_visibility.Shutdown();
+	m_renderGraph.Shutdown();
+	// Stops the reload worker before any atlas it points at goes away
+	m_textureResidency.Shutdown();
+	m_fallbackTexture.reset();
 	delete[] m_renderer2D.VBOBase;
 	m_renderer2D.VBOBase = nullptr;
 	delete[] m_renderer2D.EBOData;
@@ -69,15 +98,52 @@ void Renderer::Shutdown()
 
 void Renderer::OnUpdate(const float deltaTime)
 {
+	m_shaderReloader.Update(deltaTime);
+	// Sprites, lights and debug primitives are resubmitted every update tick
+	m_sprites.Clear();
+	m_lights.Clear();
+	m_debugDraw.Clear();
+	if (m_worldOverview) {
+		// Submitted before the game's sprites so it sorts under them
+		const MinimapDesc overview = {0.0f, 0.0f, 1.0f, 0.0f, 0, 1.0f};
+		SubmitMinimap(overview);
+	}
 	m_camera.Update(deltaTime);
+	m_particles.Update(deltaTime);
+	if (m_particles.HasLiveParticles()) {
+		requestRedraw();
+	}
 
 	if (m_camera.NeedsUpdate) {
 		m_renderer2D.Shader->Use();
 		m_renderer2D.Shader->UploadUniformMat4("u_view", m_camera.View);
 		m_renderer2D.Shader->UploadUniformMat4("u_projection", m_camera.Projection);
 		m_camera.NeedsUpdate = false;
+		requestRedraw();
+	}
+}
+void Renderer::requestRedraw()
+{
+	if (FrameScheduler* scheduler = m_manager.GetSubsystem<FrameScheduler>()) {
+		scheduler->RequestRedraw();
 	}
 }
+void Renderer::uploadDefaultShaderUniforms(ShaderProgram& shader)
+{
+	// Set up texture samplers
+	int samplers[Renderer2D::MAX_TEXTURES];
+	for (int i = 0; i < Renderer2D::MAX_TEXTURES; i++) {
+		samplers[i] = i;
+	}
+
+	shader.Use();
+	shader.UploadUniformIntArray("u_textures", Renderer2D::MAX_TEXTURES, samplers);
+
+	// Initialize camera matrices
+	shader.UploadUniformMat4("u_view", m_camera.View);
+	shader.UploadUniformMat4("u_projection", m_camera.Projection);
+}
+
 void Renderer::BeginBatch()
 {
 	// Resets VBOPtr back to VBOBase; Resets VertexCount and IndexCount to 0; Clears texture slot tracking
@@ -106,7 +172,7 @@ void Renderer::Flush()
 		glActiveTexture(GL_TEXTURE0 + i);
 
 		if (m_renderer2D.AtlasSlots[i]) {
-			m_renderer2D.AtlasSlots[i]->GetTexture().Bind();
+			residentAtlasTexture(m_renderer2D.AtlasSlots[i]).Bind();
 		} else if (m_renderer2D.TextureSlots[i]) {
 			m_renderer2D.TextureSlots[i]->Bind();
 		}
@@ -117,52 +183,304 @@ void Renderer::Flush()
 
 	glDrawElements(GL_TRIANGLES, m_renderer2D.IndexCount, GL_UNSIGNED_INT, 0);
 }
-void Renderer::OnRender()
+void Renderer::OnRender(const float alpha)
 {
-	glClear(GL_COLOR_BUFFER_BIT);
+	// Finished reloads get uploaded and atlases unused since last frame can be evicted
+	m_textureResidency.BeginFrame();
+
+	// Updates run at a fixed rate, smooth camera motion between them
+	const glm::mat4 view = m_camera.GetInterpolatedView(alpha);
 
 	// Upload any dirty chunks
 	m_renderer2D.ChunkManager.UploadDirtyChunks();
 
+	// Each feature declares its passes, the graph orders them, pools their targets and times them
+	int width, height;
+	glfwGetFramebufferSize(m_appWindow->GetGLFWWindow(), &width, &height);
+	m_renderGraph.Begin(width, height);
+
+	m_renderGraph.AddPass("World", [this, &view](const RenderGraph&) { renderWorld(view); }).Write(RenderGraph::BACKBUFFER);
+
+	// Sprites are radix-sorted by layer/atlas/depth and drawn in as few batches as possible
+	m_renderGraph.AddPass("Sprites", [this, &view](const RenderGraph&)
+	{
+		m_sprites.Flush(view, m_camera.Projection, [this](uint32_t slot) { return resolveTexture(slot); });
+	}).Write(RenderGraph::BACKBUFFER);
+
+	// Lights are accumulated at reduced resolution and multiplied over the tiles and sprites
+	m_lights.AddPasses(m_renderGraph, view, m_camera.Projection);
+
+	// Particles are drawn straight from their SSBO with an indirect draw
+	m_renderGraph.AddPass("Particles", [this, &view, alpha](const RenderGraph&)
+	{
+		m_particles.Render(view, m_camera.Projection, alpha);
+	}).Write(RenderGraph::BACKBUFFER);
+
+#ifdef TERRACOTTA_DEBUG_DRAW
+	// Debug overlay goes on top of the world in one draw
+	m_renderGraph.AddPass("DebugDraw", [this, &view](const RenderGraph&) { m_debugDraw.Flush(view, m_camera.Projection); }).Write(RenderGraph::BACKBUFFER);
+#endif
+
+	m_renderGraph.Execute();
+}
+
+void Renderer::renderWorld(const glm::mat4& view)
+{
+	glClear(GL_COLOR_BUFFER_BIT);
+
 	// Bind shader
 	m_renderer2D.Shader->Use();
 
 	// Bind camera matrices
-	m_renderer2D.Shader->UploadUniformMat4("u_view", m_camera.View);
+	m_renderer2D.Shader->UploadUniformMat4("u_view", view);
 	m_renderer2D.Shader->UploadUniformMat4("u_projection", m_camera.Projection);
 
-	// Bind all textures
+	// Fog of war is looked up per tile in the fragment shader, the chunk meshes never change for it
+	m_renderer2D.Shader->UploadUniformInt("u_visibilityEnabled", m_visibility.IsEnabled() ? 1 : 0);
+	m_visibility.Bind();
+
+	// Bind all textures, only atlases the chunks actually sample count as used
+	const uint32_t chunkSlotMask = m_worldOverview ? 0 : m_renderer2D.ChunkManager.GetTextureSlotMask();
 	for (uint32_t i = 0; i < m_renderer2D.TextureSlotIndex; ++i) {
 		glActiveTexture(GL_TEXTURE0 + i);
 
 		// Check atlas first, then regular texture
 		if (m_renderer2D.AtlasSlots[i] != nullptr) {
-			m_renderer2D.AtlasSlots[i]->GetTexture().Bind();
+			if (chunkSlotMask & (1u << i)) {
+				residentAtlasTexture(m_renderer2D.AtlasSlots[i]).Bind();
+			} else if (m_renderer2D.AtlasSlots[i]->GetTexture().IsResident()) {
+				m_renderer2D.AtlasSlots[i]->GetTexture().Bind();
+			} else {
+				m_fallbackTexture->Bind();
+			}
 		} else if (m_renderer2D.TextureSlots[i] != nullptr) {
 			m_renderer2D.TextureSlots[i]->Bind();
 		}
 		// Will use default texture 0 if null
 	}
 
-	// Render all chunks
-	m_renderer2D.ChunkManager.RenderAll();
+	// Render all chunks, the overview draws the whole world as one minimap quad in the sprite pass instead
+	if (!m_worldOverview) {
+		m_renderer2D.ChunkManager.RenderAll();
+	}
 }
 
 void Renderer::InitChunkProxies(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks)
 {
-	m_renderer2D.ChunkManager.InitializeChunks(worldWidthInChunks, worldHeightInChunks);
+	// Chunks can live anywhere, the size only bounds the minimap and fog of war which start at chunk (0, 0)
+	m_renderer2D.ChunkManager.Init();
+	m_minimap.Init(worldWidthInChunks, worldHeightInChunks);
+	m_visibility.Init(worldWidthInChunks * CHUNK_SIZE, worldHeightInChunks * CHUNK_SIZE);
 }
 
-void Renderer::UpdateChunkTiles(uint32_t chunkX, uint32_t chunkY, const RenderTile* tiles, uint32_t tileCount)
+void Renderer::UpdateChunkTiles(int32_t chunkX, int32_t chunkY, const RenderTile* tiles, uint32_t tileCount)
 {
-	ChunkRenderProxy* chunk = m_renderer2D.ChunkManager.GetChunk(chunkX, chunkY);
-	if (!chunk) {
-		SPDLOG_ERROR("Failed to get chunk ({}, {})", chunkX, chunkY);
-		return;
-	}
+	ChunkRenderProxy* chunk = m_renderer2D.ChunkManager.GetOrCreateChunk(chunkX, chunkY);
 
 	// Proxy handles all the conversion internally
 	chunk->UpdateFromRenderTiles(tiles, tileCount);
+	m_minimap.UpdateChunk(chunkX, chunkY, tiles, tileCount, [this](const RenderTile& tile) { return tileColor(tile); });
+	requestRedraw();
+}
+
+void Renderer::RemoveChunkTiles(int32_t chunkX, int32_t chunkY)
+{
+	// The minimap keeps the chunk's colors, it shows everything that has been streamed in so far
+	m_renderer2D.ChunkManager.RemoveChunk(chunkX, chunkY);
+	requestRedraw();
+}
+
+void Renderer::EmitParticles(const ParticleEmitDesc& desc)
+{
+	m_particles.Emit(desc);
+	requestRedraw();
+}
+
+void Renderer::SubmitSprite(const SpriteDesc& desc)
+{
+	if (desc.AtlasID >= Renderer2D::MAX_TEXTURES) {
+		SPDLOG_ERROR("Invalid atlas ID {} for sprite", desc.AtlasID);
+		return;
+	}
+
+	SpriteCommand sprite;
+	sprite.Position = {desc.X, desc.Y};
+	sprite.Size = {desc.Width, desc.Height};
+	sprite.Rotation = desc.Rotation;
+	sprite.Color = {desc.R, desc.G, desc.B, desc.A};
+	sprite.AtlasID = desc.AtlasID;
+
+	TextureAtlas* atlas = m_renderer2D.AtlasSlots[desc.AtlasID];
+	sprite.UVs = atlas ? atlas->GetTileUVs(desc.TileID) : glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+	uint8_t layer = static_cast<uint8_t>(std::min(desc.Layer, 255u));
+	m_sprites.Submit(SpriteSortKey::Make(layer, static_cast<uint16_t>(desc.AtlasID), SpriteSortKey::QuantizeDepth(desc.Depth)), sprite);
+	requestRedraw();
+}
+
+void Renderer::SubmitLight(const LightDesc& desc)
+{
+	m_lights.Submit({{desc.X, desc.Y}, desc.Radius, desc.Intensity, {desc.R, desc.G, desc.B}});
+	requestRedraw();
+}
+
+void Renderer::SetAmbientLight(float r, float g, float b)
+{
+	// The first ambient value turns the lighting pass on
+	m_lights.SetAmbient({r, g, b});
+	m_lights.SetEnabled(true);
+	requestRedraw();
+}
+
+uint32_t Renderer::LoadFont(const char* path)
+{
+	if (!path) {
+		SPDLOG_ERROR("LoadFont: null path");
+		return INVALID_FONT_ID;
+	}
+
+	auto font = std::make_unique<SDFFont>();
+	if (!font->Load(path))
+		return INVALID_FONT_ID;
+
+	m_fonts.push_back(std::move(font));
+	return static_cast<uint32_t>(m_fonts.size() - 1);
+}
+
+void Renderer::SubmitText(const TextDesc& desc)
+{
+	if (!desc.Text || desc.FontID >= m_fonts.size()) {
+		SPDLOG_ERROR("Invalid font ID {} or null text", desc.FontID);
+		return;
+	}
+
+	// Glyphs are ordinary sprites with a distance field texture, so text batches with everything else on its layer
+	const GlyphRun& run = m_fonts[desc.FontID]->Layout(desc.Text);
+	const glm::vec2 origin = {desc.X, desc.Y};
+	const uint32_t material = FONT_MATERIAL_BASE + desc.FontID;
+	const uint8_t layer = static_cast<uint8_t>(std::min(desc.Layer, 255u));
+	const uint64_t sortKey = SpriteSortKey::Make(layer, static_cast<uint16_t>(material), SpriteSortKey::QuantizeDepth(desc.Depth));
+
+	SpriteCommand glyph;
+	glyph.Rotation = 0.0f;
+	glyph.Color = {desc.R, desc.G, desc.B, desc.A};
+	glyph.AtlasID = material;
+	glyph.DistanceField = true;
+	for (const GlyphQuad& quad : run.Quads) {
+		glyph.Position = origin + quad.Offset * desc.Size;
+		glyph.Size = quad.Size * desc.Size;
+		glyph.UVs = quad.UVs;
+		m_sprites.Submit(sortKey, glyph);
+	}
+	requestRedraw();
+}
+
+float Renderer::MeasureText(uint32_t fontId, const char* text, float size)
+{
+	if (!text || fontId >= m_fonts.size())
+		return 0.0f;
+
+	return m_fonts[fontId]->MeasureWidth(text) * size;
+}
+
+void Renderer::SubmitMinimap(const MinimapDesc& desc)
+{
+	if (!m_minimap.GetTexture())
+		return;
+
+	SpriteCommand sprite;
+	sprite.Position = {desc.X, desc.Y};
+	sprite.Size = glm::vec2(m_minimap.GetSizeInTiles()) * desc.TileSize;
+	sprite.Rotation = 0.0f;
+	sprite.UVs = {0.0f, 0.0f, 1.0f, 1.0f};
+	sprite.Color = {1.0f, 1.0f, 1.0f, desc.A};
+	sprite.AtlasID = MINIMAP_MATERIAL;
+
+	uint8_t layer = static_cast<uint8_t>(std::min(desc.Layer, 255u));
+	m_sprites.Submit(SpriteSortKey::Make(layer, static_cast<uint16_t>(MINIMAP_MATERIAL), SpriteSortKey::QuantizeDepth(desc.Depth)), sprite);
+	requestRedraw();
+}
+
+void Renderer::SetWorldOverview(bool enabled)
+{
+	if (m_worldOverview != enabled) {
+		m_worldOverview = enabled;
+		requestRedraw();
+	}
+}
+
+void Renderer::UpdateVisibility(int x, int y, uint32_t width, uint32_t height, const uint8_t* states)
+{
+	if (!m_visibility.IsInitialized()) {
+		SPDLOG_ERROR("Visibility updated before the world was initialized");
+		return;
+	}
+
+	m_visibility.UpdateRegion(x, y, width, height, states);
+	requestRedraw();
+}
+
+void Renderer::FillVisibility(uint8_t state)
+{
+	m_visibility.Fill(state);
+	requestRedraw();
+}
+
+void Renderer::SetVisibilityEnabled(bool enabled)
+{
+	m_visibility.SetEnabled(enabled);
+	requestRedraw();
+}
+
+glm::u8vec4 Renderer::tileColor(const RenderTile& tile)
+{
+	uint32_t slot = static_cast<uint32_t>(tile.TextureIndex);
+	TextureAtlas* atlas = slot < Renderer2D::MAX_TEXTURES ? m_renderer2D.AtlasSlots[slot] : nullptr;
+	if (!atlas)
+		return glm::u8vec4(255, 0, 255, 255);
+
+	const std::vector<glm::u8vec4>& colors = atlas->GetTileAverageColors();
+	int tileId = atlas->GetTileIdFromUV({tile.FrameSlotX + tile.FrameSlotW * 0.5f, tile.FrameSlotY + tile.FrameSlotH * 0.5f});
+	return tileId < (int)colors.size() ? colors[tileId] : glm::u8vec4(255, 0, 255, 255);
+}
+
+const Texture* Renderer::resolveTexture(uint32_t slot)
+{
+	if (slot == MINIMAP_MATERIAL)
+		return m_minimap.GetTexture();
+
+	if (slot >= FONT_MATERIAL_BASE && slot - FONT_MATERIAL_BASE < m_fonts.size())
+		return m_fonts[slot - FONT_MATERIAL_BASE]->GetTexture();
+
+	if (slot >= Renderer2D::MAX_TEXTURES)
+		return nullptr;
+
+	if (m_renderer2D.AtlasSlots[slot])
+		return &residentAtlasTexture(m_renderer2D.AtlasSlots[slot]);
+
+	return m_renderer2D.TextureSlots[slot].get();
+}
+
+const Texture& Renderer::residentAtlasTexture(TextureAtlas* atlas)
+{
+	if (m_textureResidency.Touch(atlas))
+		return atlas->GetTexture();
+
+	requestRedraw(); // Keep drawing until the reload lands
+	return *m_fallbackTexture;
+}
+
+TextureAtlas* Renderer::findOrLoadAtlas(const Filepath& path)
+{
+	for (const std::unique_ptr<TextureAtlas>& atlas : m_renderer2D.Atlases) {
+		if (atlas->GetPath() == path)
+			return atlas.get();
+	}
+
+	m_renderer2D.Atlases.push_back(std::make_unique<TextureAtlas>(path));
+	TextureAtlas* atlas = m_renderer2D.Atlases.back().get();
+	m_textureResidency.Register(atlas);
+	return atlas;
 }
 
 uint32_t Renderer::LoadAndAddTextureAtlas(const char* path)
@@ -172,11 +490,8 @@ uint32_t Renderer::LoadAndAddTextureAtlas(const char* path)
 		return 0;
 	}
 
-	auto atlas = std::make_unique<TextureAtlas>(path);
-	TextureAtlas* atlasPtr = atlas.get();
-	m_renderer2D.Atlases.push_back(std::move(atlas));
-
-	return AddTextureAtlas(atlasPtr);
+	// Loading the same file twice hands back its existing slot
+	return AddTextureAtlas(findOrLoadAtlas(path));
 }
 
 uint32_t Renderer::AddTextureAtlas(TextureAtlas* atlas)
@@ -253,10 +568,7 @@ void Renderer::DrawTilemapData(const TilemapData& tilemap)
 		return;
 	}
 
-	std::unique_ptr<TextureAtlas> atlas = std::make_unique<TextureAtlas>(tilemap.AtlasPath);
-	m_renderer2D.Atlases.push_back(std::move(atlas));
-
-	TextureAtlas* atlasPtr = m_renderer2D.Atlases.back().get();
+	TextureAtlas* atlasPtr = findOrLoadAtlas(tilemap.AtlasPath);
 	uint32_t atlasSlot = AddTextureAtlas(atlasPtr);
 
 	int tileIndex = 0;
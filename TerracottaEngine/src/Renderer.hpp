@@ -5,10 +5,21 @@
 #include "Subsystem.hpp"
 #include "CameraSystem.hpp"
 #include "ShaderProgram.hpp"
+#include "ShaderHotReload.hpp"
+#include "RenderGraph.hpp"
 #include "VertexInput.hpp"
 #include "Textures.hpp"
+#include "TextureResidency.hpp"
 #include "Window.hpp"
 #include "RenderProxy.hpp"
+#include "DebugDraw.hpp"
+#include "ParticleSystem.hpp"
+#include "SpriteQueue.hpp"
+#include "LightRenderer.hpp"
+#include "SDFFont.hpp"
+#include "Minimap.hpp"
+#include "VisibilityMask.hpp"
+#include "FrameScheduler.hpp"
 #include "SharedDataTypes.h"
 
 namespace TerracottaEngine
@@ -59,14 +70,32 @@ public:
 	void BeginBatch();
 	void EndBatch();
 	void Flush();
-	void OnRender();
+	void OnRender(const float alpha = 1.0f);
 
 	// Game API
 	void InitChunkProxies(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks);
-	void UpdateChunkTiles(uint32_t chunkX, uint32_t chunkY, const RenderTile* tiles, uint32_t tileCount);
+	void UpdateChunkTiles(int32_t chunkX, int32_t chunkY, const RenderTile* tiles, uint32_t tileCount);
+	void RemoveChunkTiles(int32_t chunkX, int32_t chunkY);
 	uint32_t LoadAndAddTextureAtlas(const char* path);
+	void SetTextureBudget(size_t budgetBytes) { m_textureResidency.SetBudget(budgetBytes); }
 	int GetAtlasInfo(uint32_t atlasId, AtlasInfo* outInfo);
 	void GetTileUVs(uint32_t atlasId, uint32_t tileId, UVData* outData);
+	void EmitParticles(const ParticleEmitDesc& desc);
+	void SubmitSprite(const SpriteDesc& desc);
+	void SubmitLight(const LightDesc& desc);
+	uint32_t LoadFont(const char* path);
+	void SubmitText(const TextDesc& desc);
+	float MeasureText(uint32_t fontId, const char* text, float size);
+	void SubmitMinimap(const MinimapDesc& desc);
+	// Replaces the per-chunk tile pass with one minimap quad over the world
+	void SetWorldOverview(bool enabled);
+	void UpdateVisibility(int x, int y, uint32_t width, uint32_t height, const uint8_t* states);
+	void FillVisibility(uint8_t state);
+	void SetVisibilityEnabled(bool enabled);
+	void SetAmbientLight(float r, float g, float b);
+	DebugDraw& GetDebugDraw() { return m_debugDraw; }
+	const Camera& GetCamera() const { return m_camera; }
+	const RenderGraph& GetRenderGraph() const { return m_renderGraph; }
 
 	// Legacy/Debug
 	void DrawTilemapData(const TilemapData& tilemap);
@@ -75,9 +104,32 @@ public:
 	void DrawQuad(const glm::vec3& position3D, float theta = 0.0f, const glm::vec2& scale = {1.0f, 1.0f}, const glm::vec4& color = {1.0f, 1.0f, 1.0f, 1.0f}, float index = 0.0f);
 	void DrawQuad(const glm::mat4& transform, const glm::vec4& color, float index);
 private:
+	static constexpr uint32_t FONT_MATERIAL_BASE = Renderer2D::MAX_TEXTURES;
+	static constexpr uint32_t MINIMAP_MATERIAL = 0xFFFF; // Last sort key material
+
 	Window* m_appWindow = nullptr;
 	Camera m_camera;
 	Renderer2D m_renderer2D;
+	ShaderHotReloader m_shaderReloader;
+	RenderGraph m_renderGraph;
+	TextureResidency m_textureResidency; // Atlases past the VRAM budget are evicted LRU and reloaded on use
+	std::unique_ptr<Texture> m_fallbackTexture = nullptr; // Bound in place of an atlas that is still reloading
+	SpriteQueue m_sprites;
+	std::vector<std::unique_ptr<SDFFont>> m_fonts; // Glyphs share the sprite stream as material FONT_MATERIAL_BASE + ID
+	Minimap m_minimap;
+	VisibilityMask m_visibility;
+	bool m_worldOverview = false;
+	LightRenderer m_lights;
+	ParticleSystem m_particles;
+	DebugDraw m_debugDraw;
+
+	void uploadDefaultShaderUniforms(ShaderProgram& shader);
+	void requestRedraw();
+	void renderWorld(const glm::mat4& view);
+	const Texture* resolveTexture(uint32_t slot);
+	const Texture& residentAtlasTexture(TextureAtlas* atlas);
+	TextureAtlas* findOrLoadAtlas(const Filepath& path);
+	glm::u8vec4 tileColor(const RenderTile& tile);
 
 	bool is2DVBOFull(uint32_t addVertex) const { return m_renderer2D.VertexCount + addVertex > Renderer2D::MAX_VERTICES; }
 	bool is2DTexturesFull() const { return m_renderer2D.TextureSlotIndex >= Renderer2D::MAX_TEXTURES; }
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <fstream>
+#include "spdlog/spdlog.h"
+#include "SDFFont.hpp"
+
+namespace TerracottaEngine
+{
+static constexpr uint32_t SDF_CACHE_MAGIC = 0x46445354; // "TSDF"
+static constexpr uint32_t SDF_CACHE_VERSION = 1;
+static constexpr int ATLAS_WIDTH = 512;
+
+struct SDFCacheHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	float PixelHeight;
+	int32_t Padding;
+	int32_t GlyphCount;
+	int32_t Width;
+	int32_t Height;
+};
+
+SDFFont::SDFFont()
+{}
+SDFFont::~SDFFont()
+{}
+
+bool SDFFont::Load(const Filepath& fontPath)
+{
+	std::ifstream file(fontPath, std::ios::binary | std::ios::ate);
+	if (!file) {
+		SPDLOG_ERROR("Failed to open font file at \"{}\".", fontPath.string());
+		return false;
+	}
+
+	m_fontData.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(m_fontData.data()), m_fontData.size());
+
+	if (!stbtt_InitFont(&m_fontInfo, m_fontData.data(), stbtt_GetFontOffsetForIndex(m_fontData.data(), 0))) {
+		SPDLOG_ERROR("\"{}\" is not a valid TrueType font.", fontPath.string());
+		return false;
+	}
+
+	m_scale = stbtt_ScaleForPixelHeight(&m_fontInfo, PIXEL_HEIGHT);
+	int ascent, descent, lineGap;
+	stbtt_GetFontVMetrics(&m_fontInfo, &ascent, &descent, &lineGap);
+	m_lineHeight = (ascent - descent + lineGap) * m_scale / PIXEL_HEIGHT;
+
+	// Generating the distance field is the slow part, reuse it unless the font changed
+	Filepath cachePath = fontPath;
+	cachePath += ".sdf";
+	std::vector<unsigned char> pixels;
+	int width = 0, height = 0;
+
+	std::error_code ec;
+	bool cacheFresh = std::filesystem::exists(cachePath, ec) && std::filesystem::last_write_time(cachePath, ec) >= std::filesystem::last_write_time(fontPath, ec);
+	if (cacheFresh && readAtlasCache(cachePath, pixels, width, height)) {
+		SPDLOG_INFO("Loaded cached SDF atlas for \"{}\" ({}x{})", fontPath.string(), width, height);
+	} else {
+		if (!generateAtlas(pixels, width, height))
+			return false;
+
+		SPDLOG_INFO("Generated SDF atlas for \"{}\" ({}x{})", fontPath.string(), width, height);
+		writeAtlasCache(cachePath, pixels, width, height);
+	}
+
+	m_texture = std::make_unique<Texture>(width, height, GL_R8, GL_RED, pixels.data(), GL_LINEAR);
+	m_runCache.clear();
+	return true;
+}
+
+const GlyphRun& SDFFont::Layout(std::string_view text)
+{
+	auto it = m_runCache.find(std::string(text));
+	if (it != m_runCache.end())
+		return it->second;
+
+	// Changing strings (timers, damage numbers) would grow this forever
+	if (m_runCache.size() >= MAX_CACHED_RUNS) {
+		m_runCache.clear();
+	}
+
+	GlyphRun run;
+	run.Quads.reserve(text.size());
+	glm::vec2 pen = {0.0f, 0.0f};
+	char previous = 0;
+	for (char c : text) {
+		if (c == '\n') {
+			pen = {0.0f, pen.y - m_lineHeight};
+			previous = 0;
+			continue;
+		}
+		if (c < FIRST_CHAR || c > LAST_CHAR) {
+			c = '?';
+		}
+
+		const Glyph& glyph = m_glyphs[c - FIRST_CHAR];
+		if (previous) {
+			pen.x += kerning(previous, c);
+		}
+		if (glyph.Size.x > 0.0f) {
+			run.Quads.push_back({pen + glyph.Offset, glyph.Size, glyph.UVs});
+		}
+
+		pen.x += glyph.Advance;
+		run.Width = std::max(run.Width, pen.x);
+		previous = c;
+	}
+
+	return m_runCache.emplace(std::string(text), std::move(run)).first->second;
+}
+
+bool SDFFont::generateAtlas(std::vector<unsigned char>& outPixels, int& outWidth, int& outHeight)
+{
+	struct GlyphBitmap
+	{
+		unsigned char* Pixels = nullptr;
+		int Width = 0, Height = 0, OffsetX = 0, OffsetY = 0;
+		int AtlasX = 0, AtlasY = 0;
+	};
+	std::array<GlyphBitmap, GLYPH_COUNT> bitmaps;
+
+	// Distance is 0.5 on the edge and falls off over SDF_PADDING texels
+	const float distanceScale = 128.0f / SDF_PADDING;
+	int penX = 0, penY = 0, rowHeight = 0;
+	for (int i = 0; i < GLYPH_COUNT; i++) {
+		GlyphBitmap& bitmap = bitmaps[i];
+		bitmap.Pixels = stbtt_GetCodepointSDF(&m_fontInfo, m_scale, FIRST_CHAR + i, SDF_PADDING, 128, distanceScale, &bitmap.Width, &bitmap.Height, &bitmap.OffsetX, &bitmap.OffsetY);
+		if (!bitmap.Pixels)
+			continue; // Whitespace
+
+		// Shelf packing, one texel gap so linear filtering never picks up a neighbour
+		if (penX + bitmap.Width > ATLAS_WIDTH) {
+			penX = 0;
+			penY += rowHeight + 1;
+			rowHeight = 0;
+		}
+		bitmap.AtlasX = penX;
+		bitmap.AtlasY = penY;
+		penX += bitmap.Width + 1;
+		rowHeight = std::max(rowHeight, bitmap.Height);
+	}
+
+	outWidth = ATLAS_WIDTH;
+	outHeight = 1;
+	while (outHeight < penY + rowHeight) {
+		outHeight *= 2;
+	}
+	outPixels.assign(static_cast<size_t>(outWidth) * outHeight, 0);
+
+	for (int i = 0; i < GLYPH_COUNT; i++) {
+		const GlyphBitmap& bitmap = bitmaps[i];
+		Glyph& glyph = m_glyphs[i];
+
+		int advance, leftBearing;
+		stbtt_GetCodepointHMetrics(&m_fontInfo, FIRST_CHAR + i, &advance, &leftBearing);
+		glyph.Advance = advance * m_scale / PIXEL_HEIGHT;
+		if (!bitmap.Pixels) {
+			glyph.Offset = glyph.Size = {0.0f, 0.0f};
+			glyph.UVs = {0.0f, 0.0f, 0.0f, 0.0f};
+			continue;
+		}
+
+		for (int row = 0; row < bitmap.Height; row++) {
+			std::copy_n(bitmap.Pixels + row * bitmap.Width, bitmap.Width, outPixels.data() + (bitmap.AtlasY + row) * outWidth + bitmap.AtlasX);
+		}
+		stbtt_FreeSDF(bitmap.Pixels, nullptr);
+
+		// Bitmap rows go top-down and row 0 is uploaded at V = 0, so the glyph's bottom has the larger V
+		glyph.Offset = glm::vec2(bitmap.OffsetX, -(bitmap.OffsetY + bitmap.Height)) / PIXEL_HEIGHT;
+		glyph.Size = glm::vec2(bitmap.Width, bitmap.Height) / PIXEL_HEIGHT;
+		glyph.UVs = {
+			float(bitmap.AtlasX) / outWidth, float(bitmap.AtlasY + bitmap.Height) / outHeight,
+			float(bitmap.AtlasX + bitmap.Width) / outWidth, float(bitmap.AtlasY) / outHeight
+		};
+	}
+
+	return true;
+}
+
+bool SDFFont::readAtlasCache(const Filepath& cachePath, std::vector<unsigned char>& outPixels, int& outWidth, int& outHeight)
+{
+	std::ifstream file(cachePath, std::ios::binary);
+	SDFCacheHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+
+	if (header.Magic != SDF_CACHE_MAGIC || header.Version != SDF_CACHE_VERSION || header.PixelHeight != PIXEL_HEIGHT ||
+		header.Padding != SDF_PADDING || header.GlyphCount != GLYPH_COUNT || header.Width <= 0 || header.Height <= 0) {
+		SPDLOG_WARN("Ignoring stale SDF cache at \"{}\"", cachePath.string());
+		return false;
+	}
+
+	outWidth = header.Width;
+	outHeight = header.Height;
+	outPixels.resize(static_cast<size_t>(outWidth) * outHeight);
+	file.read(reinterpret_cast<char*>(m_glyphs.data()), sizeof(Glyph) * GLYPH_COUNT);
+	file.read(reinterpret_cast<char*>(outPixels.data()), outPixels.size());
+	return static_cast<bool>(file);
+}
+
+void SDFFont::writeAtlasCache(const Filepath& cachePath, const std::vector<unsigned char>& pixels, int width, int height) const
+{
+	std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		SPDLOG_WARN("Could not write SDF cache to \"{}\", it will be regenerated next run", cachePath.string());
+		return;
+	}
+
+	SDFCacheHeader header = {SDF_CACHE_MAGIC, SDF_CACHE_VERSION, PIXEL_HEIGHT, SDF_PADDING, GLYPH_COUNT, width, height};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(m_glyphs.data()), sizeof(Glyph) * GLYPH_COUNT);
+	file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+}
+
+float SDFFont::kerning(char previous, char current) const
+{
+	return stbtt_GetCodepointKernAdvance(&m_fontInfo, previous, current) * m_scale / PIXEL_HEIGHT;
+}
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "glm/glm.hpp"
+#include "stb/stb_truetype.h"
+#include "Textures.hpp"
+
+namespace TerracottaEngine
+{
+struct GlyphQuad
+{
+	glm::vec2 Offset; // Bottom-left, relative to the run origin (first baseline), in ems
+	glm::vec2 Size; // In ems
+	glm::vec4 UVs; // MinU, MinV, MaxU, MaxV
+};
+
+// A laid out string at 1 em, scaled and translated when submitted
+struct GlyphRun
+{
+	std::vector<GlyphQuad> Quads;
+	float Width = 0.0f; // Widest line, in ems
+};
+
+// Signed-distance-field font for printable ASCII. The atlas is generated with stb_truetype on first load and cached
+// next to the font as "<font>.sdf", so later runs only read the TTF for metrics and kerning.
+// Distances are stored around 0.5 in a single channel so glyphs stay sharp at any scale with linear filtering.
+class SDFFont
+{
+public:
+	SDFFont();
+	~SDFFont();
+
+	bool Load(const Filepath& fontPath);
+
+	// Layouts are cached per string, static labels only pay for layout once
+	const GlyphRun& Layout(std::string_view text);
+	float MeasureWidth(std::string_view text) { return Layout(text).Width; }
+
+	const Texture* GetTexture() const { return m_texture.get(); }
+	float GetLineHeight() const { return m_lineHeight; }
+private:
+	static constexpr int FIRST_CHAR = 32;
+	static constexpr int LAST_CHAR = 126;
+	static constexpr int GLYPH_COUNT = LAST_CHAR - FIRST_CHAR + 1;
+	static constexpr float PIXEL_HEIGHT = 48.0f; // Size the distance field is generated at
+	static constexpr int SDF_PADDING = 6; // Texels of distance around each glyph
+	static constexpr size_t MAX_CACHED_RUNS = 4096;
+
+	struct Glyph
+	{
+		glm::vec2 Offset; // Bottom-left relative to the pen, in ems
+		glm::vec2 Size; // In ems
+		glm::vec4 UVs;
+		float Advance; // In ems
+	};
+
+	std::vector<unsigned char> m_fontData; // stbtt_fontinfo points into this
+	stbtt_fontinfo m_fontInfo = {};
+	float m_scale = 0.0f; // Font units -> pixels at PIXEL_HEIGHT
+	float m_lineHeight = 0.0f; // In ems
+
+	std::array<Glyph, GLYPH_COUNT> m_glyphs = {};
+	std::unique_ptr<Texture> m_texture = nullptr;
+	std::unordered_map<std::string, GlyphRun> m_runCache;
+
+	bool generateAtlas(std::vector<unsigned char>& outPixels, int& outWidth, int& outHeight);
+	bool readAtlasCache(const Filepath& cachePath, std::vector<unsigned char>& outPixels, int& outWidth, int& outHeight);
+	void writeAtlasCache(const Filepath& cachePath, const std::vector<unsigned char>& pixels, int width, int height) const;
+	float kerning(char previous, char current) const;
+};
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "spdlog/spdlog.h"
+#include "ShaderHotReload.hpp"
+
+namespace TerracottaEngine
+{
+ShaderHotReloader::ShaderHotReloader()
+{}
+ShaderHotReloader::~ShaderHotReloader()
+{}
+
+void ShaderHotReloader::Watch(std::unique_ptr<ShaderProgram>& target, ShaderSwapFunc onSwap)
+{
+	if (!target) {
+		SPDLOG_ERROR("Cannot watch a null shader program!");
+		return;
+	}
+
+	WatchedProgram watched;
+	watched.Target = &target;
+	watched.OnSwap = std::move(onSwap);
+	watched.VertexWriteTime = getWriteTime(target->GetVertexPath());
+	watched.FragmentWriteTime = getWriteTime(target->GetFragmentPath());
+	m_watched.push_back(std::move(watched));
+
+	SPDLOG_INFO("Watching \"{}\" and \"{}\" for changes.", target->GetVertexPath().filename().string(), target->GetFragmentPath().filename().string());
+}
+
+void ShaderHotReloader::Update(const float deltaTime)
+{
+	// Pending builds are checked every frame, the file system only every so often
+	pollPendingBuilds();
+
+	m_pollTimer += deltaTime;
+	if (m_pollTimer >= m_pollInterval) {
+		m_pollTimer = 0.0f;
+		checkForChanges();
+	}
+}
+
+ShaderHotReloader::FileTime ShaderHotReloader::getWriteTime(const std::filesystem::path& path)
+{
+	// Editors briefly delete/rename files while saving, so errors are expected here
+	std::error_code error;
+	FileTime writeTime = std::filesystem::last_write_time(path, error);
+	return error ? FileTime::min() : writeTime;
+}
+
+void ShaderHotReloader::checkForChanges()
+{
+	for (WatchedProgram& watched : m_watched) {
+		ShaderProgram& live = **watched.Target;
+		FileTime vertexTime = getWriteTime(live.GetVertexPath());
+		FileTime fragmentTime = getWriteTime(live.GetFragmentPath());
+		if (vertexTime == FileTime::min() || fragmentTime == FileTime::min())
+			continue;
+		if (vertexTime == watched.VertexWriteTime && fragmentTime == watched.FragmentWriteTime)
+			continue;
+
+		// A newer save supersedes whatever is still compiling
+		watched.VertexWriteTime = vertexTime;
+		watched.FragmentWriteTime = fragmentTime;
+		watched.Pending = std::make_unique<ShaderProgram>();
+		if (!watched.Pending->BeginBuild(live.GetVertexPath(), live.GetFragmentPath())) {
+			SPDLOG_ERROR("Failed to start rebuilding \"{}\" and \"{}\", keeping the current program.", live.GetVertexPath().filename().string(), live.GetFragmentPath().filename().string());
+			watched.Pending.reset();
+			continue;
+		}
+
+		SPDLOG_INFO("Rebuilding \"{}\" and \"{}\"...", live.GetVertexPath().filename().string(), live.GetFragmentPath().filename().string());
+	}
+}
+
+void ShaderHotReloader::pollPendingBuilds()
+{
+	for (WatchedProgram& watched : m_watched) {
+		if (!watched.Pending)
+			continue;
+
+		switch (watched.Pending->PollBuild()) {
+		case ShaderBuildStatus::Pending:
+			break;
+		case ShaderBuildStatus::Succeeded:
+			// The old program is deleted here, it is no longer referenced by any draw on this thread
+			watched.Target->swap(watched.Pending);
+			watched.Pending.reset();
+			if (watched.OnSwap) {
+				watched.OnSwap(**watched.Target);
+			}
+			SPDLOG_INFO("Hot reloaded \"{}\" and \"{}\".", (*watched.Target)->GetVertexPath().filename().string(), (*watched.Target)->GetFragmentPath().filename().string());
+			break;
+		case ShaderBuildStatus::Failed:
+		default:
+			SPDLOG_WARN("Shader rebuild failed, keeping the current program.");
+			watched.Pending.reset();
+			break;
+		}
+	}
+}
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "ShaderProgram.hpp"
+
+namespace TerracottaEngine
+{
+using ShaderSwapFunc = std::function<void(ShaderProgram&)>;
+
+// Polls the source files of registered programs and rebuilds them without stalling the frame.
+// The live program is only replaced once the new one has linked, so a typo never leaves the renderer without a shader.
+class ShaderHotReloader
+{
+public:
+	ShaderHotReloader();
+	~ShaderHotReloader();
+
+	// target must outlive the reloader. onSwap is called right after a swap so uniforms can be re-uploaded.
+	void Watch(std::unique_ptr<ShaderProgram>& target, ShaderSwapFunc onSwap);
+	void Update(const float deltaTime);
+private:
+	using FileTime = std::filesystem::file_time_type;
+
+	struct WatchedProgram
+	{
+		std::unique_ptr<ShaderProgram>* Target = nullptr;
+		ShaderSwapFunc OnSwap = nullptr;
+		FileTime VertexWriteTime, FragmentWriteTime;
+		std::unique_ptr<ShaderProgram> Pending = nullptr; // Build in flight
+	};
+
+	std::vector<WatchedProgram> m_watched;
+	float m_pollTimer = 0.0f;
+	const float m_pollInterval = 0.5f;
+
+	static FileTime getWriteTime(const std::filesystem::path& path);
+	void checkForChanges();
+	void pollPendingBuilds();
+};
+} // namespace TerracottaEngine
\ No newline at end of file
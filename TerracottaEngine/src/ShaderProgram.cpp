@@ -1,18 +1,72 @@
 #include <fstream>
+#include <sstream>
+#include <vector>
 #include <glm/glm.hpp>
+#define GLFW_INCLUDE_NONE
+#include "GLFW/glfw3.h"
 #include "glm/gtc/type_ptr.hpp"
 #include "spdlog/spdlog.h"
 #include "ShaderProgram.hpp"
 
+// glad is generated without extensions, so GL_KHR_parallel_shader_compile is loaded by hand
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace TerracottaEngine
 {
+using PFNGLMAXSHADERCOMPILERTHREADSKHRPROC = void (*)(GLuint count);
+
+// Without the extension we wait a few frames before asking for the status, most drivers will have finished by then
+static constexpr uint32_t DEFERRED_STATUS_POLLS = 3;
+
+static std::string readShaderFile(const std::filesystem::path& shader)
+{
+	std::ifstream shaderFileStream(shader, std::ios_base::in);
+	if (!shaderFileStream.is_open()) {
+		SPDLOG_ERROR("Could not open the shader file \"{}\" found in \"{}\"", shader.filename().string(), shader.parent_path().string());
+		return {};
+	}
+
+	std::stringstream sstr;
+	sstr << shaderFileStream.rdbuf();
+	return sstr.str();
+}
+
 ShaderProgram::ShaderProgram()
 {
 	m_id = glCreateProgram();
 }
 
+void ShaderProgram::QueryParallelCompileSupport()
+{
+	GLint extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+	for (GLint i = 0; i < extensionCount; i++) {
+		const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+		if (extension && std::string_view(extension) == "GL_KHR_parallel_shader_compile") {
+			s_parallelCompile = true;
+			break;
+		}
+	}
+
+	if (s_parallelCompile) {
+		// 0xFFFFFFFF lets the driver pick how many compiler threads it wants
+		auto maxThreadsFn = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+		if (maxThreadsFn) {
+			maxThreadsFn(0xFFFFFFFF);
+		}
+		SPDLOG_INFO("GL_KHR_parallel_shader_compile is supported, shader rebuilds will not block.");
+	} else {
+		SPDLOG_INFO("GL_KHR_parallel_shader_compile is not supported, falling back to deferred status polling.");
+	}
+}
+
 void ShaderProgram::InitializeShaderProgram(const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader)
 {
+	m_vertexPath = vertexShader;
+	m_fragmentPath = fragmentShader;
+
 	GLuint vShaderID = compileShader(GL_VERTEX_SHADER, vertexShader);
 	GLuint fShaderID = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
@@ -21,14 +75,7 @@ void ShaderProgram::InitializeShaderProgram(const std::filesystem::path& vertexS
 	glAttachShader(m_id, fShaderID);
 	glLinkProgram(m_id);
 
-	GLint linkStatus, infoLogLength;
-	glGetProgramiv(m_id, GL_LINK_STATUS, &linkStatus);
-	glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (linkStatus == GL_FALSE) {
-		std::vector<GLchar> linkErrMsg(infoLogLength);
-		glGetProgramInfoLog(m_id, infoLogLength, &infoLogLength, linkErrMsg.data());
-		SPDLOG_ERROR("\"{}\" and \"{}\" have failed to link: {}", vertexShader.filename().string(), fragmentShader.filename().string(), linkErrMsg.data());
-	} else {
+	if (checkProgram()) {
 		SPDLOG_INFO("\"{}\" and \"{}\" have linked successfully!", vertexShader.filename().string(), fragmentShader.filename().string());
 	}
 
@@ -40,7 +87,86 @@ void ShaderProgram::InitializeShaderProgram(const std::filesystem::path& vertexS
 	glUseProgram(m_id);
 }
 
+void ShaderProgram::InitializeComputeProgram(const std::filesystem::path& computeShader)
+{
+	m_computePath = computeShader;
+
+	GLuint cShaderID = compileShader(GL_COMPUTE_SHADER, computeShader);
+	glAttachShader(m_id, cShaderID);
+	glLinkProgram(m_id);
+
+	if (checkProgram()) {
+		SPDLOG_INFO("\"{}\" has linked successfully!", computeShader.filename().string());
+	}
+
+	glDeleteShader(cShaderID);
+}
+
+bool ShaderProgram::BeginBuild(const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader)
+{
+	if (m_buildStatus == ShaderBuildStatus::Pending) {
+		SPDLOG_WARN("A build is already pending for \"{}\" and \"{}\"", m_vertexPath.filename().string(), m_fragmentPath.filename().string());
+		return false;
+	}
+
+	m_vertexPath = vertexShader;
+	m_fragmentPath = fragmentShader;
+
+	m_pendingVertexID = submitShader(GL_VERTEX_SHADER, vertexShader);
+	m_pendingFragmentID = submitShader(GL_FRAGMENT_SHADER, fragmentShader);
+	if (!m_pendingVertexID || !m_pendingFragmentID) {
+		releasePendingShaders();
+		m_buildStatus = ShaderBuildStatus::Failed;
+		return false;
+	}
+
+	// Linking straight away is fine, the driver chains it after the compiles
+	glAttachShader(m_id, m_pendingVertexID);
+	glAttachShader(m_id, m_pendingFragmentID);
+	glLinkProgram(m_id);
+
+	m_pendingPolls = 0;
+	m_buildStatus = ShaderBuildStatus::Pending;
+	return true;
+}
+
+ShaderBuildStatus ShaderProgram::PollBuild()
+{
+	if (m_buildStatus != ShaderBuildStatus::Pending)
+		return m_buildStatus;
+
+	if (s_parallelCompile) {
+		GLint completed = GL_FALSE;
+		glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &completed);
+		if (completed == GL_FALSE)
+			return ShaderBuildStatus::Pending;
+	} else if (++m_pendingPolls < DEFERRED_STATUS_POLLS) {
+		return ShaderBuildStatus::Pending;
+	}
+
+	// Only query the compile logs when the link failed, the link status already covers both shaders
+	bool linked = checkProgram();
+	if (!linked) {
+		checkShader(m_pendingVertexID, m_vertexPath);
+		checkShader(m_pendingFragmentID, m_fragmentPath);
+	}
+	releasePendingShaders();
+
+	m_buildStatus = linked ? ShaderBuildStatus::Succeeded : ShaderBuildStatus::Failed;
+	return m_buildStatus;
+}
+
 GLuint ShaderProgram::compileShader(GLuint type, const std::filesystem::path& shader)
+{
+	GLuint shaderID = submitShader(type, shader);
+	if (shaderID && checkShader(shaderID, shader)) {
+		SPDLOG_INFO("\"{}\" has compiled successfully!", shader.filename().string());
+	}
+
+	return shaderID;
+}
+
+GLuint ShaderProgram::submitShader(GLuint type, const std::filesystem::path& shader)
 {
 	// Ensure path is valid
 	if (!std::filesystem::exists(shader)) {
@@ -48,46 +174,73 @@ GLuint ShaderProgram::compileShader(GLuint type, const std::filesystem::path& sh
 		return 0;
 	}
 
-	GLuint shaderID;
 	switch (type) {
 	case GL_VERTEX_SHADER:
 	case GL_FRAGMENT_SHADER:
-		shaderID = glCreateShader(type);
+	case GL_COMPUTE_SHADER:
 		break;
 	default:
 		SPDLOG_ERROR("Invalid shader type with the value {} entered!", type);
 		return 0;
 	}
 
-	std::string shaderCode;
-	std::ifstream shaderFileStream(shader, std::ios_base::in);
-	if (shaderFileStream.is_open()) {
-		std::stringstream sstr;
-		sstr << shaderFileStream.rdbuf();
-		shaderCode = sstr.str();
-		shaderFileStream.close();
-	} else {
-		SPDLOG_ERROR("Could not open the shader file \"{}\" found in \"{}\"", shader.filename().string(), shader.parent_path().string());
+	std::string shaderCode = readShaderFile(shader);
+	if (shaderCode.empty())
 		return 0;
-	}
 
+	GLuint shaderID = glCreateShader(type);
 	const char* shaderFileContents = shaderCode.c_str();
 	glShaderSource(shaderID, 1, &shaderFileContents, nullptr);
 	glCompileShader(shaderID);
 
-	// Check compilation status afterwards
+	return shaderID;
+}
+
+bool ShaderProgram::checkShader(GLuint shaderID, const std::filesystem::path& shader)
+{
 	GLint shaderStatus, infoLogLength;
 	glGetShaderiv(shaderID, GL_COMPILE_STATUS, &shaderStatus);
 	glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &infoLogLength);
 	if (shaderStatus == GL_FALSE) {
-		std::vector<GLchar> compErrMsg(infoLogLength);
-		glGetProgramInfoLog(m_id, infoLogLength, &infoLogLength, compErrMsg.data());
+		std::vector<GLchar> compErrMsg(infoLogLength + 1);
+		glGetShaderInfoLog(shaderID, infoLogLength, &infoLogLength, compErrMsg.data());
 		SPDLOG_ERROR("\"{}\" has failed to compile: {}", shader.filename().string(), compErrMsg.data());
-	} else {
-		SPDLOG_INFO("\"{}\" has compiled successfully!", shader.filename().string());
+		return false;
 	}
+	return true;
+}
 
-	return shaderID;
+bool ShaderProgram::checkProgram()
+{
+	GLint linkStatus, infoLogLength;
+	glGetProgramiv(m_id, GL_LINK_STATUS, &linkStatus);
+	glGetProgramiv(m_id, GL_INFO_LOG_LENGTH, &infoLogLength);
+	if (linkStatus == GL_FALSE) {
+		std::vector<GLchar> linkErrMsg(infoLogLength + 1);
+		glGetProgramInfoLog(m_id, infoLogLength, &infoLogLength, linkErrMsg.data());
+		if (!m_computePath.empty()) {
+			SPDLOG_ERROR("\"{}\" has failed to link: {}", m_computePath.filename().string(), linkErrMsg.data());
+			return false;
+		}
+		SPDLOG_ERROR("\"{}\" and \"{}\" have failed to link: {}", m_vertexPath.filename().string(), m_fragmentPath.filename().string(), linkErrMsg.data());
+		return false;
+	}
+	return true;
+}
+
+void ShaderProgram::releasePendingShaders()
+{
+	// Deleting attached shaders only flags them, they are freed once detached
+	if (m_pendingVertexID) {
+		glDetachShader(m_id, m_pendingVertexID);
+		glDeleteShader(m_pendingVertexID);
+		m_pendingVertexID = 0;
+	}
+	if (m_pendingFragmentID) {
+		glDetachShader(m_id, m_pendingFragmentID);
+		glDeleteShader(m_pendingFragmentID);
+		m_pendingFragmentID = 0;
+	}
 }
 
 void ShaderProgram::UploadUniformInt(const std::string& uniformName, GLint value)
@@ -98,6 +251,30 @@ void ShaderProgram::UploadUniformInt(const std::string& uniformName, GLint value
 	}
 	glUniform1i(location, value);
 }
+void ShaderProgram::UploadUniformUInt(const std::string& uniformName, GLuint value)
+{
+	GLint location = glGetUniformLocation(m_id, uniformName.c_str());
+	if (location == -1) {
+		SPDLOG_ERROR("There is no uint uniform called \"{}\" in the shader program.", uniformName);
+	}
+	glUniform1ui(location, value);
+}
+void ShaderProgram::UploadUniformFloat(const std::string& uniformName, GLfloat value)
+{
+	GLint location = glGetUniformLocation(m_id, uniformName.c_str());
+	if (location == -1) {
+		SPDLOG_ERROR("There is no float uniform called \"{}\" in the shader program.", uniformName);
+	}
+	glUniform1f(location, value);
+}
+void ShaderProgram::UploadUniformVec2(const std::string& uniformName, const glm::vec2& vector)
+{
+	GLint location = glGetUniformLocation(m_id, uniformName.c_str());
+	if (location == -1) {
+		SPDLOG_ERROR("There is no vec2 uniform called \"{}\" in the shader program.", uniformName);
+	}
+	glUniform2fv(location, 1, glm::value_ptr(vector));
+}
 void ShaderProgram::UploadUniformIntArray(const std::string& uniformName, GLsizei count, const GLint* value)
 {
 	GLint location = glGetUniformLocation(m_id, uniformName.c_str());
@@ -1,11 +1,20 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
 #include "glad/glad.h"
 #include "glm/glm.hpp"
 
 namespace TerracottaEngine
 {
+enum class ShaderBuildStatus : uint8_t
+{
+	Idle,
+	Pending,
+	Succeeded,
+	Failed
+};
+
 class ShaderProgram
 {
 public:
@@ -13,16 +22,43 @@ public:
 	~ShaderProgram() { glDeleteProgram(m_id); }
 
 	void InitializeShaderProgram(const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader);
+	void InitializeComputeProgram(const std::filesystem::path& computeShader);
+
+	// Non-blocking build: submits compile + link without querying any status so the driver can work in the background.
+	// Call PollBuild() once per frame until it stops returning Pending.
+	bool BeginBuild(const std::filesystem::path& vertexShader, const std::filesystem::path& fragmentShader);
+	ShaderBuildStatus PollBuild();
 
 	void UploadUniformInt(const std::string& uniformName, GLint value);
+	void UploadUniformUInt(const std::string& uniformName, GLuint value);
+	void UploadUniformFloat(const std::string& uniformName, GLfloat value);
+	void UploadUniformVec2(const std::string& uniformName, const glm::vec2& vector);
 	void UploadUniformIntArray(const std::string& uniformName, GLsizei count, const GLint* value);
 	void UploadUniformMat4(const std::string& uniformName, const glm::mat4& matrix);
 
 	void Use() const { glUseProgram(m_id); }
 	void Deactivate() const { glUseProgram(0); }
 	GLuint GetID() const { return m_id; }
+	const std::filesystem::path& GetVertexPath() const { return m_vertexPath; }
+	const std::filesystem::path& GetFragmentPath() const { return m_fragmentPath; }
+
+	// GL_KHR_parallel_shader_compile support, queried once after the GL context exists
+	static void QueryParallelCompileSupport();
+	static bool IsParallelCompileSupported() { return s_parallelCompile; }
 private:
 	GLuint m_id = 0;
+	GLuint m_pendingVertexID = 0, m_pendingFragmentID = 0;
+	uint32_t m_pendingPolls = 0;
+	ShaderBuildStatus m_buildStatus = ShaderBuildStatus::Idle;
+	std::filesystem::path m_vertexPath, m_fragmentPath;
+	std::filesystem::path m_computePath;
+
+	static inline bool s_parallelCompile = false;
+
 	GLuint compileShader(GLuint type, const std::filesystem::path& shader);
+	GLuint submitShader(GLuint type, const std::filesystem::path& shader);
+	bool checkShader(GLuint shaderID, const std::filesystem::path& shader);
+	bool checkProgram();
+	void releasePendingShaders();
 };
 } // namespace TerracottaEngine
\ No newline at end of file
@@ -31,6 +31,69 @@ typedef struct UVData
 	float MaxV;
 } UVData;
 
+typedef struct DebugColor
+{
+	float R, G, B, A;
+} DebugColor;
+
+typedef struct ParticleEmitDesc
+{
+	float X, Y;
+	float VelocityX, VelocityY;
+	float Spread; // Random extra speed in any direction, units/second
+	float Lifetime; // Seconds, jittered by +-25%
+	float Size; // World units
+	float R, G, B, A;
+	uint32_t Count;
+} ParticleEmitDesc;
+
+typedef struct SpriteDesc
+{
+	float X, Y; // Bottom-left corner
+	float Width, Height;
+	float Rotation; // Radians, around the center
+	float Depth; // [0, 1], lower is drawn first within a layer
+	uint32_t Layer; // 0-255, lower is drawn first
+	uint32_t AtlasID;
+	uint32_t TileID;
+	float R, G, B, A;
+} SpriteDesc;
+
+typedef struct LightDesc
+{
+	float X, Y;
+	float Radius; // World units, light fades to zero here
+	float Intensity;
+	float R, G, B;
+} LightDesc;
+
+#define INVALID_FONT_ID 0xFFFFFFFF
+
+typedef struct TextDesc
+{
+	float X, Y; // Left end of the first baseline
+	float Size; // World units per em, lines are laid out downwards
+	float Depth; // [0, 1], lower is drawn first within a layer
+	uint32_t Layer; // 0-255, shared with sprites
+	uint32_t FontID;
+	float R, G, B, A;
+	const char* Text; // ASCII, '\n' starts a new line
+} TextDesc;
+
+typedef struct MinimapDesc
+{
+	float X, Y; // Bottom-left corner
+	float TileSize; // World units per tile, 1 overlays the world exactly
+	float Depth; // [0, 1], lower is drawn first within a layer
+	uint32_t Layer; // 0-255, shared with sprites
+	float A; // Opacity
+} MinimapDesc;
+
+// Per-tile fog of war states
+#define VISIBILITY_UNEXPLORED	0
+#define VISIBILITY_EXPLORED		1
+#define VISIBILITY_VISIBLE		2
+
 #define CHUNK_SIZE		16
 #define TILES_PER_CHUNK (CHUNK_SIZE * CHUNK_SIZE)
 
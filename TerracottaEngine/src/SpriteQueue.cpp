@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "spdlog/spdlog.h"
+#include "SpriteQueue.hpp"
+
+namespace TerracottaEngine
+{
+static constexpr uint32_t INVALID_ATLAS = 0xFFFFFFFF;
+static constexpr uint32_t RADIX_BITS = 8;
+static constexpr uint32_t RADIX_BUCKETS = 1 << RADIX_BITS;
+static constexpr uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+
+uint32_t SpriteSortKey::QuantizeDepth(float depth)
+{
+	return static_cast<uint32_t>(std::lround(std::clamp(depth, 0.0f, 1.0f) * float(0xFFFFFF)));
+}
+
+SpriteQueue::SpriteQueue()
+{}
+SpriteQueue::~SpriteQueue()
+{}
+
+bool SpriteQueue::Init()
+{
+	m_shader = std::make_unique<ShaderProgram>();
+	m_shader->InitializeShaderProgram("../../../../../TerracottaEngine/res/SpriteVert.glsl", "../../../../../TerracottaEngine/res/SpriteFrag.glsl");
+
+	UploadSamplers(*m_shader);
+
+	// Vertices are rewritten whenever the submissions change, the quad indices never
+	m_vao = std::make_unique<VertexArray>();
+	m_vbo = std::make_unique<BufferObject>(BufferUpdatePolicy::Orphan, BufferGrowPolicy::Double);
+	m_ebo = std::make_unique<BufferObject>(BufferUpdatePolicy::InPlace, BufferGrowPolicy::Exact);
+
+	m_vbo->Reserve(1024 * 4 * sizeof(SpriteVertex));
+	m_vao->AttachVertexBuffer(0, *m_vbo, sizeof(SpriteVertex));
+	m_vao->LinkAttribute(0, 0, 3, GL_FLOAT, offsetof(SpriteVertex, Position));
+	m_vao->LinkAttribute(1, 0, 2, GL_FLOAT, offsetof(SpriteVertex, TextureCoord));
+	m_vao->LinkAttribute(2, 0, 4, GL_FLOAT, offsetof(SpriteVertex, Color));
+	m_vao->LinkAttribute(3, 0, 1, GL_FLOAT, offsetof(SpriteVertex, TextureIndex));
+	m_vao->LinkAttribute(4, 0, 1, GL_FLOAT, offsetof(SpriteVertex, DistanceField));
+
+	// Every batch uses the same quad pattern, batches are offset with a base vertex
+	std::vector<uint32_t> indices(MAX_SPRITES_PER_BATCH * 6);
+	for (uint32_t i = 0; i < MAX_SPRITES_PER_BATCH; i++) {
+		uint32_t base = i * 4;
+		indices[i * 6 + 0] = base + 0;
+		indices[i * 6 + 1] = base + 1;
+		indices[i * 6 + 2] = base + 2;
+		indices[i * 6 + 3] = base + 2;
+		indices[i * 6 + 4] = base + 3;
+		indices[i * 6 + 5] = base + 0;
+	}
+	m_ebo->Upload(indices.data(), indices.size() * sizeof(uint32_t));
+	m_vao->AttachIndexBuffer(*m_ebo);
+
+	SPDLOG_INFO("Sprite queue initialized.");
+	return true;
+}
+void SpriteQueue::Shutdown()
+{
+	m_vao.reset();
+	m_vbo.reset();
+	m_ebo.reset();
+	m_shader.reset();
+	Clear();
+}
+
+void SpriteQueue::UploadSamplers(ShaderProgram& shader) const
+{
+	int samplers[MAX_TEXTURE_UNITS];
+	for (int i = 0; i < (int)MAX_TEXTURE_UNITS; i++) {
+		samplers[i] = i;
+	}
+
+	shader.Use();
+	shader.UploadUniformIntArray("u_textures", MAX_TEXTURE_UNITS, samplers);
+}
+
+void SpriteQueue::Submit(uint64_t sortKey, const SpriteCommand& sprite)
+{
+	m_entries.push_back({sortKey, static_cast<uint32_t>(m_commands.size())});
+	m_commands.push_back(sprite);
+	m_needsBuild = true;
+}
+
+void SpriteQueue::Clear()
+{
+	m_commands.clear();
+	m_entries.clear();
+	m_batches.clear();
+	m_needsBuild = false;
+}
+
+void SpriteQueue::Flush(const glm::mat4& view, const glm::mat4& projection, const TextureResolveFunc& resolveTexture)
+{
+	if (m_commands.empty())
+		return;
+
+	// Sort and build once per set of submissions, later frames just redraw the same batches
+	if (m_needsBuild) {
+		radixSort();
+		buildBatches();
+
+		if (m_vbo->Upload(m_vertices.data(), m_vertices.size() * sizeof(SpriteVertex))) {
+			m_vao->AttachVertexBuffer(0, *m_vbo, sizeof(SpriteVertex));
+		}
+		m_needsBuild = false;
+	}
+
+	m_vao->Bind();
+
+	m_shader->Use();
+	m_shader->UploadUniformMat4("u_view", view);
+	m_shader->UploadUniformMat4("u_projection", projection);
+
+	for (const SpriteBatch& batch : m_batches) {
+		for (uint32_t unit = 0; unit < batch.TextureCount; unit++) {
+			if (const Texture* texture = resolveTexture(batch.AtlasIDs[unit])) {
+				glActiveTexture(GL_TEXTURE0 + unit);
+				texture->Bind();
+			}
+		}
+
+		glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(batch.SpriteCount * 6), GL_UNSIGNED_INT, nullptr, static_cast<GLint>(batch.FirstSprite * 4));
+	}
+
+	m_vao->Unbind();
+}
+
+void SpriteQueue::radixSort()
+{
+	const size_t count = m_entries.size();
+	if (count < 2)
+		return;
+
+	// All histograms in one read of the keys
+	std::array<std::array<uint32_t, RADIX_BUCKETS>, RADIX_PASSES> histograms = {};
+	for (const SortEntry& entry : m_entries) {
+		for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+			histograms[pass][(entry.Key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+		}
+	}
+
+	m_scratch.resize(count);
+	SortEntry* src = m_entries.data();
+	SortEntry* dst = m_scratch.data();
+	for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+		const uint32_t shift = pass * RADIX_BITS;
+		std::array<uint32_t, RADIX_BUCKETS>& histogram = histograms[pass];
+
+		// Every key has the same digit here (unused key bits, single layer...), nothing to do
+		if (histogram[(src[0].Key >> shift) & (RADIX_BUCKETS - 1)] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for (uint32_t& bucket : histogram) {
+			uint32_t bucketCount = bucket;
+			bucket = offset;
+			offset += bucketCount;
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			dst[histogram[(src[i].Key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+		}
+		std::swap(src, dst);
+	}
+
+	if (src != m_entries.data()) {
+		m_entries.swap(m_scratch);
+	}
+}
+
+void SpriteQueue::buildBatches()
+{
+	m_batches.clear();
+	m_vertices.resize(m_entries.size() * 4);
+
+	SpriteBatch batch;
+	uint32_t currentAtlas = INVALID_ATLAS;
+	float currentUnit = 0.0f;
+	for (uint32_t i = 0; i < m_entries.size(); i++) {
+		const SpriteCommand& sprite = m_commands[m_entries[i].Index];
+
+		if (batch.SpriteCount == MAX_SPRITES_PER_BATCH) {
+			m_batches.push_back(batch);
+			batch = SpriteBatch();
+			batch.FirstSprite = i;
+			currentAtlas = INVALID_ATLAS;
+		}
+
+		// Sorted by material, so this only runs when the atlas actually changes
+		if (sprite.AtlasID != currentAtlas) {
+			uint32_t unit = 0;
+			while (unit < batch.TextureCount && batch.AtlasIDs[unit] != sprite.AtlasID) {
+				unit++;
+			}
+
+			if (unit == batch.TextureCount) {
+				if (batch.TextureCount == MAX_TEXTURE_UNITS) {
+					m_batches.push_back(batch);
+					batch = SpriteBatch();
+					batch.FirstSprite = i;
+					unit = 0;
+				}
+				batch.AtlasIDs[batch.TextureCount++] = sprite.AtlasID;
+			}
+
+			currentAtlas = sprite.AtlasID;
+			currentUnit = static_cast<float>(unit);
+		}
+
+		writeQuad(sprite, currentUnit, &m_vertices[i * 4]);
+		batch.SpriteCount++;
+	}
+
+	if (batch.SpriteCount > 0) {
+		m_batches.push_back(batch);
+	}
+}
+
+void SpriteQueue::writeQuad(const SpriteCommand& sprite, float textureUnit, SpriteVertex* out) const
+{
+	static constexpr glm::vec2 CORNERS[4] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+	const glm::vec2 uvs[4] = {{sprite.UVs.x, sprite.UVs.y}, {sprite.UVs.z, sprite.UVs.y}, {sprite.UVs.z, sprite.UVs.w}, {sprite.UVs.x, sprite.UVs.w}};
+
+	// 2D rotation instead of a full mat4 per sprite
+	const glm::vec2 center = sprite.Position + sprite.Size * 0.5f;
+	const float c = std::cos(sprite.Rotation);
+	const float s = std::sin(sprite.Rotation);
+	for (int i = 0; i < 4; i++) {
+		glm::vec2 local = CORNERS[i] * sprite.Size;
+		glm::vec2 rotated = {local.x * c - local.y * s, local.x * s + local.y * c};
+
+		out[i].Position = {center + rotated, 0.0f};
+		out[i].TextureCoord = uvs[i];
+		out[i].Color = sprite.Color;
+		out[i].TextureIndex = textureUnit;
+		out[i].DistanceField = sprite.DistanceField ? 1.0f : 0.0f;
+	}
+}
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "glm/glm.hpp"
+#include "ShaderProgram.hpp"
+#include "Textures.hpp"
+#include "VertexInput.hpp"
+
+namespace TerracottaEngine
+{
+struct SpriteVertex
+{
+	glm::vec3 Position; // X, Y, Z
+	glm::vec2 TextureCoord; // U, V
+	glm::vec4 Color; // R, G, B, A
+	float TextureIndex; // Texture unit within the batch
+	float DistanceField; // 1 when the texture is a signed distance field (text)
+};
+
+struct SpriteCommand
+{
+	glm::vec2 Position; // Bottom-left corner
+	glm::vec2 Size;
+	float Rotation; // Radians, around the center
+	glm::vec4 UVs; // MinU, MinV, MaxU, MaxV
+	glm::vec4 Color;
+	uint32_t AtlasID;
+	bool DistanceField = false;
+};
+
+// 64-bit sort key: | layer (8) | material/atlas (16) | depth (24) | unused (16) |
+// Draw order is layer first, then material so batches break as rarely as possible, then depth (lower first).
+// Equal keys keep their submission order since the radix sort is stable.
+namespace SpriteSortKey
+{
+constexpr uint64_t Make(uint8_t layer, uint16_t material, uint32_t depth24)
+{
+	return (uint64_t(layer) << 56) | (uint64_t(material) << 40) | (uint64_t(depth24 & 0xFFFFFF) << 16);
+}
+uint32_t QuantizeDepth(float depth); // [0, 1] -> 24 bits
+} // namespace SpriteSortKey
+
+using TextureResolveFunc = std::function<const Texture*(uint32_t atlasId)>;
+
+// Sprites are queued during the update and radix-sorted once before the next render, then cut into as few
+// batches as possible. A batch only breaks when it runs out of texture units or quads, never on submission order.
+class SpriteQueue
+{
+public:
+	SpriteQueue();
+	~SpriteQueue();
+
+	bool Init();
+	void Shutdown();
+
+	void Submit(uint64_t sortKey, const SpriteCommand& sprite);
+	void Clear();
+	void Flush(const glm::mat4& view, const glm::mat4& projection, const TextureResolveFunc& resolveTexture);
+
+	size_t GetSpriteCount() const { return m_commands.size(); }
+	size_t GetBatchCount() const { return m_batches.size(); }
+	std::unique_ptr<ShaderProgram>& GetShader() { return m_shader; }
+	// Batch texture units are bound to u_textures[0..31]
+	void UploadSamplers(ShaderProgram& shader) const;
+private:
+	static constexpr uint32_t MAX_SPRITES_PER_BATCH = 65536; // Big enough for thousands of text labels in one draw
+	static constexpr uint32_t MAX_TEXTURE_UNITS = 32;
+
+	struct SortEntry
+	{
+		uint64_t Key;
+		uint32_t Index; // Into m_commands
+	};
+
+	struct SpriteBatch
+	{
+		uint32_t FirstSprite = 0;
+		uint32_t SpriteCount = 0;
+		uint32_t TextureCount = 0;
+		std::array<uint32_t, MAX_TEXTURE_UNITS> AtlasIDs; // Texture unit -> atlas
+	};
+
+	std::unique_ptr<ShaderProgram> m_shader = nullptr;
+	std::unique_ptr<VertexArray> m_vao = nullptr;
+	std::unique_ptr<BufferObject> m_vbo = nullptr;
+	std::unique_ptr<BufferObject> m_ebo = nullptr;
+
+	std::vector<SpriteCommand> m_commands;
+	std::vector<SortEntry> m_entries, m_scratch;
+	std::vector<SpriteVertex> m_vertices;
+	std::vector<SpriteBatch> m_batches;
+	bool m_needsBuild = false;
+
+	void radixSort();
+	void buildBatches();
+	void writeQuad(const SpriteCommand& sprite, float textureUnit, SpriteVertex* out) const;
+};
+} // namespace TerracottaEngine
\ No newline at end of file
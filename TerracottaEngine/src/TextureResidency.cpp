@@ -0,0 +1,168 @@
+#include "spdlog/spdlog.h"
+#include "TextureResidency.hpp"
+
+namespace TerracottaEngine
+{
+TextureResidency::TextureResidency()
+{}
+TextureResidency::~TextureResidency()
+{
+	Shutdown();
+}
+
+bool TextureResidency::Init(size_t budgetBytes)
+{
+	m_budget = budgetBytes;
+	m_stopWorker = false;
+	m_worker = std::thread(&TextureResidency::workerLoop, this);
+
+	SPDLOG_INFO("Texture residency initialized with a {} MiB budget", m_budget / (1024 * 1024));
+	return true;
+}
+void TextureResidency::Shutdown()
+{
+	if (m_worker.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopWorker = true;
+		}
+		m_condition.notify_one();
+		m_worker.join();
+	}
+
+	m_jobs.clear();
+	m_results.clear();
+	m_entries.clear();
+}
+
+size_t TextureResidency::GetResidentBytes() const
+{
+	size_t total = 0;
+	for (const Entry& entry : m_entries) {
+		total += entry.Atlas->GetTexture().GetSizeInBytes();
+	}
+	return total;
+}
+
+void TextureResidency::Register(TextureAtlas* atlas)
+{
+	if (!atlas || findEntry(atlas))
+		return;
+
+	Entry entry;
+	entry.Atlas = atlas;
+	entry.LastUsedFrame = m_frame;
+	m_entries.push_back(entry);
+}
+
+bool TextureResidency::Touch(TextureAtlas* atlas)
+{
+	Entry* entry = findEntry(atlas);
+	if (!entry)
+		return atlas && atlas->GetTexture().IsResident();
+
+	entry->LastUsedFrame = m_frame;
+	if (atlas->GetTexture().IsResident())
+		return true;
+
+	if (!entry->Loading && !entry->Failed) {
+		entry->Loading = true;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back({static_cast<uint32_t>(entry - m_entries.data()), atlas});
+		}
+		m_condition.notify_one();
+	}
+	return false;
+}
+
+void TextureResidency::BeginFrame()
+{
+	m_frame++;
+	uploadFinishedLoads();
+	evictToBudget();
+}
+
+TextureResidency::Entry* TextureResidency::findEntry(const TextureAtlas* atlas)
+{
+	for (Entry& entry : m_entries) {
+		if (entry.Atlas == atlas)
+			return &entry;
+	}
+	return nullptr;
+}
+
+void TextureResidency::uploadFinishedLoads()
+{
+	std::vector<LoadResult> results;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		results.swap(m_results);
+	}
+
+	for (LoadResult& result : results) {
+		Entry& entry = m_entries[result.EntryIndex];
+		entry.Loading = false;
+		if (result.Chain.Levels.empty()) {
+			SPDLOG_ERROR("Failed to reload evicted texture \"{}\"", entry.Atlas->GetPath().string());
+			entry.Failed = true;
+			continue;
+		}
+
+		entry.Atlas->GetTexture().UploadMipChain(result.Chain);
+		SPDLOG_DEBUG("Reloaded texture \"{}\"", entry.Atlas->GetPath().string());
+	}
+}
+
+void TextureResidency::evictToBudget()
+{
+	size_t resident = GetResidentBytes();
+	while (resident > m_budget) {
+		// Least recently used, but never anything drawn last frame since it's about to be drawn again
+		Entry* victim = nullptr;
+		for (Entry& entry : m_entries) {
+			if (!entry.Atlas->GetTexture().IsResident() || entry.LastUsedFrame + 1 >= m_frame)
+				continue;
+			if (!victim || entry.LastUsedFrame < victim->LastUsedFrame) {
+				victim = &entry;
+			}
+		}
+
+		if (!victim) {
+			if (!m_warnedOverBudget) {
+				SPDLOG_WARN("Textures in use need {} MiB, over the {} MiB budget", resident / (1024 * 1024), m_budget / (1024 * 1024));
+				m_warnedOverBudget = true;
+			}
+			return;
+		}
+
+		resident -= victim->Atlas->GetTexture().GetSizeInBytes();
+		victim->Atlas->GetTexture().Release();
+		SPDLOG_DEBUG("Evicted texture \"{}\" (unused for {} frames)", victim->Atlas->GetPath().string(), m_frame - victim->LastUsedFrame);
+	}
+	m_warnedOverBudget = false;
+}
+
+void TextureResidency::workerLoop()
+{
+	while (true) {
+		LoadJob job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_stopWorker || !m_jobs.empty(); });
+			if (m_stopWorker)
+				return;
+
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		LoadResult result;
+		result.EntryIndex = job.EntryIndex;
+		result.Chain = job.Atlas->LoadMipChain();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_results.push_back(std::move(result));
+	}
+}
+} // namespace TerracottaEngine
\ No newline at end of file
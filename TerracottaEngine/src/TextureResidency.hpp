@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Textures.hpp"
+
+namespace TerracottaEngine
+{
+// Keeps atlas textures inside a VRAM budget. Every frame an atlas is drawn with it gets touched, and once the
+// resident total goes over budget the least recently used atlases are released. Their metadata (size, rows, UVs)
+// stays, so nothing on the game side changes. Touching an evicted atlas decodes it again on a worker thread and
+// re-uploads its mip chain at the start of a later frame, with a fallback texture bound meanwhile.
+class TextureResidency
+{
+public:
+	static constexpr size_t DEFAULT_BUDGET = 256ull * 1024 * 1024;
+
+	TextureResidency();
+	~TextureResidency();
+
+	bool Init(size_t budgetBytes = DEFAULT_BUDGET);
+	void Shutdown();
+
+	void SetBudget(size_t budgetBytes) { m_budget = budgetBytes; }
+	size_t GetBudget() const { return m_budget; }
+	size_t GetResidentBytes() const;
+
+	void Register(TextureAtlas* atlas);
+	// Marks the atlas as used this frame, returns false (and starts a reload) if it isn't resident right now
+	bool Touch(TextureAtlas* atlas);
+	// Call once per frame before drawing: uploads finished reloads, then evicts down to the budget
+	void BeginFrame();
+private:
+	struct Entry
+	{
+		TextureAtlas* Atlas = nullptr;
+		uint64_t LastUsedFrame = 0;
+		bool Loading = false;
+		bool Failed = false; // Don't retry a missing file every frame
+	};
+
+	struct LoadJob
+	{
+		uint32_t EntryIndex;
+		const TextureAtlas* Atlas;
+	};
+
+	struct LoadResult
+	{
+		uint32_t EntryIndex;
+		TextureMipChain Chain; // Empty when the file couldn't be loaded
+	};
+
+	std::vector<Entry> m_entries; // One per atlas, a linear scan is fine at these counts
+	size_t m_budget = DEFAULT_BUDGET;
+	uint64_t m_frame = 1;
+	bool m_warnedOverBudget = false;
+
+	// Decoding and mip building happen on the worker, GL uploads stay on the main thread
+	std::thread m_worker;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<LoadJob> m_jobs;
+	std::vector<LoadResult> m_results;
+	bool m_stopWorker = false;
+
+	Entry* findEntry(const TextureAtlas* atlas);
+	void uploadFinishedLoads();
+	void evictToBudget();
+	void workerLoop();
+};
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include "spdlog/spdlog.h"
 #include "stb/stb_image.h"
 #include "JSONParser.hpp"
@@ -5,6 +7,9 @@
 
 namespace TerracottaEngine
 {
+Texture::Texture() :
+	m_dimensions(glm::vec2(0.0f))
+{}
 Texture::Texture(const Filepath& texturePath) :
 	m_dimensions(glm::vec2(0.0f))
 {
@@ -23,29 +28,86 @@ Texture::Texture(const Filepath& texturePath) :
 		return;
 	}
 
-	m_dimensions = glm::vec2((float)imgWidth, (float)imgHeight);
-	SPDLOG_INFO("Loaded texture file at {} of {{{} x {}}} with {} color channels.", textureStr, m_dimensions.x, m_dimensions.y, numChannels);
+	SPDLOG_INFO("Loaded texture file at {} of {{{} x {}}} with {} color channels.", textureStr, imgWidth, imgHeight, numChannels);
 
 	// Upload image to OpenGL and free resources
+	UploadImage(imgWidth, imgHeight, numChannels, imgData);
+	stbi_image_free(imgData);
+}
+Texture::Texture(int width, int height, GLenum internalFormat, GLenum format, const void* pixels, GLint filter) :
+	m_dimensions(glm::vec2((float)width, (float)height))
+{
+	glGenTextures(1, &m_id);
+	glBindTexture(GL_TEXTURE_2D, m_id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// Single channel rows aren't 4-byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+Texture::~Texture()
+{
+	glDeleteTextures(1, &m_id);
+}
+
+void Texture::UploadImage(int width, int height, int channels, const unsigned char* pixels)
+{
+	Release();
+
+	m_dimensions = glm::vec2((float)width, (float)height);
 	glGenTextures(1, &m_id);
 	glBindTexture(GL_TEXTURE_2D, m_id);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	GLenum format = (numChannels == 4) ? GL_RGBA : GL_RGB;
-	glTexImage2D(GL_TEXTURE_2D, 0, format, imgWidth, imgHeight, 0, format, GL_UNSIGNED_BYTE, imgData);
+	GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
+	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
 	// glGenerateMipmap(GL_TEXTURE_2D);
 	glBindTexture(GL_TEXTURE_2D, 0);
-	stbi_image_free(imgData);
+
+	// Drivers pad RGB to 4 bytes per texel
+	m_sizeInBytes = static_cast<size_t>(width) * height * 4;
 }
-Texture::~Texture()
+
+void Texture::UploadMipChain(const TextureMipChain& chain)
 {
-	glDeleteTextures(1, &m_id);
+	Release();
+	if (chain.Levels.empty())
+		return;
+
+	const GLsizei levels = static_cast<GLsizei>(chain.Levels.size());
+	m_dimensions = glm::vec2((float)chain.Width, (float)chain.Height);
+	glCreateTextures(GL_TEXTURE_2D, 1, &m_id);
+	glTextureStorage2D(m_id, levels, GL_RGBA8, chain.Width, chain.Height);
+	m_sizeInBytes = 0;
+	for (GLsizei level = 0; level < levels; level++) {
+		glTextureSubImage2D(m_id, level, 0, 0, chain.Width >> level, chain.Height >> level, GL_RGBA, GL_UNSIGNED_BYTE, chain.Levels[level].data());
+		m_sizeInBytes += chain.Levels[level].size() * sizeof(glm::u8vec4);
+	}
+
+	// Pixel art stays crisp up close and averages out when zoomed away
+	glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(m_id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(m_id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(m_id, GL_TEXTURE_MAX_LEVEL, levels - 1);
+}
+
+void Texture::Release()
+{
+	if (m_id) {
+		glDeleteTextures(1, &m_id);
+		m_id = 0;
+	}
 }
 
-TextureAtlas::TextureAtlas(const Filepath& atlasPath) :
-	m_atlas(atlasPath)
+TextureAtlas::TextureAtlas(const Filepath& atlasPath, int tilePadding) :
+	m_path(atlasPath), m_padding(std::max(tilePadding, 0))
 {
 	// We know where all of the metadata for tilesets are stored. Use the filename of the atlas to view the JSON
 	AtlasInfo info = JSONParser::LoadAtlasInfo(atlasPath);
@@ -53,10 +115,115 @@ TextureAtlas::TextureAtlas(const Filepath& atlasPath) :
 	m_columns = info.columns;
 	m_tileWidth = 1.0f / m_columns;
 	m_tileHeight = 1.0f / m_rows;
+
+	TextureMipChain chain = LoadMipChain();
+	if (!chain.Levels.empty()) {
+		m_atlas.UploadMipChain(chain);
+		SPDLOG_INFO("Built atlas \"{}\": {}x{} padded, {} mip levels", atlasPath.filename().string(), chain.Width, chain.Height, chain.Levels.size());
+	}
 }
 TextureAtlas::~TextureAtlas()
 {}
 
+TextureMipChain TextureAtlas::LoadMipChain() const
+{
+	std::string pathStr = m_path.string();
+	if (!std::filesystem::exists(m_path)) {
+		SPDLOG_ERROR("The atlas file {} does not exist.", pathStr);
+		return {};
+	}
+
+	// Per-thread flag so the residency worker can decode too
+	int width, height, numChannels;
+	stbi_set_flip_vertically_on_load_thread(true);
+	unsigned char* pixels = stbi_load(pathStr.c_str(), &width, &height, &numChannels, 4);
+	if (!pixels) {
+		SPDLOG_ERROR("Failed to load atlas file at \"{}\".", pathStr);
+		return {};
+	}
+
+	TextureMipChain chain = buildMipChain(reinterpret_cast<const glm::u8vec4*>(pixels), width, height);
+	stbi_image_free(pixels);
+	return chain;
+}
+
+TextureMipChain TextureAtlas::buildMipChain(const glm::u8vec4* pixels, int width, int height) const
+{
+	TextureMipChain chain;
+	if (m_columns <= 0 || m_rows <= 0 || width < m_columns || height < m_rows)
+		return chain;
+
+	// Pull every tile out on its own, so downsampling never mixes two tiles
+	int tileW = width / m_columns;
+	int tileH = height / m_rows;
+	std::vector<std::vector<glm::u8vec4>> tiles(GetTileCount());
+	for (int row = 0; row < m_rows; row++) {
+		for (int column = 0; column < m_columns; column++) {
+			std::vector<glm::u8vec4>& tile = tiles[row * m_columns + column];
+			tile.resize(static_cast<size_t>(tileW) * tileH);
+			for (int y = 0; y < tileH; y++) {
+				const glm::u8vec4* src = pixels + static_cast<size_t>(row * tileH + y) * width + column * tileW;
+				std::copy(src, src + tileW, tile.begin() + static_cast<size_t>(y) * tileW);
+			}
+		}
+	}
+
+	int padding = m_padding;
+	chain.Width = m_columns * (tileW + 2 * padding);
+	chain.Height = m_rows * (tileH + 2 * padding);
+	while (true) {
+		// Write this level's cells, clamping into the tile extrudes its edge pixels into the padding
+		const int cellW = tileW + 2 * padding;
+		const int cellH = tileH + 2 * padding;
+		const int levelWidth = m_columns * cellW;
+		std::vector<glm::u8vec4>& level = chain.Levels.emplace_back(static_cast<size_t>(levelWidth) * m_rows * cellH);
+		for (int row = 0; row < m_rows; row++) {
+			for (int column = 0; column < m_columns; column++) {
+				const std::vector<glm::u8vec4>& tile = tiles[row * m_columns + column];
+				for (int y = 0; y < cellH; y++) {
+					const int tileY = std::clamp(y - padding, 0, tileH - 1);
+					glm::u8vec4* dst = &level[static_cast<size_t>(row * cellH + y) * levelWidth + column * cellW];
+					for (int x = 0; x < cellW; x++) {
+						dst[x] = tile[static_cast<size_t>(tileY) * tileW + std::clamp(x - padding, 0, tileW - 1)];
+					}
+				}
+			}
+		}
+
+		// Cells have to halve exactly to keep lining up with the atlas grid, and keep at least a pixel of padding
+		if (tileW % 2 != 0 || tileH % 2 != 0 || padding % 2 != 0 || padding < 2)
+			break;
+
+		// Alpha-weighted 2x2 box filter, so transparent texels don't darken the edges
+		const int halfW = tileW / 2;
+		const int halfH = tileH / 2;
+		for (std::vector<glm::u8vec4>& tile : tiles) {
+			std::vector<glm::u8vec4> half(static_cast<size_t>(halfW) * halfH);
+			for (int y = 0; y < halfH; y++) {
+				for (int x = 0; x < halfW; x++) {
+					glm::uvec3 colorSum(0);
+					glm::uvec3 plainSum(0);
+					uint32_t alphaSum = 0;
+					for (int i = 0; i < 4; i++) {
+						const glm::u8vec4& texel = tile[static_cast<size_t>(y * 2 + i / 2) * tileW + x * 2 + i % 2];
+						colorSum += glm::uvec3(texel) * uint32_t(texel.a);
+						plainSum += glm::uvec3(texel);
+						alphaSum += texel.a;
+					}
+					glm::uvec3 color = alphaSum > 0 ? (colorSum + alphaSum / 2) / alphaSum : (plainSum + 2u) / 4u;
+					half[static_cast<size_t>(y) * halfW + x] = glm::u8vec4(glm::u8vec3(color), static_cast<uint8_t>((alphaSum + 2) / 4));
+				}
+			}
+			tile = std::move(half);
+		}
+		tileW = halfW;
+		tileH = halfH;
+		padding /= 2;
+	}
+
+	return chain;
+}
+
 // Textures.cpp
 glm::vec4 TextureAtlas::GetTileUVs(int tileId) const
 {
@@ -71,19 +238,65 @@ glm::vec4 TextureAtlas::GetTileUVs(int tileId) const
 	int rowFromBottom = tileId / m_columns;
 	int row = (m_rows - 1) - rowFromBottom; // Flip the row
 
-	// Calculate pixel size in UV space
-	float atlasWidth = static_cast<float>(m_atlas.GetWidth());
-	float atlasHeight = static_cast<float>(m_atlas.GetHeight());
-	float pixelU = 1.0f / atlasWidth;
-	float pixelV = 1.0f / atlasHeight;
-
-	// Inset by 0.5 pixels on each side to avoid bleeding
-	float inset = 0.5f;
-	float minU = column * m_tileWidth + (pixelU * inset);
-	float minV = row * m_tileHeight + (pixelV * inset);
-	float maxU = (column + 1) * m_tileWidth - (pixelU * inset);
-	float maxV = (row + 1) * m_tileHeight - (pixelV * inset);
+	// The tile sits inside its cell's padding, which already holds copies of its edges, so no inset is needed
+	float paddingU = m_padding / static_cast<float>(m_atlas.GetWidth());
+	float paddingV = m_padding / static_cast<float>(m_atlas.GetHeight());
+	float minU = column * m_tileWidth + paddingU;
+	float minV = row * m_tileHeight + paddingV;
+	float maxU = (column + 1) * m_tileWidth - paddingU;
+	float maxV = (row + 1) * m_tileHeight - paddingV;
 
 	return glm::vec4(minU, minV, maxU, maxV);
 }
+
+int TextureAtlas::GetTileIdFromUV(const glm::vec2& uv) const
+{
+	int column = glm::clamp(static_cast<int>(uv.x / m_tileWidth), 0, m_columns - 1);
+	int row = glm::clamp(static_cast<int>(uv.y / m_tileHeight), 0, m_rows - 1);
+	int rowFromBottom = (m_rows - 1) - row;
+	return rowFromBottom * m_columns + column;
+}
+
+const std::vector<glm::u8vec4>& TextureAtlas::GetTileAverageColors()
+{
+	if (!m_averageColors.empty() || m_atlas.GetID() == 0)
+		return m_averageColors;
+
+	const int width = m_atlas.GetWidth();
+	const int height = m_atlas.GetHeight();
+	std::vector<glm::u8vec4> pixels(static_cast<size_t>(width) * height);
+	m_atlas.Bind();
+	glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	Texture::Unbind();
+
+	// Same row order as GetTileUVs, the image was flipped on load so pixel row 0 is V = 0. Padding is skipped.
+	const int cellPixelsX = width / m_columns;
+	const int cellPixelsY = height / m_rows;
+	const int tilePixelsX = cellPixelsX - 2 * m_padding;
+	const int tilePixelsY = cellPixelsY - 2 * m_padding;
+	m_averageColors.resize(GetTileCount());
+	for (int tileId = 0; tileId < GetTileCount(); tileId++) {
+		int column = tileId % m_columns;
+		int row = (m_rows - 1) - tileId / m_columns;
+
+		glm::dvec3 colorSum(0.0);
+		double alphaSum = 0.0;
+		const int originX = column * cellPixelsX + m_padding;
+		const int originY = row * cellPixelsY + m_padding;
+		for (int y = originY; y < originY + tilePixelsY; y++) {
+			for (int x = originX; x < originX + tilePixelsX; x++) {
+				const glm::u8vec4& pixel = pixels[static_cast<size_t>(y) * width + x];
+				colorSum += glm::dvec3(pixel.r, pixel.g, pixel.b) * double(pixel.a);
+				alphaSum += pixel.a;
+			}
+		}
+
+		const double pixelCount = std::max(tilePixelsX * tilePixelsY, 1);
+		glm::dvec3 color = alphaSum > 0.0 ? colorSum / alphaSum : glm::dvec3(0.0);
+		m_averageColors[tileId] = glm::u8vec4(glm::u8vec3(glm::round(color)), static_cast<uint8_t>(std::round(alphaSum / pixelCount)));
+	}
+
+	SPDLOG_INFO("Computed average colors for {} atlas tiles", m_averageColors.size());
+	return m_averageColors;
+}
 } // namespace TerracottaEngine
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <vector>
 #include "glad/glad.h"
 #include "glm/glm.hpp"
 
@@ -8,12 +9,31 @@ namespace TerracottaEngine
 {
 using Filepath = std::filesystem::path;
 
+// RGBA8 image with its mip levels, level 0 first and each level exactly half the previous one
+struct TextureMipChain
+{
+	int Width = 0, Height = 0;
+	std::vector<std::vector<glm::u8vec4>> Levels;
+};
+
 class Texture
 {
 public:
+	Texture();
 	Texture(const Filepath& texturePath);
+	// Generated textures (font atlases etc.), 8-bit channels
+	Texture(int width, int height, GLenum internalFormat, GLenum format, const void* pixels, GLint filter);
 	~Texture();
 
+	// (Re)creates the GL texture from 8-bit RGB/RGBA pixels, bottom row first
+	void UploadImage(int width, int height, int channels, const unsigned char* pixels);
+	// (Re)creates the GL texture with every level of the chain, trilinear when minified and nearest when magnified
+	void UploadMipChain(const TextureMipChain& chain);
+	// Frees the GL texture but keeps the dimensions, so UVs stay valid while it's evicted
+	void Release();
+	bool IsResident() const { return m_id != 0; }
+	size_t GetSizeInBytes() const { return m_id ? m_sizeInBytes : 0; }
+
 	GLuint GetID() const { return m_id; }
 	void Bind() const { glBindTexture(GL_TEXTURE_2D, m_id); }
 	static void Unbind() { glBindTexture(GL_TEXTURE_2D, 0); }
@@ -23,27 +43,46 @@ public:
 private:
 	GLuint m_id = 0;
 	glm::vec2 m_dimensions; // WxH of texture atlas
+	size_t m_sizeInBytes = 0;
 };
 
+// Every tile is extruded by its edge pixels into a padded cell, and each mip level is downsampled per tile, so
+// filtering and minification never pull in a neighbouring tile.
 class TextureAtlas
 {
 public:
-	TextureAtlas(const Filepath& atlasPath);
+	static constexpr int DEFAULT_TILE_PADDING = 4; // Also caps the chain, padding has to stay >= 1 pixel per level
+
+	TextureAtlas(const Filepath& atlasPath, int tilePadding = DEFAULT_TILE_PADDING);
 	~TextureAtlas();
 
+	// Decodes the atlas file and builds its padded mip chain; only touches immutable state so it's safe off-thread
+	TextureMipChain LoadMipChain() const;
+
 	glm::vec2 GetAtlasDimensions() const { return m_atlas.GetDimensions(); }
 
 	// Gets the UV coordinates for a specific tile from the atlas
 	glm::vec4 GetTileUVs(int tildId) const;
+	// Inverse of GetTileUVs, for any UV inside the tile
+	int GetTileIdFromUV(const glm::vec2& uv) const;
+	// Alpha-weighted average color of each tile, read back from the GPU on first use
+	const std::vector<glm::u8vec4>& GetTileAverageColors();
 	
 	const Texture& GetTexture() const { return m_atlas; }
 	Texture& GetTexture() { return m_atlas; }
+	const Filepath& GetPath() const { return m_path; }
 	int GetRows() const { return m_rows; }
 	int GetColumns() const { return m_columns; }
 	int GetTileCount() const { return m_rows * m_columns; }
+	int GetTilePadding() const { return m_padding; }
 private:
-	Texture m_atlas; // Actual OpenGL texture
+	Filepath m_path; // Where to reload from after eviction
+	Texture m_atlas; // Actual OpenGL texture, padded layout
 	int m_rows, m_columns;
-	float m_tileWidth, m_tileHeight; // UV width (1.0 / columns), (1.0 / rows)
+	int m_padding; // Extruded pixels around each tile at level 0
+	float m_tileWidth, m_tileHeight; // UV width of a padded cell (1.0 / columns), (1.0 / rows)
+
+	TextureMipChain buildMipChain(const glm::u8vec4* pixels, int width, int height) const;
+	std::vector<glm::u8vec4> m_averageColors;
 };
 } // namespace TerracottaEngine
\ No newline at end of file
@@ -1,48 +1,94 @@
+#include <algorithm>
 #include "VertexInput.hpp"
 
 namespace TerracottaEngine
 {
-VertexArray::VertexArray()
+BufferObject::BufferObject(BufferUpdatePolicy updatePolicy, BufferGrowPolicy growPolicy, GLbitfield storageFlags) :
+	m_storageFlags(storageFlags | GL_DYNAMIC_STORAGE_BIT), m_updatePolicy(updatePolicy), m_growPolicy(growPolicy)
+{}
+BufferObject::~BufferObject()
 {
-	glGenVertexArrays(1, &m_id);
-	glBindVertexArray(m_id);
+	if (m_id) {
+		glDeleteBuffers(1, &m_id);
+	}
 }
-VertexArray::~VertexArray()
+
+bool BufferObject::Reserve(GLsizeiptr size, const void* data)
 {
-	glDeleteVertexArrays(1, &m_id);
+	if (m_id && size <= m_capacity)
+		return false;
+
+	GLsizeiptr capacity = std::max<GLsizeiptr>(size, 1);
+	if (m_growPolicy == BufferGrowPolicy::Double && m_capacity > 0) {
+		capacity = m_capacity;
+		while (capacity < size) {
+			capacity *= 2;
+		}
+	}
+
+	if (m_id) {
+		glDeleteBuffers(1, &m_id);
+	}
+	glCreateBuffers(1, &m_id);
+	// Initial data only makes sense when it fills the whole storage
+	glNamedBufferStorage(m_id, capacity, capacity == size ? data : nullptr, m_storageFlags);
+	if (data && capacity != size) {
+		glNamedBufferSubData(m_id, 0, size, data);
+	}
+
+	m_capacity = capacity;
+	return true;
 }
 
-void VertexArray::LinkAttribute(GLuint layoutIndex, GLuint size, GLenum type, GLsizei stride, const void* offset)
+bool BufferObject::Upload(const void* data, GLsizeiptr size)
 {
-	glVertexAttribPointer(layoutIndex, size, type, GL_FALSE, stride, offset);
-	glEnableVertexAttribArray(layoutIndex);
+	if (size <= 0)
+		return false;
+
+	if (Reserve(size, data))
+		return true; // Fresh storage already holds the data
+
+	if (m_updatePolicy == BufferUpdatePolicy::Orphan) {
+		Orphan();
+	}
+	glNamedBufferSubData(m_id, 0, size, data);
+	return false;
 }
-void VertexArray::LinkInstanceAttribute(GLuint layoutIndex, GLuint size, GLenum type, GLsizei stride, const void* offset)
+
+void BufferObject::BufferSubData(GLintptr offset, GLsizeiptr size, const void* data)
 {
-	LinkAttribute(layoutIndex, size, type, stride, offset);
-	glVertexAttribDivisor(layoutIndex, 1);
+	glNamedBufferSubData(m_id, offset, size, data);
 }
 
 
 
-BufferObject::BufferObject(GLenum type)
+VertexArray::VertexArray()
 {
-	glGenBuffers(1, &m_id);
-	m_type = type;
-	glBindBuffer(m_type, m_id);
+	glCreateVertexArrays(1, &m_id);
 }
-BufferObject::~BufferObject()
+VertexArray::~VertexArray()
 {
-	glDeleteBuffers(1, &m_id);
+	glDeleteVertexArrays(1, &m_id);
 }
 
-void BufferObject::BufferInitData(GLsizeiptr size, const void* data, GLenum usage)
+void VertexArray::AttachVertexBuffer(GLuint bindingIndex, const BufferObject& buffer, GLsizei stride, GLintptr offset)
 {
-	glBufferData(m_type, size, data, usage);
+	glVertexArrayVertexBuffer(m_id, bindingIndex, buffer.GetID(), offset, stride);
 }
-void BufferObject::BufferSubData(GLintptr offset, GLsizeiptr size, const void* data)
+void VertexArray::AttachIndexBuffer(const BufferObject& buffer)
+{
+	glVertexArrayElementBuffer(m_id, buffer.GetID());
+}
+
+void VertexArray::LinkAttribute(GLuint layoutIndex, GLuint bindingIndex, GLint size, GLenum type, GLuint relativeOffset)
+{
+	glEnableVertexArrayAttrib(m_id, layoutIndex);
+	glVertexArrayAttribFormat(m_id, layoutIndex, size, type, GL_FALSE, relativeOffset);
+	glVertexArrayAttribBinding(m_id, layoutIndex, bindingIndex);
+}
+void VertexArray::SetBindingDivisor(GLuint bindingIndex, GLuint divisor)
 {
-	glBufferSubData(m_type, offset, size, data);
+	glVertexArrayBindingDivisor(m_id, bindingIndex, divisor);
 }
 
 } // namespace TerracottaEngine
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "glm/glm.hpp"
 
 // Contains VAO, VBO, EBO, etc.
+// Everything is Direct State Access, creating or filling one never disturbs what another subsystem has bound.
 namespace TerracottaEngine
 {
 struct Vertex
@@ -12,31 +13,69 @@ struct Vertex
 	float TextureIndex; // Texture slot
 };
 
-class VertexArray
+// What Upload does with the old contents
+enum class BufferUpdatePolicy
 {
-public:
-	VertexArray();
-	~VertexArray();
+	InPlace, // Plain sub-data upload, for data rewritten rarely
+	Orphan // Invalidate first so the driver can hand out fresh memory instead of waiting on in-flight draws
+};
 
-	void Bind() const { glBindVertexArray(m_id); }
-	void Unbind() const { glBindVertexArray(0); }
-	void LinkAttribute(GLuint layoutIndex, GLuint size, GLenum type, GLsizei stride, const void* offset);
-	void LinkInstanceAttribute(GLuint layoutIndex, GLuint size, GLenum type, GLsizei stride, const void* offset);
-private:
-	GLuint m_id = 0;
+// How Reserve sizes replacement storage
+enum class BufferGrowPolicy
+{
+	Exact, // Exactly what was asked for, for data that's rebuilt at the same size
+	Double // Doubles until it fits, for streams that keep growing
 };
 
 class BufferObject
 {
 public:
-	BufferObject(GLenum type);
+	// Immutable storage; GL_DYNAMIC_STORAGE_BIT is always added so Upload/BufferSubData work
+	BufferObject(BufferUpdatePolicy updatePolicy = BufferUpdatePolicy::InPlace, BufferGrowPolicy growPolicy = BufferGrowPolicy::Double, GLbitfield storageFlags = 0);
 	~BufferObject();
 
-	void Bind() const { glBindBuffer(m_type, m_id); }
-	void BufferInitData(GLsizeiptr size, const void* data, GLenum usage);
+	BufferObject(const BufferObject&) = delete;
+	BufferObject& operator=(const BufferObject&) = delete;
+
+	GLuint GetID() const { return m_id; }
+	GLsizeiptr GetCapacity() const { return m_capacity; }
+	// Only for APIs that need a binding (indirect draws, pixel transfers), never to edit the buffer
+	void Bind(GLenum target) const { glBindBuffer(target, m_id); }
+
+	// Immutable storage can't be resized, growing creates a new buffer. Returns true when the buffer name changed
+	// and VAOs using it have to be re-attached. Contents are not kept.
+	bool Reserve(GLsizeiptr size, const void* data = nullptr);
+	// Replaces the contents from offset 0, growing and orphaning per the policies. Same return as Reserve.
+	bool Upload(const void* data, GLsizeiptr size);
 	void BufferSubData(GLintptr offset, GLsizeiptr size, const void* data);
+	void Orphan() { glInvalidateBufferData(m_id); }
+private:
+	GLuint m_id = 0;
+	GLsizeiptr m_capacity = 0;
+	GLbitfield m_storageFlags;
+	BufferUpdatePolicy m_updatePolicy;
+	BufferGrowPolicy m_growPolicy;
+};
+
+class VertexArray
+{
+public:
+	VertexArray();
+	~VertexArray();
+
+	VertexArray(const VertexArray&) = delete;
+	VertexArray& operator=(const VertexArray&) = delete;
+
+	void Bind() const { glBindVertexArray(m_id); }
+	void Unbind() const { glBindVertexArray(0); }
+
+	// Attributes read from buffer binding points, buffers can be swapped without touching the attribute format
+	void AttachVertexBuffer(GLuint bindingIndex, const BufferObject& buffer, GLsizei stride, GLintptr offset = 0);
+	void AttachIndexBuffer(const BufferObject& buffer);
+	void LinkAttribute(GLuint layoutIndex, GLuint bindingIndex, GLint size, GLenum type, GLuint relativeOffset);
+	// 1 makes every attribute on the binding per-instance
+	void SetBindingDivisor(GLuint bindingIndex, GLuint divisor);
 private:
 	GLuint m_id = 0;
-	GLenum m_type;
 };
 } // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include "spdlog/spdlog.h"
+#include "SharedDataTypes.h"
+#include "VisibilityMask.hpp"
+
+namespace TerracottaEngine
+{
+VisibilityMask::VisibilityMask()
+{}
+VisibilityMask::~VisibilityMask()
+{}
+
+bool VisibilityMask::Init(uint32_t widthInTiles, uint32_t heightInTiles)
+{
+	if (widthInTiles == 0 || heightInTiles == 0) {
+		SPDLOG_ERROR("Cannot create a visibility mask for an empty world");
+		return false;
+	}
+
+	m_width = widthInTiles;
+	m_height = heightInTiles;
+	m_texture = std::make_unique<Texture>(m_width, m_height, GL_R8UI, GL_RED_INTEGER, nullptr, GL_NEAREST);
+	Fill(VISIBILITY_UNEXPLORED);
+
+	SPDLOG_INFO("Visibility mask initialized at {}x{}", m_width, m_height);
+	return true;
+}
+void VisibilityMask::Shutdown()
+{
+	m_texture.reset();
+	m_width = m_height = 0;
+}
+
+void VisibilityMask::UpdateRegion(int x, int y, uint32_t width, uint32_t height, const uint8_t* states)
+{
+	if (!m_texture || !states)
+		return;
+
+	// Clip to the world and let the unpack state skip the clipped rows/columns of the source
+	int minX = std::max(x, 0);
+	int minY = std::max(y, 0);
+	int maxX = std::min<int64_t>(int64_t(x) + width, m_width);
+	int maxY = std::min<int64_t>(int64_t(y) + height, m_height);
+	if (minX >= maxX || minY >= maxY)
+		return;
+
+	m_texture->Bind();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(width));
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, minX - x);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, minY - y);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, minX, minY, maxX - minX, maxY - minY, GL_RED_INTEGER, GL_UNSIGNED_BYTE, states);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	Texture::Unbind();
+}
+
+void VisibilityMask::Fill(uint8_t state)
+{
+	if (m_texture) {
+		glClearTexImage(m_texture->GetID(), 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, &state);
+	}
+}
+
+void VisibilityMask::Bind() const
+{
+	if (m_texture) {
+		glBindImageTexture(IMAGE_UNIT, m_texture->GetID(), 0, GL_FALSE, 0, GL_READ_ONLY, GL_R8UI);
+	}
+}
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include "glm/glm.hpp"
+#include "Textures.hpp"
+
+namespace TerracottaEngine
+{
+// Per-tile fog-of-war state (VISIBILITY_* values) in an R8UI texture, read by the tile shader with imageLoad.
+// It uses an image unit instead of a sampler because the tile shader already takes all 32 texture units.
+// The game updates rectangles of it directly, so revealing an area never touches chunk meshes. It covers the tiles
+// from (0, 0) to its size, the shader treats every tile outside it as visible.
+class VisibilityMask
+{
+public:
+	static constexpr GLuint IMAGE_UNIT = 0;
+
+	VisibilityMask();
+	~VisibilityMask();
+
+	bool Init(uint32_t widthInTiles, uint32_t heightInTiles);
+	void Shutdown();
+
+	// states is width * height bytes, row-major from the bottom row; the part outside the mask is skipped
+	void UpdateRegion(int x, int y, uint32_t width, uint32_t height, const uint8_t* states);
+	void Fill(uint8_t state);
+	void Bind() const;
+
+	bool IsInitialized() const { return m_texture != nullptr; }
+	void SetEnabled(bool enabled) { m_enabled = enabled; }
+	bool IsEnabled() const { return m_enabled && m_texture; }
+private:
+	std::unique_ptr<Texture> m_texture = nullptr;
+	uint32_t m_width = 0, m_height = 0;
+	bool m_enabled = false;
+};
+} // namespace TerracottaEngine
\ No newline at end of file
@@ -3,22 +3,21 @@
 namespace TerracottaGame
 {
 
-Chunk::Chunk(uint32_t x, uint32_t y) :
-	m_x(static_cast<float>(x)), m_y(static_cast<float>(y)), m_dirty(true)
-{
-	// Initialize all tiles to grass by default
-	for (uint32_t i = 0; i < CHUNK_TILE_COUNT; ++i) {
-		m_tiles[i].Type = TileType::GRASS;
-		m_tiles[i].Variant = 0;
-	}
-}
+Chunk::Chunk(int32_t x, int32_t y) :
+	m_x(x), m_y(y), m_dirty(true)
+{}
 
 Chunk::~Chunk()
 {}
 
-const GameTile* Chunk::GetTiles() const
+void Chunk::GetTiles(GameTile* outTiles) const
+{
+	m_tiles.Decode(outTiles);
+}
+
+void Chunk::SetTiles(const GameTile* tiles)
 {
-	return m_tiles;
+	m_tiles.Encode(tiles);
 }
 
 glm::ivec2 Chunk::GetPosition() const
@@ -1,30 +1,61 @@
 #pragma once
 #include <cstdint>
 #include "glm/glm.hpp"
+#include "PalettedTiles.hpp"
 #include "Tile.hpp"
 
 namespace TerracottaGame
 {
 
+// Floor division, so tile -1 is in chunk -1 rather than chunk 0
+inline int32_t FloorDiv(int32_t value, int32_t divisor)
+{
+	return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
 class Chunk
 {
 public:
 	static constexpr uint32_t CHUNK_WIDTH = 16;
 	static constexpr uint32_t CHUNK_HEIGHT = 16;
 	static constexpr uint32_t CHUNK_TILE_COUNT = CHUNK_WIDTH * CHUNK_HEIGHT;
+	static_assert(CHUNK_TILE_COUNT == PalettedTiles::TILE_COUNT, "Tile storage is sized for one chunk");
 
-	Chunk(uint32_t x, uint32_t y);
+	Chunk(int32_t x, int32_t y);
 	~Chunk();
 
-	const GameTile* GetTiles() const;
+	// Local coordinates. Setting tiles doesn't mark the chunk dirty or modified, the caller knows which it is.
+	GameTile GetTile(uint32_t localX, uint32_t localY) const { return m_tiles.Get(localY * CHUNK_WIDTH + localX); }
+	void SetTile(uint32_t localX, uint32_t localY, GameTile tile) { m_tiles.Set(localY * CHUNK_WIDTH + localX, tile); }
+	// The neighbouring chunks a local tile is next to, as AutotileNeighbour bits (none for interior tiles)
+	static uint8_t GetBorderNeighbours(uint32_t localX, uint32_t localY)
+	{
+		const bool north = localY == CHUNK_HEIGHT - 1, east = localX == CHUNK_WIDTH - 1, south = localY == 0, west = localX == 0;
+		return (north ? AUTOTILE_N : 0) | (north && east ? AUTOTILE_NE : 0) | (east ? AUTOTILE_E : 0) | (south && east ? AUTOTILE_SE : 0) |
+			(south ? AUTOTILE_S : 0) | (south && west ? AUTOTILE_SW : 0) | (west ? AUTOTILE_W : 0) | (north && west ? AUTOTILE_NW : 0);
+	}
+	// All CHUNK_TILE_COUNT tiles row-major, unpacked
+	void GetTiles(GameTile* outTiles) const;
+	void SetTiles(const GameTile* tiles);
+	const PalettedTiles& GetPalettedTiles() const { return m_tiles; }
+	PalettedTiles& GetPalettedTiles() { return m_tiles; }
+	size_t GetMemoryUsage() const { return sizeof(Chunk) + m_tiles.GetMemoryUsage(); }
 	glm::ivec2 GetPosition() const;
 	bool IsDirty() const;
 	void ClearDirty();
 	void MarkDirty();
+	// Changed since it was generated or last saved, so it has to be saved before it's unloaded. Every change bumps the
+	// version, a save snapshots it, and changes made while the snapshot is being written make it modified again.
+	bool IsModified() const { return m_version != m_savedVersion; }
+	void MarkModified() { m_version++; }
+	uint32_t GetVersion() const { return m_version; }
+	void MarkSaved(uint32_t version) { m_savedVersion = version; }
 private:
-	GameTile m_tiles[CHUNK_TILE_COUNT];
-	float m_x, m_y;
+	PalettedTiles m_tiles; // All grass to begin with
+	int32_t m_x, m_y; // Chunk coordinates, negative is fine
 	bool m_dirty = true;
+	uint32_t m_version = 0;
+	uint32_t m_savedVersion = 0;
 };
 
 } // namespace TerracottaGame
\ No newline at end of file
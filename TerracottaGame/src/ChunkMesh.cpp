@@ -0,0 +1,83 @@
+#include <algorithm>
+#include "ChunkMesh.hpp"
+
+namespace TerracottaGame
+{
+
+uint32_t TileRenderMapping::GetTileId(TileType type, uint8_t mask) const
+{
+	const uint32_t index = static_cast<uint32_t>(type);
+	return index < TILE_TYPE_COUNT ? GetAutotileTileId(Layouts[index], mask) : index;
+}
+
+AutotileWindow::AutotileWindow()
+{
+	std::fill(std::begin(m_types), std::end(m_types), UNLOADED);
+}
+
+void AutotileWindow::SetChunkTiles(const GameTile* tiles)
+{
+	for (int32_t y = 0; y < static_cast<int32_t>(Chunk::CHUNK_HEIGHT); y++) {
+		for (int32_t x = 0; x < static_cast<int32_t>(Chunk::CHUNK_WIDTH); x++)
+			m_types[(y + 1) * WIDTH + x + 1] = static_cast<uint8_t>(tiles[y * Chunk::CHUNK_WIDTH + x].Type);
+	}
+}
+
+void AutotileWindow::SetChunkTypes(const TileType* types)
+{
+	for (int32_t y = 0; y < static_cast<int32_t>(Chunk::CHUNK_HEIGHT); y++) {
+		for (int32_t x = 0; x < static_cast<int32_t>(Chunk::CHUNK_WIDTH); x++)
+			m_types[(y + 1) * WIDTH + x + 1] = static_cast<uint8_t>(types[y * Chunk::CHUNK_WIDTH + x]);
+	}
+}
+
+uint8_t AutotileWindow::ComputeMask(int32_t localX, int32_t localY) const
+{
+	const uint8_t* center = &m_types[(localY + 1) * WIDTH + localX + 1];
+	uint8_t mask = 0;
+	for (uint32_t n = 0; n < 8; n++) {
+		const uint8_t neighbour = center[AUTOTILE_OFFSETS[n].y * WIDTH + AUTOTILE_OFFSETS[n].x];
+		if (neighbour == *center || neighbour == UNLOADED)
+			mask |= 1 << n;
+	}
+	return mask;
+}
+
+void AutotileWindow::ComputeMasks(uint8_t* outMasks) const
+{
+	for (int32_t y = 0; y < static_cast<int32_t>(Chunk::CHUNK_HEIGHT); y++) {
+		for (int32_t x = 0; x < static_cast<int32_t>(Chunk::CHUNK_WIDTH); x++)
+			outMasks[y * Chunk::CHUNK_WIDTH + x] = ComputeMask(x, y);
+	}
+}
+
+void BuildRenderTile(glm::ivec2 chunkCoord, uint32_t localX, uint32_t localY, TileType type, uint8_t mask, const TileRenderMapping& mapping, RenderTile& outTile)
+{
+	// World position
+	outTile.X = static_cast<float>(chunkCoord.x * (int32_t)Chunk::CHUNK_WIDTH + (int32_t)localX);
+	outTile.Y = static_cast<float>(chunkCoord.y * (int32_t)Chunk::CHUNK_HEIGHT + (int32_t)localY);
+	outTile.Z = 0.0f;
+	outTile.ScaleX = 1.0f;
+	outTile.ScaleY = 1.0f;
+
+	// Ids past the atlas get an empty frame
+	const uint32_t tileId = mapping.GetTileId(type, mask);
+	const UVData uvs = tileId < mapping.TileUVs.size() ? mapping.TileUVs[tileId] : UVData{};
+	outTile.FrameSlotX = uvs.MinU;
+	outTile.FrameSlotY = uvs.MinV;
+	outTile.FrameSlotW = uvs.MaxU - uvs.MinU;
+	outTile.FrameSlotH = uvs.MaxV - uvs.MinV;
+	outTile.TextureIndex = static_cast<float>(mapping.AtlasId);
+}
+
+void BuildRenderTiles(glm::ivec2 chunkCoord, const GameTile* tiles, const uint8_t* masks, const TileRenderMapping& mapping, RenderTile* outTiles)
+{
+	for (uint32_t y = 0; y < Chunk::CHUNK_HEIGHT; ++y) {
+		for (uint32_t x = 0; x < Chunk::CHUNK_WIDTH; ++x) {
+			const uint32_t idx = y * Chunk::CHUNK_WIDTH + x;
+			BuildRenderTile(chunkCoord, x, y, tiles[idx].Type, masks[idx], mapping, outTiles[idx]);
+		}
+	}
+}
+
+} // namespace TerracottaGame
\ No newline at end of file
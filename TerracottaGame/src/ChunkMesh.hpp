@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "glm/glm.hpp"
+#include "Chunk.hpp"
+#include "SharedDataTypes.h"
+
+namespace TerracottaGame
+{
+
+// Everything needed to turn tile types and autotile masks into RenderTiles. The atlas UVs are read from the renderer
+// on the main thread when it's built, so the generator's workers can mesh chunks without calling into the engine.
+struct TileRenderMapping
+{
+	AutotileLayout Layouts[TILE_TYPE_COUNT];
+	std::vector<UVData> TileUVs; // By atlas tile id
+	uint32_t AtlasId = 0;
+
+	uint32_t GetTileId(TileType type, uint8_t mask) const;
+};
+
+// A chunk's tile types with a one tile ring around them from its neighbours, for computing autotile masks
+class AutotileWindow
+{
+public:
+	static constexpr int32_t WIDTH = Chunk::CHUNK_WIDTH + 2;
+	static constexpr int32_t HEIGHT = Chunk::CHUNK_HEIGHT + 2;
+	static constexpr uint8_t UNLOADED = 0xFF; // Ring tiles of neighbours that aren't known, they match every type
+
+	AutotileWindow(); // Ring starts out UNLOADED
+
+	void SetChunkTiles(const GameTile* tiles);
+	void SetChunkTypes(const TileType* types);
+	// Fills the ring from the neighbour at offset (one of AUTOTILE_OFFSETS), tileAt(neighbourLocalX, neighbourLocalY)
+	// returns the TileType of the neighbour's tile next to this chunk
+	template <typename Func>
+	void SetNeighbour(glm::ivec2 offset, Func&& tileAt);
+
+	// Local coordinates of a tile in the chunk
+	uint8_t ComputeMask(int32_t localX, int32_t localY) const;
+	void ComputeMasks(uint8_t* outMasks) const;
+private:
+	uint8_t m_types[WIDTH * HEIGHT];
+};
+
+// A chunk's autotile masks and the RenderTiles built from them
+struct ChunkMesh
+{
+	uint8_t Masks[Chunk::CHUNK_TILE_COUNT];
+	RenderTile Tiles[Chunk::CHUNK_TILE_COUNT];
+	std::shared_ptr<const TileRenderMapping> Mapping; // What Tiles were built with
+};
+
+void BuildRenderTile(glm::ivec2 chunkCoord, uint32_t localX, uint32_t localY, TileType type, uint8_t mask, const TileRenderMapping& mapping, RenderTile& outTile);
+void BuildRenderTiles(glm::ivec2 chunkCoord, const GameTile* tiles, const uint8_t* masks, const TileRenderMapping& mapping, RenderTile* outTiles);
+
+template <typename Func>
+void AutotileWindow::SetNeighbour(glm::ivec2 offset, Func&& tileAt)
+{
+	constexpr int32_t width = Chunk::CHUNK_WIDTH;
+	constexpr int32_t height = Chunk::CHUNK_HEIGHT;
+
+	// The neighbour's row, column or corner tile next to this chunk, in this chunk's local coordinates
+	const int32_t minX = offset.x < 0 ? -1 : (offset.x > 0 ? width : 0);
+	const int32_t maxX = offset.x < 0 ? -1 : (offset.x > 0 ? width : width - 1);
+	const int32_t minY = offset.y < 0 ? -1 : (offset.y > 0 ? height : 0);
+	const int32_t maxY = offset.y < 0 ? -1 : (offset.y > 0 ? height : height - 1);
+	for (int32_t y = minY; y <= maxY; y++) {
+		for (int32_t x = minX; x <= maxX; x++) {
+			const TileType type = tileAt(x - offset.x * width, y - offset.y * height);
+			m_types[(y + 1) * WIDTH + x + 1] = static_cast<uint8_t>(type);
+		}
+	}
+}
+} // namespace TerracottaGame
\ No newline at end of file
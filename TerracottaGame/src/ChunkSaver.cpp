@@ -0,0 +1,149 @@
+#include "ChunkSaver.hpp"
+#include "spdlog/spdlog.h"
+
+namespace TerracottaGame
+{
+
+ChunkSaver::ChunkSaver()
+{}
+
+ChunkSaver::~ChunkSaver()
+{
+	Shutdown();
+}
+
+bool ChunkSaver::Init(const Filepath& directory)
+{
+	Shutdown();
+	if (!m_storage.Open(directory))
+		return false;
+
+	m_stopWriter = false;
+	m_written = 0;
+	m_failed = 0;
+	m_writer = std::thread(&ChunkSaver::writerLoop, this);
+	return true;
+}
+
+void ChunkSaver::Shutdown()
+{
+	if (m_writer.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopWriter = true;
+		}
+		m_condition.notify_all();
+		m_writer.join();
+
+		if (m_failed > 0) {
+			SPDLOG_ERROR("{} chunk saves failed, their changes are lost", m_failed);
+		}
+	}
+
+	m_storage.Close();
+	m_queued.Clear();
+	m_order.clear();
+	m_freeSnapshots.clear();
+}
+
+void ChunkSaver::QueueSave(Chunk& chunk)
+{
+	if (!IsRunning())
+		return;
+
+	const glm::ivec2 coord = chunk.GetPosition();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::unique_ptr<Snapshot>* queued = m_queued.Find(coord.x, coord.y);
+		if (!queued) {
+			std::unique_ptr<Snapshot> snapshot;
+			if (!m_freeSnapshots.empty()) {
+				snapshot = std::move(m_freeSnapshots.back());
+				m_freeSnapshots.pop_back();
+			} else {
+				snapshot = std::make_unique<Snapshot>();
+			}
+			queued = &m_queued.Insert(coord.x, coord.y, std::move(snapshot));
+			m_order.push_back(coord);
+		}
+		(*queued)->Tiles = chunk.GetPalettedTiles(); // Reuses the snapshot's buffers
+	}
+	chunk.MarkSaved(chunk.GetVersion());
+	m_condition.notify_one();
+}
+
+bool ChunkSaver::HasSavedChunk(int32_t chunkX, int32_t chunkY)
+{
+	if (!IsRunning())
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_queued.Find(chunkX, chunkY))
+		return true;
+
+	std::lock_guard<std::mutex> storageLock(m_storageMutex);
+	return m_storage.HasChunk(chunkX, chunkY);
+}
+
+bool ChunkSaver::LoadChunk(Chunk& chunk)
+{
+	if (!IsRunning())
+		return false;
+
+	const glm::ivec2 coord = chunk.GetPosition();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (std::unique_ptr<Snapshot>* queued = m_queued.Find(coord.x, coord.y)) {
+		chunk.GetPalettedTiles() = (*queued)->Tiles;
+		chunk.MarkDirty();
+		return true;
+	}
+
+	// Still holding m_mutex, so a snapshot the writer just took off the queue is on disk before this reads
+	std::lock_guard<std::mutex> storageLock(m_storageMutex);
+	return m_storage.LoadChunk(chunk);
+}
+
+uint32_t ChunkSaver::GetQueuedCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return static_cast<uint32_t>(m_order.size());
+}
+
+uint32_t ChunkSaver::GetWrittenCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_written;
+}
+
+void ChunkSaver::writerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_condition.wait(lock, [this] { return m_stopWriter || !m_order.empty(); });
+		if (m_order.empty())
+			break; // Stopping, and everything is written
+
+		const glm::ivec2 coord = m_order.front();
+		m_order.pop_front();
+		std::unique_ptr<Snapshot> snapshot = std::move(*m_queued.Find(coord.x, coord.y));
+		m_queued.Erase(coord.x, coord.y);
+
+		// The storage lock is taken before the queue is released, see LoadChunk
+		std::unique_lock<std::mutex> storageLock(m_storageMutex);
+		lock.unlock();
+
+		const bool saved = m_storage.SaveTiles(coord.x, coord.y, snapshot->Tiles);
+		storageLock.unlock();
+
+		lock.lock();
+		m_freeSnapshots.push_back(std::move(snapshot));
+		if (saved) {
+			m_written++;
+		} else {
+			m_failed++;
+			SPDLOG_ERROR("Failed to save chunk ({}, {})", coord.x, coord.y);
+		}
+	}
+}
+
+} // namespace TerracottaGame
\ No newline at end of file
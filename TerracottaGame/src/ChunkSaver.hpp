@@ -0,0 +1,61 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ChunkHashMap.hpp"
+#include "Chunk.hpp"
+#include "RegionFile.hpp"
+
+namespace TerracottaGame
+{
+using TerracottaEngine::ChunkHashMap;
+
+// Saves chunks without stalling the game: the main thread only copies a chunk's packed tiles into a snapshot, a
+// background thread encodes and writes the snapshots to the region files. Chunks can keep changing once queued.
+class ChunkSaver
+{
+public:
+	ChunkSaver();
+	~ChunkSaver();
+
+	// Opens the save directory and starts the writer thread
+	bool Init(const Filepath& directory);
+	// Writes everything still queued, then stops the thread
+	void Shutdown();
+	bool IsRunning() const { return m_writer.joinable(); }
+
+	// Snapshots the chunk and marks its current version saved. A snapshot of it that's still queued is just updated.
+	void QueueSave(Chunk& chunk);
+	// Whether LoadChunk would find anything, without needing a chunk to load into
+	bool HasSavedChunk(int32_t chunkX, int32_t chunkY);
+	// Reads the newest saved tiles, from the queue if they haven't reached the disk yet. False if never saved.
+	bool LoadChunk(Chunk& chunk);
+
+	uint32_t GetQueuedCount() const;
+	uint32_t GetWrittenCount() const; // Since Init
+private:
+	struct Snapshot
+	{
+		PalettedTiles Tiles;
+	};
+
+	RegionStorage m_storage; // Only touched with m_storageMutex held
+	ChunkHashMap<std::unique_ptr<Snapshot>> m_queued;
+	std::deque<glm::ivec2> m_order; // Written oldest first
+	std::vector<std::unique_ptr<Snapshot>> m_freeSnapshots; // Reused so steady autosaves don't allocate
+	uint32_t m_written = 0;
+	uint32_t m_failed = 0;
+
+	std::thread m_writer;
+	mutable std::mutex m_mutex; // Taken before m_storageMutex when both are needed
+	std::mutex m_storageMutex;
+	std::condition_variable m_condition;
+	bool m_stopWriter = false;
+
+	void writerLoop();
+};
+} // namespace TerracottaGame
\ No newline at end of file
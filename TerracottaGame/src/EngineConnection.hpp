@@ -18,12 +18,24 @@ public:
 			g_engineAPI->InitWorldRendering(w, h);
 	}
 
-	static void UpdateChunkTiles(uint32_t x, uint32_t y, const RenderTile* tiles, uint32_t count)
+	static void UpdateChunkTiles(int32_t x, int32_t y, const RenderTile* tiles, uint32_t count)
 	{
 		if (g_engineAPI)
 			g_engineAPI->UpdateChunkTiles(x, y, tiles, count);
 	}
 
+	static void RemoveChunkTiles(int32_t x, int32_t y)
+	{
+		if (g_engineAPI)
+			g_engineAPI->RemoveChunkTiles(x, y);
+	}
+
+	static void GetCameraView(float* outX, float* outY, float* outWidth, float* outHeight)
+	{
+		if (g_engineAPI)
+			g_engineAPI->GetCameraView(outX, outY, outWidth, outHeight);
+	}
+
 	static uint32_t LoadTextureAtlas(const char* path) { return g_engineAPI ? g_engineAPI->LoadTextureAtlas(path) : 0; }
 
 	static bool GetAtlasInfo(uint32_t atlasId, AtlasInfo* outInfo) { return g_engineAPI ? g_engineAPI->GetAtlasInfo(atlasId, outInfo) != 0 : false; }
@@ -34,6 +46,12 @@ public:
 			g_engineAPI->GetTileUVs(atlasId, tileId, uvs);
 	}
 
+	static void SetTextureBudget(uint32_t megabytes)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SetTextureBudget(megabytes);
+	}
+
 	// Noise
 	static void GetNoise2D(uint32_t w, uint32_t h, float* data)
 	{
@@ -41,6 +59,20 @@ public:
 			g_engineAPI->GetNoise2D(w, h, data);
 	}
 
+	static void GetNoiseRegion(int32_t originX, int32_t originY, uint32_t w, uint32_t h, float* data)
+	{
+		if (g_engineAPI)
+			g_engineAPI->GetNoiseRegion(originX, originY, w, h, data);
+	}
+
+	static void SetNoiseSeed(int32_t seed)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SetNoiseSeed(seed);
+	}
+
+	static bool LoadNoiseGraph(const char* path) { return g_engineAPI ? g_engineAPI->LoadNoiseGraph(path) != 0 : false; }
+
 	// Input
 	static bool IsKeyDown(int keyCode) { return g_engineAPI ? g_engineAPI->IsKeyDown(keyCode) != 0 : false; }
 
@@ -57,6 +89,103 @@ public:
 
 	static bool IsMouseButtonDown(int button) { return g_engineAPI ? g_engineAPI->IsMouseButtonDown(button) != 0 : false; }
 
+	// Sprites
+	static void SubmitSprite(const SpriteDesc& sprite)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SubmitSprite(&sprite);
+	}
+
+	// Lighting
+	static void SubmitLight(const LightDesc& light)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SubmitLight(&light);
+	}
+
+	static void SetAmbientLight(float r, float g, float b)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SetAmbientLight(r, g, b);
+	}
+
+	// Text
+	static uint32_t LoadFont(const char* path) { return g_engineAPI ? g_engineAPI->LoadFont(path) : INVALID_FONT_ID; }
+
+	static void SubmitText(const TextDesc& text)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SubmitText(&text);
+	}
+
+	static float MeasureText(uint32_t fontId, const char* text, float size) { return g_engineAPI ? g_engineAPI->MeasureText(fontId, text, size) : 0.0f; }
+
+	// Minimap
+	static void SubmitMinimap(const MinimapDesc& minimap)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SubmitMinimap(&minimap);
+	}
+
+	static void SetWorldOverview(bool enabled)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SetWorldOverview(enabled ? 1 : 0);
+	}
+
+	// Fog of war
+	static void UpdateVisibility(int x, int y, uint32_t width, uint32_t height, const uint8_t* states)
+	{
+		if (g_engineAPI)
+			g_engineAPI->UpdateVisibility(x, y, width, height, states);
+	}
+
+	static void FillVisibility(uint8_t state)
+	{
+		if (g_engineAPI)
+			g_engineAPI->FillVisibility(state);
+	}
+
+	static void SetVisibilityEnabled(bool enabled)
+	{
+		if (g_engineAPI)
+			g_engineAPI->SetVisibilityEnabled(enabled ? 1 : 0);
+	}
+
+	// Particles
+	static void EmitParticles(const ParticleEmitDesc& desc)
+	{
+		if (g_engineAPI)
+			g_engineAPI->EmitParticles(&desc);
+	}
+
+#ifdef TERRACOTTA_DEBUG_DRAW
+	// Debug drawing, only in builds that have it (see TerracottaGame/CMakeLists.txt)
+	static void DebugDrawLine(float x0, float y0, float x1, float y1, DebugColor color)
+	{
+		if (g_engineAPI)
+			g_engineAPI->DebugDrawLine(x0, y0, x1, y1, color);
+	}
+
+	static void DebugDrawRect(float minX, float minY, float maxX, float maxY, DebugColor color)
+	{
+		if (g_engineAPI)
+			g_engineAPI->DebugDrawRect(minX, minY, maxX, maxY, color);
+	}
+
+	static void DebugDrawCircle(float x, float y, float radius, DebugColor color)
+	{
+		if (g_engineAPI)
+			g_engineAPI->DebugDrawCircle(x, y, radius, color);
+	}
+
+	static void DebugDrawText(float x, float y, const char* text, float size, DebugColor color)
+	{
+		if (g_engineAPI)
+			g_engineAPI->DebugDrawText(x, y, text, size, color);
+	}
+#endif
+
 	// Other
 	static float GetTotalTime() { return g_engineAPI ? g_engineAPI->GetTotalTime() : 0.0f; }
 };
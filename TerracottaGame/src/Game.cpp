@@ -1,3 +1,5 @@
+#include <chrono>
+#include <cstdio>
 #include "Game.hpp"
 #include "EngineConnection.hpp"
 #include "spdlog/spdlog.h"
@@ -35,14 +37,10 @@ void Game::Init()
 		return;
 	}
 
-	// Initialize world (10x10 chunks = 160x160 tiles)
-	m_world.Init(10, 10);
-
-	// Generate noise and populate world
-	std::vector<float> randomTileData(128 * 128);
-	Engine::GetNoise2D(128, 128, randomTileData.data());
-	m_world.SetTileData(randomTileData);
-	m_world.UpdateAllDirtyChunks();
+	// Chunks are generated in the background around the camera as it moves, starting with the first update
+	m_world.Init(WORLD_SEED);
+	m_spawnAreaReady = false;
+	m_autosaveTimer = 0.0f;
 
 	SPDLOG_INFO("World initialized and rendered!");
 }
@@ -55,9 +53,55 @@ void Game::Update(const float deltaTime)
 		PrintData();
 	}
 
-	// Update any dirty chunks each frame
+#ifdef TERRACOTTA_DEBUG_DRAW
+	if (Engine::IsKeyStartPress(292 /*GLFW_KEY_F3*/)) {
+		m_showDebugOverlay = !m_showDebugOverlay;
+	}
+#endif
+
+	if (Engine::IsKeyStartPress(295 /*GLFW_KEY_F6*/)) {
+		m_showOverview = !m_showOverview;
+		Engine::SetWorldOverview(m_showOverview);
+	}
+
+	// Keep the chunks around the camera loaded, then update any dirty chunks
+	float viewX = 0.0f, viewY = 0.0f, viewWidth = 0.0f, viewHeight = 0.0f;
+	Engine::GetCameraView(&viewX, &viewY, &viewWidth, &viewHeight);
+	const glm::vec2 viewSize(viewWidth, viewHeight);
+	m_world.UpdateStreaming({{glm::vec2(viewX, viewY) + viewSize * 0.5f, glm::length(viewSize) * 0.5f}});
 	m_world.UpdateAllDirtyChunks();
 
+	// The game runs while the rest streams in, just note when the first view is complete
+	const WorldGenerationProgress progress = m_world.GetGenerationProgress();
+	if (!m_spawnAreaReady && progress.Collected > 0 && progress.GetPending() == 0) {
+		m_spawnAreaReady = true;
+		SPDLOG_INFO("Spawn area generated ({} chunks)", progress.Collected);
+	}
+
+	// Only the tile copies happen here, encoding and writing is on the saver's thread
+	m_autosaveTimer += deltaTime;
+	if (m_autosaveTimer >= AUTOSAVE_INTERVAL) {
+		m_autosaveTimer = 0.0f;
+		const auto start = std::chrono::steady_clock::now();
+		const uint32_t queued = m_world.Autosave();
+		if (queued > 0) {
+			const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			SPDLOG_DEBUG("Autosave: {} chunks snapshotted in {} us", queued, elapsed.count());
+		}
+	}
+
+#ifdef TERRACOTTA_DEBUG_DRAW
+	if (m_showDebugOverlay) {
+		m_world.DrawDebugOverlay();
+
+		char status[96];
+		std::snprintf(status, sizeof(status), "Generating: %u queued, %u classified, %u finished (%u done)", progress.Queued, progress.Classified, progress.Finished, progress.Collected);
+		Engine::DebugDrawText(viewX + 0.5f, viewY + viewHeight - 1.0f, status, 0.5f, {1.0f, 1.0f, 1.0f, 0.8f});
+		std::snprintf(status, sizeof(status), "Chunks: %zu loaded, %zu KB", m_world.GetLoadedChunkCount(), m_world.GetTileMemoryUsage() / 1024);
+		Engine::DebugDrawText(viewX + 0.5f, viewY + viewHeight - 2.0f, status, 0.5f, {1.0f, 1.0f, 1.0f, 0.8f});
+	}
+#endif
+
 	// Update current state if we have one
 	if (m_state) {
 		m_state->Update(deltaTime);
@@ -68,6 +112,8 @@ void Game::Shutdown()
 {
 	SPDLOG_WARN("GAME SHUTDOWN!");
 
+	m_world.Shutdown();
+
 	if (m_state) {
 		m_state->Exit();
 		delete m_state;
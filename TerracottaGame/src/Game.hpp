@@ -38,11 +38,20 @@ public:
 
 	void PrintData();
 
+	static constexpr uint32_t WORLD_SEED = 1337;
+	static constexpr float AUTOSAVE_INTERVAL = 30.0f; // Seconds between snapshots of modified chunks
+
 	GameData& GetGameData() { return m_data; }
 	void SetGameData(GameData data) { m_data = data; }
 private:
 	World m_world;
 	GameState* m_state = nullptr;
 	GameData m_data;
+#ifdef TERRACOTTA_DEBUG_DRAW
+	bool m_showDebugOverlay = false;
+#endif
+	bool m_showOverview = false;
+	bool m_spawnAreaReady = false;
+	float m_autosaveTimer = 0.0f;
 };
 } // namespace TerracottaGame
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "MappedFile.hpp"
+#include "spdlog/spdlog.h"
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#define NOGDI
+	#include <Windows.h>
+#elif defined(__APPLE__) || defined(__linux__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace TerracottaGame
+{
+
+MappedFile::MappedFile()
+{}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::IsOpen() const
+{
+#if defined(_WIN32)
+	return m_file != nullptr;
+#else
+	return m_fd >= 0;
+#endif
+}
+
+#if defined(_WIN32)
+bool MappedFile::Open(const Filepath& path)
+{
+	Close();
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		SPDLOG_ERROR("Failed to open {} (error {})", path.string(), GetLastError());
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		SPDLOG_ERROR("Failed to get the size of {}", path.string());
+		return false;
+	}
+
+	m_file = file;
+	m_size = static_cast<uint64_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	unmap();
+	if (m_file) {
+		CloseHandle(static_cast<HANDLE>(m_file));
+		m_file = nullptr;
+	}
+	m_size = 0;
+}
+
+bool MappedFile::Map()
+{
+	if (!IsOpen())
+		return false;
+	if (m_view && m_mappedSize == m_size)
+		return true;
+
+	unmap();
+	if (m_size == 0)
+		return true; // Can't map an empty file, and there's nothing to read
+
+	// Size 0 maps the file as it is right now
+	HANDLE mapping = CreateFileMappingW(static_cast<HANDLE>(m_file), nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		SPDLOG_ERROR("Failed to create a file mapping (error {})", GetLastError());
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view) {
+		CloseHandle(mapping);
+		SPDLOG_ERROR("Failed to map a file view (error {})", GetLastError());
+		return false;
+	}
+
+	m_mapping = mapping;
+	m_view = static_cast<uint8_t*>(view);
+	m_mappedSize = m_size;
+	return true;
+}
+
+bool MappedFile::Write(uint64_t offset, const void* data, size_t size)
+{
+	if (!IsOpen())
+		return false;
+
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = static_cast<DWORD>(offset);
+	overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+	DWORD written = 0;
+	if (!WriteFile(static_cast<HANDLE>(m_file), data, static_cast<DWORD>(size), &written, &overlapped) || written != size) {
+		SPDLOG_ERROR("Failed to write {} bytes at {} (error {})", size, offset, GetLastError());
+		return false;
+	}
+
+	if (offset + size > m_size)
+		m_size = offset + size;
+	return true;
+}
+
+void MappedFile::unmap()
+{
+	if (m_view)
+		UnmapViewOfFile(m_view);
+	if (m_mapping)
+		CloseHandle(static_cast<HANDLE>(m_mapping));
+	m_view = nullptr;
+	m_mapping = nullptr;
+	m_mappedSize = 0;
+}
+
+#elif defined(__APPLE__) || defined(__linux__)
+bool MappedFile::Open(const Filepath& path)
+{
+	Close();
+	int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		SPDLOG_ERROR("Failed to open {}", path.string());
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		SPDLOG_ERROR("Failed to get the size of {}", path.string());
+		return false;
+	}
+
+	m_fd = fd;
+	m_size = static_cast<uint64_t>(info.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	unmap();
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+	m_size = 0;
+}
+
+bool MappedFile::Map()
+{
+	if (!IsOpen())
+		return false;
+	if (m_view && m_mappedSize == m_size)
+		return true;
+
+	unmap();
+	if (m_size == 0)
+		return true;
+
+	void* view = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_SHARED, m_fd, 0);
+	if (view == MAP_FAILED) {
+		SPDLOG_ERROR("Failed to map {} bytes", m_size);
+		return false;
+	}
+
+	m_view = static_cast<uint8_t*>(view);
+	m_mappedSize = m_size;
+	return true;
+}
+
+bool MappedFile::Write(uint64_t offset, const void* data, size_t size)
+{
+	if (!IsOpen())
+		return false;
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	size_t remaining = size;
+	while (remaining > 0) {
+		ssize_t written = pwrite(m_fd, bytes, remaining, static_cast<off_t>(offset));
+		if (written <= 0) {
+			SPDLOG_ERROR("Failed to write {} bytes at {}", size, offset);
+			return false;
+		}
+		bytes += written;
+		offset += static_cast<uint64_t>(written);
+		remaining -= static_cast<size_t>(written);
+	}
+
+	if (offset > m_size)
+		m_size = offset;
+	return true;
+}
+
+void MappedFile::unmap()
+{
+	if (m_view)
+		munmap(m_view, static_cast<size_t>(m_mappedSize));
+	m_view = nullptr;
+	m_mappedSize = 0;
+}
+#endif
+
+} // namespace TerracottaGame
\ No newline at end of file
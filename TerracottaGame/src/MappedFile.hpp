@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace TerracottaGame
+{
+using Filepath = std::filesystem::path;
+
+// A file that's read through a read-only memory mapping and written through the handle, writes past the end grow
+// it. The mapping only covers the size at the last Map(), so call it again before reading anything written since.
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Opens for reading and writing, creating an empty file if there isn't one
+	bool Open(const Filepath& path);
+	void Close();
+	bool IsOpen() const;
+
+	// Maps the whole file as it is now, a no-op if nothing was appended since the last call
+	bool Map();
+	// nullptr until mapped (and while the file is empty)
+	const uint8_t* GetData() const { return m_view; }
+	uint64_t GetMappedSize() const { return m_mappedSize; }
+	uint64_t GetSize() const { return m_size; }
+
+	bool Write(uint64_t offset, const void* data, size_t size);
+private:
+#if defined(_WIN32)
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#else
+	int m_fd = -1;
+#endif
+	uint8_t* m_view = nullptr;
+	uint64_t m_mappedSize = 0;
+	uint64_t m_size = 0;
+
+	void unmap();
+};
+} // namespace TerracottaGame
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "PalettedTiles.hpp"
+
+namespace TerracottaGame
+{
+
+static bool SameTile(GameTile a, GameTile b)
+{
+	return a.Type == b.Type;
+}
+
+static uint32_t BitsForPaletteSize(size_t size)
+{
+	if (size <= 1)
+		return 0;
+	if (size <= 2)
+		return 1;
+	if (size <= 4)
+		return 2;
+	if (size <= 16)
+		return 4;
+	return 8;
+}
+
+PalettedTiles::PalettedTiles() :
+	PalettedTiles(GameTile{TileType::GRASS})
+{}
+
+PalettedTiles::PalettedTiles(GameTile fill)
+{
+	Fill(fill);
+}
+
+void PalettedTiles::Set(uint32_t index, GameTile tile)
+{
+	int32_t entry = findInPalette(tile);
+	if (entry < 0) {
+		if (m_palette.size() >= (1u << m_bits)) {
+			GameTile tiles[TILE_COUNT];
+			Decode(tiles);
+			tiles[index] = tile;
+			Encode(tiles);
+			return;
+		}
+		entry = static_cast<int32_t>(m_palette.size());
+		m_palette.push_back(tile);
+	}
+
+	if (m_bits == 0)
+		return; // Still the one tile
+
+	const uint32_t bit = index * m_bits;
+	const uint32_t mask = ((1u << m_bits) - 1) << (bit & 31);
+	uint32_t& word = m_words[bit >> 5];
+	word = (word & ~mask) | (static_cast<uint32_t>(entry) << (bit & 31));
+}
+
+void PalettedTiles::Fill(GameTile tile)
+{
+	m_palette.assign(1, tile);
+	m_palette.shrink_to_fit();
+	m_words.clear();
+	m_words.shrink_to_fit();
+	m_bits = 0;
+}
+
+void PalettedTiles::Decode(GameTile* outTiles) const
+{
+	if (m_bits == 0) {
+		for (uint32_t i = 0; i < TILE_COUNT; i++)
+			outTiles[i] = m_palette[0];
+		return;
+	}
+
+	const uint32_t mask = (1u << m_bits) - 1;
+	for (uint32_t i = 0; i < TILE_COUNT; i++) {
+		const uint32_t bit = i * m_bits;
+		outTiles[i] = m_palette[(m_words[bit >> 5] >> (bit & 31)) & mask];
+	}
+}
+
+void PalettedTiles::Encode(const GameTile* tiles)
+{
+	// At most TILE_COUNT distinct tiles, so indices fit a byte
+	uint8_t indices[TILE_COUNT];
+	m_palette.clear();
+	int32_t last = -1;
+	for (uint32_t i = 0; i < TILE_COUNT; i++) {
+		// Runs of one tile are common, skip the palette search for them
+		if (last < 0 || !SameTile(tiles[i], m_palette[last])) {
+			last = findInPalette(tiles[i]);
+			if (last < 0) {
+				last = static_cast<int32_t>(m_palette.size());
+				m_palette.push_back(tiles[i]);
+			}
+		}
+		indices[i] = static_cast<uint8_t>(last);
+	}
+
+	m_bits = BitsForPaletteSize(m_palette.size());
+	m_words.assign(TILE_COUNT * m_bits / 32, 0);
+	for (uint32_t i = 0; m_bits > 0 && i < TILE_COUNT; i++) {
+		const uint32_t bit = i * m_bits;
+		m_words[bit >> 5] |= static_cast<uint32_t>(indices[i]) << (bit & 31);
+	}
+
+	// Chunks that got simpler give their memory back
+	m_palette.shrink_to_fit();
+	m_words.shrink_to_fit();
+}
+
+bool PalettedTiles::Assign(const GameTile* palette, uint32_t paletteSize, uint32_t bitsPerTile, const uint32_t* words)
+{
+	if (bitsPerTile != 0 && bitsPerTile != 1 && bitsPerTile != 2 && bitsPerTile != 4 && bitsPerTile != 8)
+		return false;
+	if (paletteSize == 0 || paletteSize > (1u << bitsPerTile))
+		return false;
+
+	const uint32_t wordCount = TILE_COUNT * bitsPerTile / 32;
+	const uint32_t mask = (1u << bitsPerTile) - 1;
+	for (uint32_t i = 0; bitsPerTile > 0 && i < TILE_COUNT; i++) {
+		const uint32_t bit = i * bitsPerTile;
+		if (((words[bit >> 5] >> (bit & 31)) & mask) >= paletteSize)
+			return false;
+	}
+
+	m_palette.assign(palette, palette + paletteSize);
+	m_words.assign(words, words + wordCount);
+	m_bits = bitsPerTile;
+	return true;
+}
+
+size_t PalettedTiles::GetMemoryUsage() const
+{
+	return m_palette.capacity() * sizeof(GameTile) + m_words.capacity() * sizeof(uint32_t);
+}
+
+int32_t PalettedTiles::findInPalette(GameTile tile) const
+{
+	for (size_t i = 0; i < m_palette.size(); i++) {
+		if (SameTile(m_palette[i], tile))
+			return static_cast<int32_t>(i);
+	}
+	return -1;
+}
+
+} // namespace TerracottaGame
\ No newline at end of file
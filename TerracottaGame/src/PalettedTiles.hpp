@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Tile.hpp"
+
+namespace TerracottaGame
+{
+
+// A chunk's tiles as a palette of the distinct values plus a packed index per tile, 0, 1, 2, 4 or 8 bits wide.
+// A chunk of one tile is just that tile, one with two kinds of tile is 32 bytes of indices.
+class PalettedTiles
+{
+public:
+	static constexpr uint32_t TILE_COUNT = 256;
+
+	PalettedTiles();
+	explicit PalettedTiles(GameTile fill);
+
+	GameTile Get(uint32_t index) const
+	{
+		if (m_bits == 0)
+			return m_palette[0];
+		const uint32_t bit = index * m_bits; // Widths divide 32, so an index never straddles two words
+		return m_palette[(m_words[bit >> 5] >> (bit & 31)) & ((1u << m_bits) - 1)];
+	}
+	// Repacks all the tiles when the palette outgrows its width, which also drops entries nothing uses anymore
+	void Set(uint32_t index, GameTile tile);
+	void Fill(GameTile tile);
+
+	void Decode(GameTile* outTiles) const;
+	// Builds the smallest palette for TILE_COUNT tiles
+	void Encode(const GameTile* tiles);
+	// Takes already packed data (a save), false and left unchanged if it doesn't describe valid tiles
+	bool Assign(const GameTile* palette, uint32_t paletteSize, uint32_t bitsPerTile, const uint32_t* words);
+
+	uint32_t GetBitsPerTile() const { return m_bits; }
+	const std::vector<GameTile>& GetPalette() const { return m_palette; }
+	const std::vector<uint32_t>& GetWords() const { return m_words; } // TILE_COUNT * bits / 32 of them
+	size_t GetMemoryUsage() const; // Heap bytes
+private:
+	std::vector<GameTile> m_palette;
+	std::vector<uint32_t> m_words;
+	uint32_t m_bits = 0;
+
+	int32_t findInPalette(GameTile tile) const;
+};
+} // namespace TerracottaGame
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include <cstring>
+#include <string>
+#include <system_error>
+#include "RegionFile.hpp"
+#include "spdlog/spdlog.h"
+
+namespace TerracottaGame
+{
+
+static constexpr uint8_t REGION_MAGIC[4] = {'T', 'C', 'R', 'G'};
+static constexpr uint16_t REGION_VERSION = 1;
+static constexpr uint32_t HEADER_SIZE = 16;
+static constexpr uint32_t TABLE_ENTRY_SIZE = 8;
+static constexpr uint32_t DATA_START = HEADER_SIZE + RegionFile::REGION_CHUNK_COUNT * TABLE_ENTRY_SIZE;
+static constexpr uint32_t RECORD_ALIGNMENT = 64; // Appended records get room to grow a little before they move
+
+enum RecordEncoding : uint8_t
+{
+	RECORD_RAW = 0, // Type for every tile
+	RECORD_RLE = 1, // (run length - 1, Type) until every tile is covered
+	RECORD_PALETTE = 2 // Palette size - 1, bits per tile, the palette's Types, then the chunk's index words
+};
+
+static constexpr size_t RAW_RECORD_SIZE = 1 + Chunk::CHUNK_TILE_COUNT;
+// The other encodings are only kept when they're smaller than raw, so no record is bigger than this
+static constexpr size_t MAX_RECORD_CAPACITY = (RAW_RECORD_SIZE + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+
+// 0 if it wouldn't be smaller than raw
+static size_t EncodeRLE(const GameTile* tiles, uint8_t* out)
+{
+	size_t size = 1;
+	out[0] = RECORD_RLE;
+	for (uint32_t i = 0; i < Chunk::CHUNK_TILE_COUNT;) {
+		uint32_t run = 1;
+		while (i + run < Chunk::CHUNK_TILE_COUNT && run < 256 && tiles[i + run].Type == tiles[i].Type)
+			run++;
+
+		if (size + 2 >= RAW_RECORD_SIZE)
+			return 0;
+		out[size++] = static_cast<uint8_t>(run - 1);
+		out[size++] = static_cast<uint8_t>(tiles[i].Type);
+		i += run;
+	}
+	return size;
+}
+
+static size_t GetPaletteRecordSize(const PalettedTiles& tiles)
+{
+	return 3 + tiles.GetPalette().size() + tiles.GetWords().size() * sizeof(uint32_t);
+}
+
+static size_t EncodeChunk(const PalettedTiles& tiles, uint8_t* out)
+{
+	// Run-length wins for chunks in long runs (one tile type away from borders), the palette form for busier
+	// chunks with few distinct tiles, and it's nearly a straight copy of the chunk
+	GameTile decoded[Chunk::CHUNK_TILE_COUNT];
+	tiles.Decode(decoded);
+	const size_t rleSize = EncodeRLE(decoded, out);
+	const size_t paletteSize = GetPaletteRecordSize(tiles);
+	if (rleSize != 0 && rleSize <= paletteSize)
+		return rleSize;
+
+	if (paletteSize < RAW_RECORD_SIZE) {
+		const std::vector<GameTile>& palette = tiles.GetPalette();
+		const std::vector<uint32_t>& words = tiles.GetWords();
+		out[0] = RECORD_PALETTE;
+		out[1] = static_cast<uint8_t>(palette.size() - 1);
+		out[2] = static_cast<uint8_t>(tiles.GetBitsPerTile());
+		size_t size = 3;
+		for (const GameTile& tile : palette)
+			out[size++] = static_cast<uint8_t>(tile.Type);
+		std::memcpy(out + size, words.data(), words.size() * sizeof(uint32_t));
+		return size + words.size() * sizeof(uint32_t);
+	}
+
+	out[0] = RECORD_RAW;
+	for (uint32_t i = 0; i < Chunk::CHUNK_TILE_COUNT; i++)
+		out[1 + i] = static_cast<uint8_t>(decoded[i].Type);
+	return RAW_RECORD_SIZE;
+}
+
+static bool DecodeChunk(const uint8_t* record, size_t size, PalettedTiles& outTiles)
+{
+	if (size == 0)
+		return false;
+
+	if (record[0] == RECORD_PALETTE) {
+		if (size < 3 || record[2] > 8)
+			return false;
+		const uint32_t paletteSize = record[1] + 1u;
+		const uint32_t bits = record[2];
+		const size_t wordCount = Chunk::CHUNK_TILE_COUNT * bits / 32;
+		if (size != 3 + paletteSize + wordCount * sizeof(uint32_t))
+			return false;
+
+		GameTile palette[256];
+		for (uint32_t i = 0; i < paletteSize; i++)
+			palette[i].Type = static_cast<TileType>(record[3 + i]);
+		// Copied out since the mapped record has no particular alignment
+		uint32_t words[Chunk::CHUNK_TILE_COUNT * 8 / 32];
+		std::memcpy(words, record + 3 + paletteSize, wordCount * sizeof(uint32_t));
+		return outTiles.Assign(palette, paletteSize, bits, words);
+	}
+
+	GameTile tiles[Chunk::CHUNK_TILE_COUNT];
+	if (record[0] == RECORD_RAW) {
+		if (size != RAW_RECORD_SIZE)
+			return false;
+		for (uint32_t i = 0; i < Chunk::CHUNK_TILE_COUNT; i++)
+			tiles[i].Type = static_cast<TileType>(record[1 + i]);
+		outTiles.Encode(tiles);
+		return true;
+	}
+
+	if (record[0] == RECORD_RLE) {
+		if ((size - 1) % 2 != 0)
+			return false;
+		uint32_t tile = 0;
+		for (size_t i = 1; i + 2 <= size; i += 2) {
+			const uint32_t run = record[i] + 1u;
+			if (tile + run > Chunk::CHUNK_TILE_COUNT)
+				return false;
+			for (uint32_t j = 0; j < run; j++)
+				tiles[tile + j].Type = static_cast<TileType>(record[i + 1]);
+			tile += run;
+		}
+		if (tile != Chunk::CHUNK_TILE_COUNT)
+			return false;
+		outTiles.Encode(tiles);
+		return true;
+	}
+
+	return false;
+}
+
+RegionFile::RegionFile()
+{
+	static_assert(sizeof(TableEntry) == TABLE_ENTRY_SIZE, "Table entries are written as-is");
+	std::memset(m_table, 0, sizeof(m_table));
+}
+
+RegionFile::~RegionFile()
+{
+	Close();
+}
+
+bool RegionFile::Open(const Filepath& path)
+{
+	Close();
+	if (!m_file.Open(path))
+		return false;
+
+	const bool valid = m_file.GetSize() == 0 ? createHeader() : readHeader();
+	if (!valid) {
+		// Left as it is, it may be from another format version that still reads it
+		SPDLOG_ERROR("{} isn't a region file this version can read, leaving it untouched", path.string());
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void RegionFile::Close()
+{
+	m_file.Close();
+	std::memset(m_table, 0, sizeof(m_table));
+}
+
+bool RegionFile::HasChunk(int32_t localX, int32_t localY) const
+{
+	if (localX < 0 || localY < 0 || localX >= REGION_SIZE || localY >= REGION_SIZE)
+		return false;
+	return m_table[localY * REGION_SIZE + localX].Offset != 0;
+}
+
+bool RegionFile::ReadChunk(int32_t localX, int32_t localY, PalettedTiles& outTiles)
+{
+	if (!IsOpen() || !HasChunk(localX, localY))
+		return false;
+
+	const TableEntry& entry = m_table[localY * REGION_SIZE + localX];
+	// Saved since the last mapping
+	if (entry.Offset + entry.Size > m_file.GetMappedSize() && !m_file.Map())
+		return false;
+
+	if (!DecodeChunk(m_file.GetData() + entry.Offset, entry.Size, outTiles)) {
+		SPDLOG_WARN("Damaged region record for local chunk ({}, {})", localX, localY);
+		return false;
+	}
+	return true;
+}
+
+bool RegionFile::WriteChunk(int32_t localX, int32_t localY, const PalettedTiles& tiles)
+{
+	if (!IsOpen() || localX < 0 || localY < 0 || localX >= REGION_SIZE || localY >= REGION_SIZE)
+		return false;
+
+	uint8_t record[MAX_RECORD_CAPACITY] = {};
+	const size_t size = EncodeChunk(tiles, record);
+
+	const uint32_t index = static_cast<uint32_t>(localY * REGION_SIZE + localX);
+	TableEntry entry = m_table[index];
+	if (entry.Offset == 0 || size > entry.Capacity) {
+		// Appended with its padding, so the next append lands after the reserved space
+		entry.Offset = static_cast<uint32_t>(m_file.GetSize());
+		entry.Capacity = static_cast<uint16_t>((size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT);
+		if (!m_file.Write(entry.Offset, record, entry.Capacity))
+			return false;
+	} else if (!m_file.Write(entry.Offset, record, size)) {
+		return false;
+	}
+	entry.Size = static_cast<uint16_t>(size);
+
+	// The record goes first, an interrupted append leaves the table pointing at the old one
+	if (!m_file.Write(HEADER_SIZE + index * TABLE_ENTRY_SIZE, &entry, sizeof(entry)))
+		return false;
+	m_table[index] = entry;
+	return true;
+}
+
+uint32_t RegionFile::GetSavedChunkCount() const
+{
+	uint32_t count = 0;
+	for (const TableEntry& entry : m_table) {
+		if (entry.Offset != 0)
+			count++;
+	}
+	return count;
+}
+
+bool RegionFile::createHeader()
+{
+	uint8_t header[HEADER_SIZE] = {};
+	const uint16_t regionSize = REGION_SIZE;
+	const uint32_t tileCount = Chunk::CHUNK_TILE_COUNT;
+	std::memcpy(header, REGION_MAGIC, 4);
+	std::memcpy(header + 4, &REGION_VERSION, 2);
+	std::memcpy(header + 6, &regionSize, 2);
+	std::memcpy(header + 8, &tileCount, 4);
+
+	std::memset(m_table, 0, sizeof(m_table));
+	return m_file.Write(0, header, sizeof(header)) && m_file.Write(HEADER_SIZE, m_table, sizeof(m_table)) && m_file.Map();
+}
+
+bool RegionFile::readHeader()
+{
+	if (m_file.GetSize() < DATA_START || !m_file.Map())
+		return false;
+
+	const uint8_t* data = m_file.GetData();
+	uint16_t version = 0, regionSize = 0;
+	uint32_t tileCount = 0;
+	std::memcpy(&version, data + 4, 2);
+	std::memcpy(&regionSize, data + 6, 2);
+	std::memcpy(&tileCount, data + 8, 4);
+	if (std::memcmp(data, REGION_MAGIC, 4) != 0 || version != REGION_VERSION || regionSize != REGION_SIZE || tileCount != Chunk::CHUNK_TILE_COUNT)
+		return false;
+
+	std::memcpy(m_table, data + HEADER_SIZE, sizeof(m_table));
+	for (TableEntry& entry : m_table) {
+		if (entry.Offset == 0)
+			continue;
+		// Drop entries pointing outside the file (a torn write), the chunk just regenerates
+		if (entry.Offset < DATA_START || entry.Size > entry.Capacity || entry.Offset + static_cast<uint64_t>(entry.Size) > m_file.GetSize()) {
+			SPDLOG_WARN("Ignoring a damaged region table entry");
+			entry = {};
+		}
+	}
+	return true;
+}
+
+RegionStorage::RegionStorage()
+{}
+
+RegionStorage::~RegionStorage()
+{
+	Close();
+}
+
+bool RegionStorage::Open(const Filepath& directory)
+{
+	Close();
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error) {
+		SPDLOG_ERROR("Failed to create save directory {}: {}", directory.string(), error.message());
+		return false;
+	}
+
+	m_directory = directory;
+	return true;
+}
+
+void RegionStorage::Close()
+{
+	m_regions.Clear();
+	m_directory.clear();
+}
+
+bool RegionStorage::HasChunk(int32_t chunkX, int32_t chunkY)
+{
+	const glm::ivec2 regionCoord = GetRegionCoord(chunkX, chunkY);
+	RegionFile* region = getRegion(regionCoord, false);
+	if (!region)
+		return false;
+
+	const glm::ivec2 local = glm::ivec2(chunkX, chunkY) - regionCoord * RegionFile::REGION_SIZE;
+	return region->HasChunk(local.x, local.y);
+}
+
+bool RegionStorage::LoadChunk(Chunk& chunk)
+{
+	const glm::ivec2 chunkCoord = chunk.GetPosition();
+	const glm::ivec2 regionCoord = GetRegionCoord(chunkCoord.x, chunkCoord.y);
+	RegionFile* region = getRegion(regionCoord, false);
+	if (!region)
+		return false;
+
+	const glm::ivec2 local = chunkCoord - regionCoord * RegionFile::REGION_SIZE;
+	if (!region->ReadChunk(local.x, local.y, chunk.GetPalettedTiles()))
+		return false;
+
+	chunk.MarkDirty();
+	return true;
+}
+
+bool RegionStorage::SaveChunk(const Chunk& chunk)
+{
+	const glm::ivec2 chunkCoord = chunk.GetPosition();
+	return SaveTiles(chunkCoord.x, chunkCoord.y, chunk.GetPalettedTiles());
+}
+
+bool RegionStorage::SaveTiles(int32_t chunkX, int32_t chunkY, const PalettedTiles& tiles)
+{
+	const glm::ivec2 regionCoord = GetRegionCoord(chunkX, chunkY);
+	RegionFile* region = getRegion(regionCoord, true);
+	if (!region)
+		return false;
+
+	const glm::ivec2 local = glm::ivec2(chunkX, chunkY) - regionCoord * RegionFile::REGION_SIZE;
+	return region->WriteChunk(local.x, local.y, tiles);
+}
+
+glm::ivec2 RegionStorage::GetRegionCoord(int32_t chunkX, int32_t chunkY)
+{
+	// Floor division, chunk -1 is in region -1
+	auto floorDiv = [](int32_t value)
+	{
+		return value >= 0 ? value / RegionFile::REGION_SIZE : -((-value + RegionFile::REGION_SIZE - 1) / RegionFile::REGION_SIZE);
+	};
+	return glm::ivec2(floorDiv(chunkX), floorDiv(chunkY));
+}
+
+Filepath RegionStorage::GetRegionPath(glm::ivec2 regionCoord) const
+{
+	return m_directory / ("r." + std::to_string(regionCoord.x) + "." + std::to_string(regionCoord.y) + ".tcr");
+}
+
+RegionFile* RegionStorage::getRegion(glm::ivec2 regionCoord, bool create)
+{
+	if (!IsOpen())
+		return nullptr;
+
+	OpenRegion* region = m_regions.Find(regionCoord.x, regionCoord.y);
+	if (!region) {
+		if (m_regions.Size() >= MAX_OPEN_REGIONS)
+			closeLeastRecentlyUsed();
+		region = &m_regions.Insert(regionCoord.x, regionCoord.y, OpenRegion());
+	}
+	region->LastUsed = ++m_useCounter;
+
+	if (region->File)
+		return region->File.get();
+	if (region->Unreadable)
+		return nullptr;
+	if (region->Missing && !create)
+		return nullptr;
+
+	// Missing regions are remembered so loads don't check the disk for every streamed chunk
+	const Filepath path = GetRegionPath(regionCoord);
+	std::error_code error;
+	if (!create && !std::filesystem::exists(path, error)) {
+		region->Missing = true;
+		return nullptr;
+	}
+
+	auto file = std::make_unique<RegionFile>();
+	if (!file->Open(path)) {
+		region->Unreadable = true; // Its chunks regenerate, and saves to it fail rather than overwrite it
+		return nullptr;
+	}
+	region->File = std::move(file);
+	return region->File.get();
+}
+
+void RegionStorage::closeLeastRecentlyUsed()
+{
+	glm::ivec2 oldest(0);
+	uint64_t oldestUse = UINT64_MAX;
+	m_regions.ForEach([&](glm::ivec2 coord, const OpenRegion& region)
+	{
+		if (region.LastUsed < oldestUse) {
+			oldestUse = region.LastUsed;
+			oldest = coord;
+		}
+	});
+	m_regions.Erase(oldest.x, oldest.y);
+}
+
+} // namespace TerracottaGame
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include "ChunkHashMap.hpp"
+#include "Chunk.hpp"
+#include "MappedFile.hpp"
+
+namespace TerracottaGame
+{
+using Filepath = std::filesystem::path;
+using TerracottaEngine::ChunkHashMap;
+
+// Saved chunks for a REGION_SIZE x REGION_SIZE block of chunk coordinates in one file:
+//
+//   header    magic "TCRG", version, region size, tiles per chunk
+//   table     one {offset, size, capacity} entry per chunk, row-major, offset 0 means not saved
+//   records   one per saved chunk: an encoding byte, then the tiles run-length encoded, as the chunk's palette and
+//             packed indices, or raw, whichever is smallest
+//
+// Reads go through a memory mapping of the file. A save overwrites the chunk's record in place when it still fits,
+// otherwise appends a new one, and then rewrites its table entry, so it's two small writes whatever the region's size.
+// Integers are little-endian.
+class RegionFile
+{
+public:
+	static constexpr int32_t REGION_SIZE = 32;
+	static constexpr uint32_t REGION_CHUNK_COUNT = REGION_SIZE * REGION_SIZE;
+
+	RegionFile();
+	~RegionFile();
+
+	// Creates an empty region if the file doesn't exist, false if it exists but isn't one (a damaged file or another
+	// format version), which is never modified
+	bool Open(const Filepath& path);
+	void Close();
+	bool IsOpen() const { return m_file.IsOpen(); }
+
+	// Coordinates are local to the region, 0 to REGION_SIZE - 1
+	bool HasChunk(int32_t localX, int32_t localY) const;
+	// False if the chunk isn't saved or its record is damaged, outTiles is only written on success
+	bool ReadChunk(int32_t localX, int32_t localY, PalettedTiles& outTiles);
+	bool WriteChunk(int32_t localX, int32_t localY, const PalettedTiles& tiles);
+
+	uint32_t GetSavedChunkCount() const;
+	uint64_t GetFileSize() const { return m_file.GetSize(); }
+private:
+	struct TableEntry
+	{
+		uint32_t Offset; // From the start of the file
+		uint16_t Size; // Record bytes in use
+		uint16_t Capacity; // Bytes reserved for the record, a resave that fits reuses them
+	};
+
+	MappedFile m_file;
+	TableEntry m_table[REGION_CHUNK_COUNT]; // Copy of the file's table
+
+	bool createHeader();
+	bool readHeader();
+};
+
+// Region files in one directory, opened on demand by the chunks asking for them. Saves are meant for chunks that
+// differ from what the seed generates, everything else is cheaper to regenerate than to load.
+class RegionStorage
+{
+public:
+	static constexpr uint32_t MAX_OPEN_REGIONS = 16; // Least recently used ones get closed past this
+
+	RegionStorage();
+	~RegionStorage();
+
+	// Creates the directory if needed
+	bool Open(const Filepath& directory);
+	void Close();
+	bool IsOpen() const { return !m_directory.empty(); }
+
+	// Only reads the region's table, which stays in memory once the region is open
+	bool HasChunk(int32_t chunkX, int32_t chunkY);
+	// False (and the chunk untouched) if it was never saved
+	bool LoadChunk(Chunk& chunk);
+	bool SaveChunk(const Chunk& chunk);
+	bool SaveTiles(int32_t chunkX, int32_t chunkY, const PalettedTiles& tiles);
+
+	static glm::ivec2 GetRegionCoord(int32_t chunkX, int32_t chunkY);
+	Filepath GetRegionPath(glm::ivec2 regionCoord) const;
+private:
+	struct OpenRegion
+	{
+		std::unique_ptr<RegionFile> File; // nullptr when the region has no file yet, saves create it
+		uint64_t LastUsed = 0;
+		bool Missing = false; // Checked for a file already, loads don't need to look again
+		bool Unreadable = false; // Its file exists but didn't open, it isn't retried
+	};
+
+	Filepath m_directory;
+	ChunkHashMap<OpenRegion> m_regions;
+	uint64_t m_useCounter = 0;
+
+	// nullptr if the region has no file and create is false, or it failed to open
+	RegionFile* getRegion(glm::ivec2 regionCoord, bool create);
+	void closeLeastRecentlyUsed();
+};
+} // namespace TerracottaGame
\ No newline at end of file
@@ -1,6 +1,59 @@
+#include <array>
 #include "Tile.hpp"
 
 namespace TerracottaGame
 {
 
+const glm::ivec2 AUTOTILE_OFFSETS[8] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+
+uint32_t GetCardinalAutotileIndex(uint8_t mask)
+{
+	return ((mask & AUTOTILE_N) ? 1u : 0u) | ((mask & AUTOTILE_E) ? 2u : 0u) | ((mask & AUTOTILE_S) ? 4u : 0u) | ((mask & AUTOTILE_W) ? 8u : 0u);
+}
+
+uint32_t GetBlobAutotileIndex(uint8_t mask)
+{
+	// Dropping corners without both their edges leaves 47 distinct masks, numbered in increasing order
+	static const std::array<uint8_t, 256> table = []
+	{
+		auto reduce = [](uint32_t m)
+		{
+			if ((m & (AUTOTILE_N | AUTOTILE_E)) != (AUTOTILE_N | AUTOTILE_E))
+				m &= ~AUTOTILE_NE;
+			if ((m & (AUTOTILE_S | AUTOTILE_E)) != (AUTOTILE_S | AUTOTILE_E))
+				m &= ~AUTOTILE_SE;
+			if ((m & (AUTOTILE_S | AUTOTILE_W)) != (AUTOTILE_S | AUTOTILE_W))
+				m &= ~AUTOTILE_SW;
+			if ((m & (AUTOTILE_N | AUTOTILE_W)) != (AUTOTILE_N | AUTOTILE_W))
+				m &= ~AUTOTILE_NW;
+			return m;
+		};
+
+		std::array<uint8_t, 256> indexOfReduced = {};
+		uint8_t count = 0;
+		for (uint32_t m = 0; m < 256; m++) {
+			if (reduce(m) == m)
+				indexOfReduced[m] = count++;
+		}
+
+		std::array<uint8_t, 256> result = {};
+		for (uint32_t m = 0; m < 256; m++)
+			result[m] = indexOfReduced[reduce(m)];
+		return result;
+	}();
+	return table[mask];
+}
+
+uint32_t GetAutotileTileId(const AutotileLayout& layout, uint8_t mask)
+{
+	switch (layout.Mode) {
+	case AutotileMode::Cardinal:
+		return layout.BaseTileId + GetCardinalAutotileIndex(mask);
+	case AutotileMode::Blob:
+		return layout.BaseTileId + GetBlobAutotileIndex(mask);
+	default:
+		return layout.BaseTileId;
+	}
+}
+
 } // namespace TerracottaGame
\ No newline at end of file
@@ -9,10 +9,48 @@ enum class TileType : uint8_t
 	GRASS = 0,
 	ROCK = 1
 };
+static constexpr uint32_t TILE_TYPE_COUNT = 2;
 
+// Autotile mask bits, one for each of the 8 neighbours with the same type (north is +Y). Masks aren't stored, World
+// derives them from the types around a tile when it draws the chunk.
+enum AutotileNeighbour : uint8_t
+{
+	AUTOTILE_N = 1 << 0,
+	AUTOTILE_NE = 1 << 1,
+	AUTOTILE_E = 1 << 2,
+	AUTOTILE_SE = 1 << 3,
+	AUTOTILE_S = 1 << 4,
+	AUTOTILE_SW = 1 << 5,
+	AUTOTILE_W = 1 << 6,
+	AUTOTILE_NW = 1 << 7
+};
+
+// Offset of each neighbour, in AutotileNeighbour bit order
+extern const glm::ivec2 AUTOTILE_OFFSETS[8];
+
+// What a chunk stores per tile. Chunk palettes hold distinct GameTiles, so anything derived belongs elsewhere.
 struct GameTile
 {
 	TileType Type;
-	uint8_t Variant;
 };
+
+enum class AutotileMode : uint8_t
+{
+	None, // One atlas tile whatever the neighbours
+	Cardinal, // 16 tiles, from the N, E, S and W bits
+	Blob // 47 tiles, corners only count when both edges next to them are set
+};
+
+// Where a tile type's variants start in the atlas, they follow each other in index order
+struct AutotileLayout
+{
+	uint32_t BaseTileId = 0;
+	AutotileMode Mode = AutotileMode::None;
+};
+
+// Variant index for a neighbour mask, 0 to 15
+uint32_t GetCardinalAutotileIndex(uint8_t mask);
+// Variant index for a neighbour mask, 0 to 46
+uint32_t GetBlobAutotileIndex(uint8_t mask);
+uint32_t GetAutotileTileId(const AutotileLayout& layout, uint8_t mask);
 } // namespace TerracottaGame
\ No newline at end of file
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
 #include "World.hpp"
 #include "EngineConnection.hpp" // For Engine:: and g_engineAPI
 #include "spdlog/spdlog.h"
@@ -5,19 +9,40 @@
 namespace TerracottaGame
 {
 
+static const char* SAVE_DIRECTORY = "../../../../../TerracottaGame/saves";
+// AutotileNeighbour bit index of the chunk at (x, y) relative to another, as [y + 1][x + 1]
+static constexpr int8_t NEIGHBOUR_INDEX[3][3] = {{5, 4, 3}, {6, -1, 2}, {7, 0, 1}};
+
 World::World()
-{}
+{
+	// The atlas only has one tile per type so far
+	for (uint32_t i = 0; i < TILE_TYPE_COUNT; i++)
+		m_autotileLayouts[i] = {i, AutotileMode::None};
+}
 
 World::~World()
-{}
+{
+	Shutdown();
+}
 
-void World::Init(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks)
+void World::Init(uint32_t seed)
 {
-	m_worldWidthInChunks = worldWidthInChunks;
-	m_worldHeightInChunks = worldHeightInChunks;
+	m_seed = seed;
+	m_chunks.Clear();
+	// Workers sample noise on their own, so the seed and terrain graph go in before they start
+	Engine::SetNoiseSeed(static_cast<int32_t>(seed));
+	if (!Engine::LoadNoiseGraph("../../../../../TerracottaGame/res/worldgen/terrain.json")) {
+		SPDLOG_WARN("Terrain noise graph failed to load, generating from plain noise");
+	}
+	m_generator.Init();
+
+	// Saves only hold modified chunks, they're meaningless with another seed's terrain around them
+	if (!m_saver.Init(Filepath(SAVE_DIRECTORY) / ("world_" + std::to_string(seed)))) {
+		SPDLOG_WARN("World saving is disabled, modified chunks will be lost when unloaded");
+	}
 
 	// Initialize renderer
-	Engine::InitWorldRendering(worldWidthInChunks, worldHeightInChunks);
+	Engine::InitWorldRendering(MAP_REGION_CHUNKS, MAP_REGION_CHUNKS);
 
 	// Load terrain atlas (6x9 grid)
 	m_terrainAtlasId = Engine::LoadTextureAtlas("../../../../../TerracottaGame/res/tileset/tiles01.png");
@@ -29,139 +54,532 @@ void World::Init(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks)
 	}
 
 	SPDLOG_WARN("Terrain atlas loaded: {}x{} tiles, UV size: {}x{}", m_terrainAtlasInfo.rows, m_terrainAtlasInfo.columns, m_terrainAtlasInfo.tileWidth, m_terrainAtlasInfo.tileHeight);
+	// Workers mesh chunks from here on, with the atlas UVs read once now
+	rebuildRenderMapping();
+	SPDLOG_INFO("World initialized with seed {}, chunks are generated on demand", seed);
+}
 
-	// Create chunks
-	uint32_t totalChunks = worldWidthInChunks * worldHeightInChunks;
-	m_chunks.reserve(totalChunks);
+void World::Shutdown()
+{
+	// Joins the workers before the game module (and the engine API they call) goes away
+	m_generator.Shutdown();
+	if (m_saver.IsRunning()) {
+		uint32_t saved = Autosave();
+		m_saver.Shutdown();
+		if (saved > 0) {
+			SPDLOG_INFO("Saved {} modified chunks", saved);
+		}
+	}
+	m_chunks.Clear();
+}
 
-	for (uint32_t y = 0; y < worldHeightInChunks; ++y) {
-		for (uint32_t x = 0; x < worldWidthInChunks; ++x) {
-			m_chunks.emplace_back(x, y);
+void World::UpdateStreaming(const std::vector<WorldObserver>& observers)
+{
+	auto chunkRange = [](const WorldObserver& observer, int32_t margin)
+	{
+		glm::ivec4 range; // minX, minY, maxX, maxY in chunks, inclusive
+		range.x = FloorDiv(static_cast<int32_t>(std::floor(observer.Position.x - observer.Radius)), Chunk::CHUNK_WIDTH) - margin;
+		range.y = FloorDiv(static_cast<int32_t>(std::floor(observer.Position.y - observer.Radius)), Chunk::CHUNK_HEIGHT) - margin;
+		range.z = FloorDiv(static_cast<int32_t>(std::floor(observer.Position.x + observer.Radius)), Chunk::CHUNK_WIDTH) + margin;
+		range.w = FloorDiv(static_cast<int32_t>(std::floor(observer.Position.y + observer.Radius)), Chunk::CHUNK_HEIGHT) + margin;
+		return range;
+	};
+
+	auto inUnloadRange = [&](glm::ivec2 coord)
+	{
+		for (const WorldObserver& observer : observers) {
+			glm::ivec4 range = chunkRange(observer, m_unloadMargin);
+			if (coord.x >= range.x && coord.x <= range.z && coord.y >= range.y && coord.y <= range.w)
+				return true;
+		}
+		return false;
+	};
+
+	// Drop chunks outside every observer's unload range
+	std::vector<glm::ivec2> evicted;
+	m_chunks.ForEach([&](glm::ivec2 coord, const std::unique_ptr<Chunk>&)
+	{
+		if (!inUnloadRange(coord))
+			evicted.push_back(coord);
+	});
+	for (const glm::ivec2& coord : evicted) {
+		Chunk& chunk = **m_chunks.Find(coord.x, coord.y);
+		if (chunk.IsModified())
+			m_saver.QueueSave(chunk); // Loads see the snapshot until it's written
+		m_chunks.Erase(coord.x, coord.y);
+		m_generator.Release(coord.x, coord.y);
+		Engine::RemoveChunkTiles(coord.x, coord.y);
+	}
+
+	// Missing chunks in load range: saved ones are read straight from their region (a mapped read and a small
+	// decode) or the save queue, the rest are prioritised by distance to the closest observer (a repeat request just
+	// updates it, so the queue follows the camera). Chunks only get saved while loaded, so one the generator already
+	// has was found unsaved when it was requested and the saves aren't checked again.
+	uint32_t loaded = 0;
+	for (const WorldObserver& observer : observers) {
+		glm::ivec4 range = chunkRange(observer, m_loadMargin);
+		for (int32_t y = range.y; y <= range.w; y++) {
+			for (int32_t x = range.x; x <= range.z; x++) {
+				if (m_chunks.Find(x, y))
+					continue;
+
+				glm::vec2 center((x + 0.5f) * Chunk::CHUNK_WIDTH, (y + 0.5f) * Chunk::CHUNK_HEIGHT);
+				const float priority = glm::distance(center, observer.Position);
+				if (m_generator.UpdatePriority(x, y, priority))
+					continue;
+
+				if (m_saver.HasSavedChunk(x, y)) {
+					auto saved = std::make_unique<Chunk>(x, y);
+					if (m_saver.LoadChunk(*saved)) {
+						m_chunks.Insert(x, y, std::move(saved));
+						refreshChunkSeams({x, y});
+						loaded++;
+						continue;
+					}
+				}
+				m_generator.Request(x, y, priority); // Never saved, or the save is damaged
+			}
+		}
+	}
+	// Whatever wasn't requested again above has left every load range, finished ones are dropped unuploaded
+	const uint32_t cancelled = m_generator.ReleaseUnrefreshed();
+
+	// Finished chunks come with their mesh, only the border tiles get checked against the loaded neighbours before
+	// it's uploaded. The ones without one stay dirty for UpdateAllDirtyChunks.
+	m_collected.clear();
+	m_generator.Collect(m_collected, MAX_CHUNKS_COLLECTED_PER_UPDATE);
+	uint32_t added = 0;
+	for (GeneratedChunk& generated : m_collected) {
+		const glm::ivec2 coord = generated.Result->GetPosition();
+		if (m_chunks.Find(coord.x, coord.y))
+			continue; // Generated synchronously in the meantime, same tiles
+		if (!inUnloadRange(coord)) {
+			m_generator.Release(coord.x, coord.y); // So it can be requested again
+			continue;
 		}
+
+		Chunk& chunk = *m_chunks.Insert(coord.x, coord.y, std::move(generated.Result));
+		refreshChunkSeams(coord);
+		if (generated.Mesh)
+			uploadGeneratedMesh(chunk, *generated.Mesh);
+		added++;
 	}
 
-	SPDLOG_INFO("World initialized: {}x{} chunks", worldWidthInChunks, worldHeightInChunks);
+	if (!evicted.empty() || added > 0 || loaded > 0 || cancelled > 0) {
+		SPDLOG_DEBUG("World streaming: +{} generated +{} from disk -{} chunks, {} requests cancelled, {} loaded", added, loaded, evicted.size(), cancelled, m_chunks.Size());
+	}
 }
 
-void World::UpdateChunkRendering(uint32_t chunkX, uint32_t chunkY)
+void World::UpdateChunkRendering(Chunk& chunk)
 {
-	if (!Engine::IsRunning())
+	if (!Engine::IsRunning() || !m_renderMapping)
 		return;
 
-	Chunk* chunk = GetChunk(chunkX, chunkY);
-	if (!chunk)
+	const glm::ivec2 chunkPos = chunk.GetPosition();
+	GameTile gameTiles[Chunk::CHUNK_TILE_COUNT];
+	chunk.GetTiles(gameTiles);
+	uint8_t masks[Chunk::CHUNK_TILE_COUNT];
+	computeAutotileMasks(chunkPos, gameTiles, masks);
+	RenderTile renderTiles[TILES_PER_CHUNK];
+	BuildRenderTiles(chunkPos, gameTiles, masks, *m_renderMapping, renderTiles);
+
+	// Send to engine
+	Engine::UpdateChunkTiles(chunkPos.x, chunkPos.y, renderTiles, TILES_PER_CHUNK);
+	chunk.ClearDirty();
+}
+
+void World::uploadGeneratedMesh(Chunk& chunk, ChunkMesh& mesh)
+{
+	// Meshes built with an older layout are redrawn from scratch
+	if (!Engine::IsRunning() || mesh.Mapping != m_renderMapping)
 		return;
 
-	const GameTile* gameTiles = chunk->GetTiles();
-	constexpr uint32_t tilesPerChunk = TILES_PER_CHUNK;
-	RenderTile renderTiles[tilesPerChunk];
-
-	for (uint32_t y = 0; y < Chunk::CHUNK_HEIGHT; ++y) {
-		for (uint32_t x = 0; x < Chunk::CHUNK_WIDTH; ++x) {
-			uint32_t idx = y * Chunk::CHUNK_WIDTH + x;
-			const GameTile& gameTile = gameTiles[idx];
-
-			// World position
-			float worldX = static_cast<float>(chunkX * Chunk::CHUNK_WIDTH + x);
-			float worldY = static_cast<float>(chunkY * Chunk::CHUNK_HEIGHT + y);
-
-			renderTiles[idx].X = worldX;
-			renderTiles[idx].Y = worldY;
-			renderTiles[idx].Z = 0.0f;
-			renderTiles[idx].ScaleX = 1.0f;
-			renderTiles[idx].ScaleY = 1.0f;
-
-			// Get UV coordinates from atlas (with insets built-in!)
-			uint32_t tileId = static_cast<uint32_t>(gameTile.Type);
-			UVData uvs;
-			Engine::GetTileUVs(m_terrainAtlasId, tileId, &uvs);
-
-			renderTiles[idx].FrameSlotX = uvs.MinU;
-			renderTiles[idx].FrameSlotY = uvs.MinV;
-			renderTiles[idx].FrameSlotW = uvs.MaxU - uvs.MinU;
-			renderTiles[idx].FrameSlotH = uvs.MaxV - uvs.MinV;
-			renderTiles[idx].TextureIndex = static_cast<float>(m_terrainAtlasId);
+	// Workers autotiled against the generated neighbours, the loaded ones can differ (edits, saves, or not loaded at
+	// all) and only the border tiles see them
+	const glm::ivec2 chunkPos = chunk.GetPosition();
+	GameTile gameTiles[Chunk::CHUNK_TILE_COUNT];
+	chunk.GetTiles(gameTiles);
+	AutotileWindow window;
+	fillAutotileWindow(chunkPos, gameTiles, window);
+	for (uint32_t y = 0; y < Chunk::CHUNK_HEIGHT; y++) {
+		for (uint32_t x = 0; x < Chunk::CHUNK_WIDTH; x++) {
+			if (Chunk::GetBorderNeighbours(x, y) == 0)
+				continue;
+
+			const uint32_t idx = y * Chunk::CHUNK_WIDTH + x;
+			const uint8_t mask = window.ComputeMask(static_cast<int32_t>(x), static_cast<int32_t>(y));
+			if (mask != mesh.Masks[idx]) {
+				mesh.Masks[idx] = mask;
+				BuildRenderTile(chunkPos, x, y, gameTiles[idx].Type, mask, *m_renderMapping, mesh.Tiles[idx]);
+			}
 		}
 	}
 
-	// Debug first tile
-	if (chunkX == 0 && chunkY == 0) {
-		SPDLOG_INFO("Tile UV WITH INSETS: ({}, {}) to ({}, {})", renderTiles[0].FrameSlotX, renderTiles[0].FrameSlotY, renderTiles[0].FrameSlotX + renderTiles[0].FrameSlotW,
-			renderTiles[0].FrameSlotY + renderTiles[0].FrameSlotH);
-	}
+	Engine::UpdateChunkTiles(chunkPos.x, chunkPos.y, mesh.Tiles, TILES_PER_CHUNK);
+	chunk.ClearDirty();
+}
 
-	// Send to engine
-	Engine::UpdateChunkTiles(chunkX, chunkY, renderTiles, tilesPerChunk);
-	chunk->ClearDirty();
+void World::rebuildRenderMapping()
+{
+	auto mapping = std::make_shared<TileRenderMapping>();
+	std::copy(std::begin(m_autotileLayouts), std::end(m_autotileLayouts), std::begin(mapping->Layouts));
+	mapping->AtlasId = m_terrainAtlasId;
+	mapping->TileUVs.resize(static_cast<size_t>(m_terrainAtlasInfo.rows) * m_terrainAtlasInfo.columns);
+	for (uint32_t tileId = 0; tileId < mapping->TileUVs.size(); tileId++)
+		Engine::GetTileUVs(m_terrainAtlasId, tileId, &mapping->TileUVs[tileId]);
+
+	m_renderMapping = mapping;
+	m_generator.SetRenderMapping(mapping);
 }
 
 void World::UpdateAllDirtyChunks()
 {
 	// Iterate through all chunks and update dirty ones
-	for (uint32_t y = 0; y < m_worldHeightInChunks; ++y) {
-		for (uint32_t x = 0; x < m_worldWidthInChunks; ++x) {
-			Chunk* chunk = GetChunk(x, y);
-			if (chunk && chunk->IsDirty()) {
-				UpdateChunkRendering(x, y);
-			}
+	m_chunks.ForEach([this](glm::ivec2, std::unique_ptr<Chunk>& chunk)
+	{
+		if (chunk->IsDirty()) {
+			UpdateChunkRendering(*chunk);
 		}
+	});
+}
+
+#ifdef TERRACOTTA_DEBUG_DRAW
+void World::DrawDebugOverlay()
+{
+	const DebugColor boundsColor = {1.0f, 1.0f, 0.0f, 0.6f};
+	const DebugColor dirtyColor = {1.0f, 0.0f, 0.0f, 1.0f};
+	const DebugColor labelColor = {1.0f, 1.0f, 1.0f, 0.8f};
+
+	char label[32];
+	m_chunks.ForEach([&](glm::ivec2 coord, const std::unique_ptr<Chunk>& chunk)
+	{
+		float minX = static_cast<float>(coord.x * (int32_t)Chunk::CHUNK_WIDTH);
+		float minY = static_cast<float>(coord.y * (int32_t)Chunk::CHUNK_HEIGHT);
+		float maxX = minX + Chunk::CHUNK_WIDTH;
+		float maxY = minY + Chunk::CHUNK_HEIGHT;
+		Engine::DebugDrawRect(minX, minY, maxX, maxY, chunk->IsDirty() ? dirtyColor : boundsColor);
+
+		std::snprintf(label, sizeof(label), "%d,%d", coord.x, coord.y);
+		Engine::DebugDrawText(minX + 0.5f, maxY - 1.0f, label, 0.5f, labelColor);
+	});
+}
+#endif
+
+void World::SetStreamingMargins(int32_t loadMargin, int32_t unloadMargin)
+{
+	m_loadMargin = std::max(loadMargin, 0);
+	m_unloadMargin = std::max(unloadMargin, m_loadMargin);
+}
+
+bool World::GetTile(int32_t worldX, int32_t worldY, GameTile& outTile) const
+{
+	int32_t chunkX = FloorDiv(worldX, Chunk::CHUNK_WIDTH);
+	int32_t chunkY = FloorDiv(worldY, Chunk::CHUNK_HEIGHT);
+	uint32_t localX = static_cast<uint32_t>(worldX - chunkX * (int32_t)Chunk::CHUNK_WIDTH);
+	uint32_t localY = static_cast<uint32_t>(worldY - chunkY * (int32_t)Chunk::CHUNK_HEIGHT);
+
+	const std::unique_ptr<Chunk>* chunk = m_chunks.Find(chunkX, chunkY);
+	if (!chunk)
+		return false;
+
+	outTile = (*chunk)->GetTile(localX, localY);
+	return true;
+}
+
+bool World::SetTile(int32_t worldX, int32_t worldY, TileType type)
+{
+	int32_t chunkX = FloorDiv(worldX, Chunk::CHUNK_WIDTH);
+	int32_t chunkY = FloorDiv(worldY, Chunk::CHUNK_HEIGHT);
+	uint32_t localX = static_cast<uint32_t>(worldX - chunkX * (int32_t)Chunk::CHUNK_WIDTH);
+	uint32_t localY = static_cast<uint32_t>(worldY - chunkY * (int32_t)Chunk::CHUNK_HEIGHT);
+
+	Chunk* chunk = GetChunk(chunkX, chunkY);
+	if (!chunk)
+		return false;
+
+	// Set in place, the chunk only repacks if the type is new to its palette
+	if (chunk->GetTile(localX, localY).Type == type)
+		return true;
+
+	const TileType before = chunk->GetTile(localX, localY).Type;
+	chunk->SetTile(localX, localY, {type});
+	chunk->MarkDirty();
+	chunk->MarkModified();
+	if (Chunk::GetBorderNeighbours(localX, localY) != 0) {
+		const Chunk* neighbours[8];
+		getNeighbourChunks({chunkX, chunkY}, neighbours);
+		markNeighboursDirty({chunkX, chunkY}, getChangedBorders(neighbours, localX, localY, before, type));
 	}
+	return true;
 }
 
-void World::SetTileData(const std::vector<float>& data)
+Chunk* World::GetChunk(int32_t chunkX, int32_t chunkY)
 {
-	// Use noise data to set tile types
-	for (size_t i = 0; i < data.size() && i < m_chunks.size() * Chunk::CHUNK_TILE_COUNT; ++i) {
-		uint32_t chunkIndex = static_cast<uint32_t>(i) / Chunk::CHUNK_TILE_COUNT;
-		uint32_t tileIndex = static_cast<uint32_t>(i) % Chunk::CHUNK_TILE_COUNT;
+	std::unique_ptr<Chunk>* chunk = m_chunks.Find(chunkX, chunkY);
+	return chunk ? chunk->get() : nullptr;
+}
 
-		if (chunkIndex < m_chunks.size()) {
-			GameTile* tiles = const_cast<GameTile*>(m_chunks[chunkIndex].GetTiles());
+Chunk& World::GetOrCreateChunk(int32_t chunkX, int32_t chunkY)
+{
+	if (Chunk* chunk = GetChunk(chunkX, chunkY))
+		return *chunk;
+
+	if (m_saver.HasSavedChunk(chunkX, chunkY)) {
+		auto saved = std::make_unique<Chunk>(chunkX, chunkY);
+		if (m_saver.LoadChunk(*saved)) {
+			Chunk& chunk = *m_chunks.Insert(chunkX, chunkY, std::move(saved));
+			m_generator.Release(chunkX, chunkY); // In case it was queued
+			refreshChunkSeams({chunkX, chunkY});
+			return chunk;
+		}
+	}
 
-			// Convert noise value to tile type
-			// TODO: Move this to a separate file???
-			float noiseValue = data[i];
-			if (noiseValue > 0.5f) {
-				tiles[tileIndex].Type = TileType::ROCK;
-			} else {
-				tiles[tileIndex].Type = TileType::GRASS;
+	return GenerateChunk(chunkX, chunkY);
+}
+
+Chunk& World::GenerateChunk(int32_t chunkX, int32_t chunkY)
+{
+	std::unique_ptr<Chunk>* existing = m_chunks.Find(chunkX, chunkY);
+	Chunk& chunk = existing ? **existing : *m_chunks.Insert(chunkX, chunkY, std::make_unique<Chunk>(chunkX, chunkY));
+	WorldGenerator::GenerateChunkNow(chunk);
+	if (existing)
+		markNeighboursDirty({chunkX, chunkY}, 0xFF); // They were drawn against the old tiles
+	else
+		refreshChunkSeams({chunkX, chunkY});
+	return chunk;
+}
+
+uint32_t World::FillRect(const TileRect& rect, TileType type)
+{
+	const GameTile fill = {type};
+	uint32_t changed = 0;
+	forEachChunkSpan(rect, [&](const ChunkSpan& span)
+	{
+		const bool wholeChunk = span.MinX == 0 && span.MinY == 0 && span.MaxX == Chunk::CHUNK_WIDTH - 1 && span.MaxY == Chunk::CHUNK_HEIGHT - 1;
+		if (!wholeChunk) {
+			const TileRect part = {
+				span.Origin.x + static_cast<int32_t>(span.MinX), span.Origin.y + static_cast<int32_t>(span.MinY),
+				span.Origin.x + static_cast<int32_t>(span.MaxX), span.Origin.y + static_cast<int32_t>(span.MaxY)
+			};
+			changed += EditTilesInRect(part, [fill](int32_t, int32_t, GameTile& target)
+			{
+				target = fill;
+			});
+			return;
+		}
+
+		// Covered chunks become a single palette entry without repacking
+		GameTile tiles[Chunk::CHUNK_TILE_COUNT];
+		span.Target->GetTiles(tiles);
+		const Chunk* neighbours[8];
+		getNeighbourChunks(span.Target->GetPosition(), neighbours);
+		uint32_t chunkChanged = 0;
+		uint8_t borders = 0;
+		for (uint32_t i = 0; i < Chunk::CHUNK_TILE_COUNT; i++) {
+			if (tiles[i].Type != type) {
+				borders |= getChangedBorders(neighbours, i % Chunk::CHUNK_WIDTH, i / Chunk::CHUNK_WIDTH, tiles[i].Type, type);
+				chunkChanged++;
 			}
-			tiles[tileIndex].Variant = 0;
 		}
+		if (chunkChanged > 0) {
+			span.Target->GetPalettedTiles().Fill(fill);
+			span.Target->MarkDirty();
+			span.Target->MarkModified();
+			markNeighboursDirty(span.Target->GetPosition(), borders);
+			changed += chunkChanged;
+		}
+	});
+	return changed;
+}
+
+uint32_t World::CopyRect(const TileRect& source, int32_t destX, int32_t destY)
+{
+	if (source.MaxX < source.MinX || source.MaxY < source.MinY)
+		return 0;
+
+	// Buffered first, so overlapping rects copy what was there before
+	const int32_t width = source.MaxX - source.MinX + 1;
+	const int32_t height = source.MaxY - source.MinY + 1;
+	std::vector<GameTile> buffer(static_cast<size_t>(width) * height);
+	std::vector<uint8_t> loaded(buffer.size(), 0);
+	ForEachTileInRect(source, [&](int32_t x, int32_t y, const GameTile& tile)
+	{
+		const size_t index = static_cast<size_t>(y - source.MinY) * width + (x - source.MinX);
+		buffer[index] = tile;
+		loaded[index] = 1;
+	});
+
+	const TileRect dest = {destX, destY, destX + width - 1, destY + height - 1};
+	return EditTilesInRect(dest, [&](int32_t x, int32_t y, GameTile& tile)
+	{
+		const size_t index = static_cast<size_t>(y - destY) * width + (x - destX);
+		if (loaded[index])
+			tile = buffer[index];
+	});
+}
+
+uint32_t World::ApplyBrush(glm::vec2 center, float radius, TileType type)
+{
+	const TileRect rect = {
+		static_cast<int32_t>(std::floor(center.x - radius)), static_cast<int32_t>(std::floor(center.y - radius)),
+		static_cast<int32_t>(std::floor(center.x + radius)), static_cast<int32_t>(std::floor(center.y + radius))
+	};
+	const float radiusSquared = radius * radius;
+	return EditTilesInRect(rect, [&](int32_t x, int32_t y, GameTile& target)
+	{
+		const float dx = x + 0.5f - center.x;
+		const float dy = y + 0.5f - center.y;
+		if (dx * dx + dy * dy <= radiusSquared)
+			target.Type = type;
+	});
+}
+
+void World::SetAutotileLayout(TileType type, const AutotileLayout& layout)
+{
+	const uint32_t index = static_cast<uint32_t>(type);
+	if (index >= TILE_TYPE_COUNT)
+		return;
+
+	m_autotileLayouts[index] = layout;
+	if (m_renderMapping)
+		rebuildRenderMapping();
+	m_chunks.ForEach([](glm::ivec2, std::unique_ptr<Chunk>& chunk)
+	{
+		chunk->MarkDirty();
+	});
+}
+
+void World::fillAutotileWindow(glm::ivec2 chunkCoord, const GameTile* tiles, AutotileWindow& outWindow) const
+{
+	outWindow.SetChunkTiles(tiles);
+	for (const glm::ivec2& offset : AUTOTILE_OFFSETS) {
+		const std::unique_ptr<Chunk>* neighbour = m_chunks.Find(chunkCoord.x + offset.x, chunkCoord.y + offset.y);
+		if (!neighbour)
+			continue;
+
+		outWindow.SetNeighbour(offset, [&](int32_t localX, int32_t localY)
+		{
+			return (*neighbour)->GetTile(static_cast<uint32_t>(localX), static_cast<uint32_t>(localY)).Type;
+		});
+	}
+}
+
+void World::computeAutotileMasks(glm::ivec2 chunkCoord, const GameTile* tiles, uint8_t* outMasks) const
+{
+	AutotileWindow window;
+	fillAutotileWindow(chunkCoord, tiles, window);
+	window.ComputeMasks(outMasks);
+}
+
+void World::getNeighbourChunks(glm::ivec2 chunkCoord, const Chunk* outNeighbours[8]) const
+{
+	for (uint32_t n = 0; n < 8; n++) {
+		const std::unique_ptr<Chunk>* neighbour = m_chunks.Find(chunkCoord.x + AUTOTILE_OFFSETS[n].x, chunkCoord.y + AUTOTILE_OFFSETS[n].y);
+		outNeighbours[n] = neighbour ? neighbour->get() : nullptr;
 	}
+}
 
-	// Mark all chunks dirty so they get re-rendered
-	for (auto& chunk : m_chunks) {
-		const_cast<Chunk&>(chunk).MarkDirty();
+uint8_t World::getChangedBorders(const Chunk* const neighbours[8], uint32_t localX, uint32_t localY, TileType before, TileType after)
+{
+	constexpr int32_t width = Chunk::CHUNK_WIDTH;
+	constexpr int32_t height = Chunk::CHUNK_HEIGHT;
+	if (Chunk::GetBorderNeighbours(localX, localY) == 0)
+		return 0;
+
+	uint8_t borders = 0;
+	for (const glm::ivec2& offset : AUTOTILE_OFFSETS) {
+		const int32_t x = static_cast<int32_t>(localX) + offset.x;
+		const int32_t y = static_cast<int32_t>(localY) + offset.y;
+		const int32_t chunkOffsetX = FloorDiv(x, width), chunkOffsetY = FloorDiv(y, height);
+		if (chunkOffsetX == 0 && chunkOffsetY == 0)
+			continue;
+
+		// A neighbour that isn't loaded reads the tile when it is (refreshChunkSeams)
+		const int8_t n = NEIGHBOUR_INDEX[chunkOffsetY + 1][chunkOffsetX + 1];
+		const Chunk* neighbour = neighbours[n];
+		if (!neighbour)
+			continue;
+
+		// Its mask bit for this tile is whether the types match
+		const TileType type = neighbour->GetTile(static_cast<uint32_t>(x - chunkOffsetX * width), static_cast<uint32_t>(y - chunkOffsetY * height)).Type;
+		if ((before == type) != (after == type))
+			borders |= 1 << n;
 	}
+	return borders;
 }
 
-GameTile* World::GetTile(uint32_t worldX, uint32_t worldY)
+void World::markNeighboursDirty(glm::ivec2 chunkCoord, uint8_t borders)
 {
-	uint32_t chunkX = worldX / Chunk::CHUNK_WIDTH;
-	uint32_t chunkY = worldY / Chunk::CHUNK_HEIGHT;
-	uint32_t localX = worldX % Chunk::CHUNK_WIDTH;
-	uint32_t localY = worldY % Chunk::CHUNK_HEIGHT;
+	for (uint32_t n = 0; n < 8; n++) {
+		if (!(borders & (1 << n)))
+			continue;
+		if (Chunk* neighbour = GetChunk(chunkCoord.x + AUTOTILE_OFFSETS[n].x, chunkCoord.y + AUTOTILE_OFFSETS[n].y))
+			neighbour->MarkDirty();
+	}
+}
 
-	Chunk* chunk = GetChunk(chunkX, chunkY);
+void World::refreshChunkSeams(glm::ivec2 chunkCoord)
+{
+	constexpr int32_t width = Chunk::CHUNK_WIDTH;
+	constexpr int32_t height = Chunk::CHUNK_HEIGHT;
+
+	const std::unique_ptr<Chunk>* chunk = m_chunks.Find(chunkCoord.x, chunkCoord.y);
 	if (!chunk)
-		return nullptr;
+		return;
 
-	uint32_t tileIndex = localY * Chunk::CHUNK_WIDTH + localX;
-	return const_cast<GameTile*>(&chunk->GetTiles()[tileIndex]);
+	// Only the border strip facing each neighbour can break what it assumed, the interior is never read
+	uint8_t borders = 0;
+	for (uint32_t n = 0; n < 8; n++) {
+		const glm::ivec2 offset = AUTOTILE_OFFSETS[n];
+		const std::unique_ptr<Chunk>* neighbour = m_chunks.Find(chunkCoord.x + offset.x, chunkCoord.y + offset.y);
+		if (!neighbour)
+			continue;
+
+		const int32_t minX = offset.x > 0 ? width - 1 : 0, maxX = offset.x < 0 ? 0 : width - 1;
+		const int32_t minY = offset.y > 0 ? height - 1 : 0, maxY = offset.y < 0 ? 0 : height - 1;
+		bool differs = false;
+		for (int32_t y = minY; y <= maxY && !differs; y++) {
+			for (int32_t x = minX; x <= maxX && !differs; x++) {
+				const TileType type = (*chunk)->GetTile(static_cast<uint32_t>(x), static_cast<uint32_t>(y)).Type;
+				// The neighbour's tiles touching this one, in the neighbour's local coordinates
+				for (const glm::ivec2& step : AUTOTILE_OFFSETS) {
+					const int32_t localX = x + step.x - offset.x * width, localY = y + step.y - offset.y * height;
+					if (localX < 0 || localX >= width || localY < 0 || localY >= height)
+						continue;
+					if ((*neighbour)->GetTile(static_cast<uint32_t>(localX), static_cast<uint32_t>(localY)).Type != type) {
+						differs = true;
+						break;
+					}
+				}
+			}
+		}
+		if (differs)
+			borders |= 1 << n;
+	}
+	markNeighboursDirty(chunkCoord, borders);
 }
 
-Chunk* World::GetChunk(uint32_t chunkX, uint32_t chunkY)
+size_t World::GetTileMemoryUsage() const
 {
-	uint32_t index = getChunkIndex(chunkX, chunkY);
-	if (index >= m_chunks.size())
-		return nullptr;
-	return &m_chunks[index];
+	size_t bytes = 0;
+	m_chunks.ForEach([&](glm::ivec2, const std::unique_ptr<Chunk>& chunk)
+	{
+		bytes += chunk->GetMemoryUsage();
+	});
+	return bytes;
 }
 
-uint32_t World::getChunkIndex(uint32_t chunkX, uint32_t chunkY) const
+uint32_t World::Autosave()
 {
-	return chunkY * m_worldWidthInChunks + chunkX;
+	uint32_t queued = 0;
+	m_chunks.ForEach([&](glm::ivec2, std::unique_ptr<Chunk>& chunk)
+	{
+		if (chunk->IsModified()) {
+			m_saver.QueueSave(*chunk);
+			queued++;
+		}
+	});
+	return queued;
 }
 
 } // namespace TerracottaGame
\ No newline at end of file
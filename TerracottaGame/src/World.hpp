@@ -1,36 +1,228 @@
 #pragma once
+#include <algorithm>
 #include <filesystem>
 #include <cstdint>
+#include <memory>
 #include <vector>
+#include "glm/glm.hpp"
+#include "ChunkHashMap.hpp"
 #include "Chunk.hpp"
+#include "ChunkSaver.hpp"
+#include "WorldGenerator.hpp"
 #include "SharedDataTypes.h"
 
 namespace TerracottaGame
 {
 
 using Filepath = std::filesystem::path;
+using TerracottaEngine::ChunkHashMap;
+
+// Keeps the world around it loaded (the camera for now), in tiles
+struct WorldObserver
+{
+	glm::vec2 Position;
+	float Radius;
+};
+
+// Tiles from (MinX, MinY) to (MaxX, MaxY) inclusive, in world coordinates
+struct TileRect
+{
+	int32_t MinX, MinY;
+	int32_t MaxX, MaxY;
+};
 
 class World
 {
 public:
+	static constexpr uint32_t MAP_REGION_CHUNKS = 16; // Minimap and fog of war cover this many chunks from (0, 0)
+
 	World();
 	~World();
 
-	void Init(uint32_t worldWidthInChunks, uint32_t worldHeightInChunks);
-	void UpdateChunkRendering(uint32_t chunkX, uint32_t chunkY);
+	void Init(uint32_t seed);
+	// Saves modified chunks first, waiting for them to be written
+	void Shutdown();
+	// Loads saved chunks around the observers and queues the other missing ones for background generation, nearest
+	// first, takes in the ones that finished and drops the ones far from all of them. Modified chunks are saved when
+	// dropped, the rest are regenerated from the seed when they come back.
+	void UpdateStreaming(const std::vector<WorldObserver>& observers);
+	// Autotiles the chunk from its types and its loaded neighbours' border tiles, then uploads it. Streamed in chunks
+	// arrive already meshed by the generator, this is for edits and chunks loaded from saves.
+	void UpdateChunkRendering(Chunk& chunk);
 	void UpdateAllDirtyChunks();
+#ifdef TERRACOTTA_DEBUG_DRAW
+	void DrawDebugOverlay();
+#endif
+
+	// Margins in chunks around an observer's radius, unloading uses the larger one so edge chunks don't thrash
+	void SetStreamingMargins(int32_t loadMargin, int32_t unloadMargin);
+
+	// False while the tile's chunk isn't loaded
+	bool GetTile(int32_t worldX, int32_t worldY, GameTile& outTile) const;
+	bool SetTile(int32_t worldX, int32_t worldY, TileType type);
 
-	void SetTileData(const std::vector<float>& data);
-	GameTile* GetTile(uint32_t worldX, uint32_t worldY);
-	Chunk* GetChunk(uint32_t chunkX, uint32_t chunkY);
+	// Area access, walked chunk by chunk with one lookup and one unpack each, skipping chunks that aren't loaded.
+	// Prefer these over GetTile/SetTile loops. func(worldX, worldY, const GameTile&)
+	template <typename Func>
+	void ForEachTileInRect(const TileRect& rect, Func&& func) const;
+	// func(worldX, worldY, GameTile&) edits in place. Chunks with changes are repacked and marked dirty and modified
+	// once each, and neighbours are marked dirty when a changed border tile changes one of their variants. Returns
+	// how many tiles changed.
+	template <typename Func>
+	uint32_t EditTilesInRect(const TileRect& rect, Func&& func);
+	uint32_t FillRect(const TileRect& rect, TileType type);
+	// Copies source to the same size rect at (destX, destY), overlap is fine. Tiles of unloaded chunks are skipped
+	// on either side.
+	uint32_t CopyRect(const TileRect& source, int32_t destX, int32_t destY);
+	// Sets every tile whose center is within radius of center
+	uint32_t ApplyBrush(glm::vec2 center, float radius, TileType type);
+	// nullptr while the chunk isn't loaded
+	Chunk* GetChunk(int32_t chunkX, int32_t chunkY);
+	// Loads or generates the chunk first if it isn't loaded
+	Chunk& GetOrCreateChunk(int32_t chunkX, int32_t chunkY);
+	// (Re)generates one chunk right away on this thread, from the seed and its world coordinates
+	Chunk& GenerateChunk(int32_t chunkX, int32_t chunkY);
+	// Snapshots every modified chunk for the background writer and returns how many, cheap enough to call any frame
+	uint32_t Autosave();
+	size_t GetLoadedChunkCount() const { return m_chunks.Size(); }
+	// Resident bytes of all loaded chunks, tiles included
+	size_t GetTileMemoryUsage() const;
+	WorldGenerationProgress GetGenerationProgress() const { return m_generator.GetProgress(); }
+
+	// Which atlas tiles a type's variants use, every type is a single tile until set
+	void SetAutotileLayout(TileType type, const AutotileLayout& layout);
 private:
-	std::vector<Chunk> m_chunks;
+	// The part of one loaded chunk inside a rect, in local coordinates, inclusive
+	struct ChunkSpan
+	{
+		Chunk* Target;
+		glm::ivec2 Origin; // World coordinates of the chunk's tile (0, 0)
+		uint32_t MinX, MinY;
+		uint32_t MaxX, MaxY;
+	};
+
+	static constexpr uint32_t MAX_CHUNKS_COLLECTED_PER_UPDATE = 16; // Render uploads stay on the main thread, spread them over frames
+
+	ChunkHashMap<std::unique_ptr<Chunk>> m_chunks;
+	WorldGenerator m_generator;
+	ChunkSaver m_saver; // One save directory per seed
+	std::vector<GeneratedChunk> m_collected; // Reused every update
+	uint32_t m_seed = 0; // Engine noise seed, set in Init
+	int32_t m_loadMargin = 1;
+	int32_t m_unloadMargin = 3;
 	// Atlas tracking
 	AtlasInfo m_terrainAtlasInfo = {};
 	uint32_t m_terrainAtlasId = 0;
-	uint32_t m_worldWidthInChunks = 0;
-	uint32_t m_worldHeightInChunks = 0;
+	AutotileLayout m_autotileLayouts[TILE_TYPE_COUNT];
+	std::shared_ptr<const TileRenderMapping> m_renderMapping; // Shared with the generator's workers, nullptr until the atlas loads
 
-	uint32_t getChunkIndex(uint32_t chunkX, uint32_t chunkY) const;
+	template <typename Func>
+	void forEachChunkSpan(const TileRect& rect, Func&& func) const;
+	// The chunk's tiles and its loaded neighbours' border tiles. Neighbours in chunks that aren't loaded count as the
+	// same type, so the edge of the loaded world doesn't draw borders that aren't there.
+	void fillAutotileWindow(glm::ivec2 chunkCoord, const GameTile* tiles, AutotileWindow& outWindow) const;
+	// AutotileNeighbour masks for a chunk's tiles
+	void computeAutotileMasks(glm::ivec2 chunkCoord, const GameTile* tiles, uint8_t* outMasks) const;
+	// Fixes up the border tiles of a worker-built mesh for the loaded neighbours and uploads it
+	void uploadGeneratedMesh(Chunk& chunk, ChunkMesh& mesh);
+	// Snapshots the atlas UVs and autotile layouts for meshing, here and on the generator's workers
+	void rebuildRenderMapping();
+	// Loaded neighbours of a chunk in AutotileNeighbour bit order, nullptr for the ones that aren't
+	void getNeighbourChunks(glm::ivec2 chunkCoord, const Chunk* outNeighbours[8]) const;
+	// The neighbours whose masks change when a tile changes type, as AutotileNeighbour bits. A mask only sees whether
+	// two tiles match, so A to B next to C changes nothing.
+	static uint8_t getChangedBorders(const Chunk* const neighbours[8], uint32_t localX, uint32_t localY, TileType before, TileType after);
+	// Marks the loaded neighbours in borders (AutotileNeighbour bits) dirty
+	void markNeighboursDirty(glm::ivec2 chunkCoord, uint8_t borders);
+	// Neighbours drawn while the chunk wasn't loaded assumed it continued their tiles, marks the ones whose facing
+	// tiles meet a different type across the seam
+	void refreshChunkSeams(glm::ivec2 chunkCoord);
 };
+
+template <typename Func>
+void World::forEachChunkSpan(const TileRect& rect, Func&& func) const
+{
+	if (rect.MaxX < rect.MinX || rect.MaxY < rect.MinY)
+		return;
+
+	constexpr int32_t width = Chunk::CHUNK_WIDTH;
+	constexpr int32_t height = Chunk::CHUNK_HEIGHT;
+	const int32_t minChunkX = FloorDiv(rect.MinX, width), maxChunkX = FloorDiv(rect.MaxX, width);
+	const int32_t minChunkY = FloorDiv(rect.MinY, height), maxChunkY = FloorDiv(rect.MaxY, height);
+	for (int32_t chunkY = minChunkY; chunkY <= maxChunkY; chunkY++) {
+		for (int32_t chunkX = minChunkX; chunkX <= maxChunkX; chunkX++) {
+			const std::unique_ptr<Chunk>* chunk = m_chunks.Find(chunkX, chunkY);
+			if (!chunk)
+				continue;
+
+			ChunkSpan span;
+			span.Target = chunk->get();
+			span.Origin = glm::ivec2(chunkX * width, chunkY * height);
+			span.MinX = static_cast<uint32_t>(std::max(rect.MinX - span.Origin.x, 0));
+			span.MinY = static_cast<uint32_t>(std::max(rect.MinY - span.Origin.y, 0));
+			span.MaxX = static_cast<uint32_t>(std::min(rect.MaxX - span.Origin.x, width - 1));
+			span.MaxY = static_cast<uint32_t>(std::min(rect.MaxY - span.Origin.y, height - 1));
+			func(span);
+		}
+	}
+}
+
+template <typename Func>
+void World::ForEachTileInRect(const TileRect& rect, Func&& func) const
+{
+	GameTile tiles[Chunk::CHUNK_TILE_COUNT];
+	forEachChunkSpan(rect, [&](const ChunkSpan& span)
+	{
+		span.Target->GetTiles(tiles);
+		for (uint32_t y = span.MinY; y <= span.MaxY; y++) {
+			const GameTile* row = tiles + y * Chunk::CHUNK_WIDTH;
+			const int32_t worldY = span.Origin.y + static_cast<int32_t>(y);
+			for (uint32_t x = span.MinX; x <= span.MaxX; x++)
+				func(span.Origin.x + static_cast<int32_t>(x), worldY, static_cast<const GameTile&>(row[x]));
+		}
+	});
+}
+
+template <typename Func>
+uint32_t World::EditTilesInRect(const TileRect& rect, Func&& func)
+{
+	GameTile tiles[Chunk::CHUNK_TILE_COUNT];
+	uint32_t changed = 0;
+	forEachChunkSpan(rect, [&](const ChunkSpan& span)
+	{
+		span.Target->GetTiles(tiles);
+		const Chunk* neighbours[8];
+		bool neighboursFound = false; // Looked up on the first changed border tile
+		uint32_t chunkChanged = 0;
+		uint8_t borders = 0;
+		for (uint32_t y = span.MinY; y <= span.MaxY; y++) {
+			GameTile* row = tiles + y * Chunk::CHUNK_WIDTH;
+			const int32_t worldY = span.Origin.y + static_cast<int32_t>(y);
+			for (uint32_t x = span.MinX; x <= span.MaxX; x++) {
+				const TileType before = row[x].Type;
+				func(span.Origin.x + static_cast<int32_t>(x), worldY, row[x]);
+				if (row[x].Type == before)
+					continue;
+
+				chunkChanged++;
+				if (Chunk::GetBorderNeighbours(x, y) == 0)
+					continue;
+				if (!neighboursFound) {
+					getNeighbourChunks(span.Target->GetPosition(), neighbours);
+					neighboursFound = true;
+				}
+				borders |= getChangedBorders(neighbours, x, y, before, row[x].Type);
+			}
+		}
+
+		if (chunkChanged > 0) {
+			span.Target->SetTiles(tiles);
+			span.Target->MarkDirty();
+			span.Target->MarkModified();
+			markNeighboursDirty(span.Target->GetPosition(), borders);
+			changed += chunkChanged;
+		}
+	});
+	return changed;
+}
 } // namespace TerracottaGame
\ No newline at end of file
@@ -0,0 +1,421 @@
+#include <algorithm>
+#include "WorldGenerator.hpp"
+#include "EngineConnection.hpp" // For Engine:: and g_engineAPI
+#include "spdlog/spdlog.h"
+
+namespace TerracottaGame
+{
+
+static constexpr float ROCK_THRESHOLD = 0.5f;
+
+// Same order as the AutotileNeighbour bits, World's autotiling has to agree with generation
+static const glm::ivec2 (&NEIGHBOUR_OFFSETS)[8] = AUTOTILE_OFFSETS;
+
+WorldGenerator::WorldGenerator()
+{}
+
+WorldGenerator::~WorldGenerator()
+{
+	Shutdown();
+}
+
+void WorldGenerator::Init(uint32_t workerCount)
+{
+	if (workerCount == 0) {
+		const uint32_t cores = std::thread::hardware_concurrency();
+		workerCount = cores > 1 ? cores - 1 : 1;
+	}
+	workerCount = std::min(workerCount, MAX_WORKERS);
+
+	m_stopWorkers = false;
+	for (uint32_t i = 0; i < workerCount; i++) {
+		m_workers.emplace_back(&WorldGenerator::workerLoop, this);
+	}
+
+	SPDLOG_INFO("World generator started with {} workers", workerCount);
+}
+
+void WorldGenerator::Shutdown()
+{
+	if (!m_workers.empty()) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopWorkers = true;
+		}
+		m_condition.notify_all();
+		for (std::thread& worker : m_workers) {
+			worker.join();
+		}
+		m_workers.clear();
+	}
+
+	m_entries.Clear();
+	m_jobs.clear();
+	m_finished.clear();
+	m_pruneCandidates.clear();
+	m_renderMapping.reset();
+	m_collectedTotal = 0;
+	m_update = 0;
+}
+
+void WorldGenerator::SetRenderMapping(std::shared_ptr<const TileRenderMapping> mapping)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_renderMapping = std::move(mapping);
+}
+
+void WorldGenerator::Request(int32_t chunkX, int32_t chunkY, float priority)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Entry& entry = getOrCreateEntry(chunkX, chunkY, priority);
+	entry.Priority = priority;
+	entry.RefreshedUpdate = m_update;
+	if (entry.Requested)
+		return;
+
+	entry.Requested = true;
+	for (const glm::ivec2& offset : NEIGHBOUR_OFFSETS) {
+		getOrCreateEntry(chunkX + offset.x, chunkY + offset.y, priority);
+	}
+
+	// Released after it was autotiled, only its edges are left
+	if (entry.Stage == GenerationStage::Classified && !entry.Types && !entry.JobQueued && !entry.Busy)
+		queueJob({chunkX, chunkY}, entry);
+	queueAutotileIfReady({chunkX, chunkY});
+}
+
+bool WorldGenerator::UpdatePriority(int32_t chunkX, int32_t chunkY, float priority)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::unique_ptr<Entry>* found = m_entries.Find(chunkX, chunkY);
+	if (!found || !(*found)->Requested)
+		return false;
+
+	(*found)->Priority = priority;
+	(*found)->RefreshedUpdate = m_update;
+	return true;
+}
+
+void WorldGenerator::Release(int32_t chunkX, int32_t chunkY)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::unique_ptr<Entry>* found = m_entries.Find(chunkX, chunkY);
+	if (!found)
+		return;
+
+	releaseEntry({chunkX, chunkY}, **found);
+}
+
+uint32_t WorldGenerator::ReleaseUnrefreshed()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<glm::ivec2> stale;
+	m_entries.ForEach([this, &stale](glm::ivec2 coord, const std::unique_ptr<Entry>& entry)
+	{
+		if (entry->Requested && entry->Stage != GenerationStage::Collected && entry->RefreshedUpdate != m_update)
+			stale.push_back(coord);
+	});
+	for (const glm::ivec2& coord : stale) {
+		releaseEntry(coord, **m_entries.Find(coord.x, coord.y));
+	}
+	pruneEntries();
+
+	m_update++;
+	return static_cast<uint32_t>(stale.size());
+}
+
+void WorldGenerator::Collect(std::vector<GeneratedChunk>& outChunks, uint32_t maxCount)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	size_t processed = 0;
+	uint32_t collected = 0;
+	for (; processed < m_finished.size() && collected < maxCount; processed++) {
+		const glm::ivec2 coord = m_finished[processed];
+		std::unique_ptr<Entry>* found = m_entries.Find(coord.x, coord.y);
+		if (!found || (*found)->Stage != GenerationStage::Finished)
+			continue; // Released since
+
+		Entry& entry = **found;
+		outChunks.push_back(std::move(entry.Result));
+		entry.Result = {};
+		entry.Stage = GenerationStage::Collected;
+		m_collectedTotal++;
+		collected++;
+
+		// Neighbours that were only kept for this chunk may be done now
+		addPruneCandidates(coord);
+	}
+	m_finished.erase(m_finished.begin(), m_finished.begin() + processed);
+
+	pruneEntries();
+}
+
+WorldGenerationProgress WorldGenerator::GetProgress() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	WorldGenerationProgress progress;
+	progress.Collected = m_collectedTotal;
+	m_entries.ForEach([&progress](glm::ivec2, const std::unique_ptr<Entry>& entry)
+	{
+		if (!entry->Requested)
+			return;
+
+		switch (entry->Stage) {
+		case GenerationStage::Queued: progress.Queued++; break;
+		case GenerationStage::Classified: progress.Classified++; break;
+		case GenerationStage::Finished: progress.Finished++; break;
+		default: break;
+		}
+	});
+	return progress;
+}
+
+void WorldGenerator::ClassifyChunk(int32_t chunkX, int32_t chunkY, TileType* outTypes)
+{
+	// Exactly this chunk's tiles, sampled at their world coordinates
+	float noise[Chunk::CHUNK_TILE_COUNT];
+	Engine::GetNoiseRegion(chunkX * (int32_t)Chunk::CHUNK_WIDTH, chunkY * (int32_t)Chunk::CHUNK_HEIGHT, Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, noise);
+
+	for (uint32_t i = 0; i < Chunk::CHUNK_TILE_COUNT; ++i) {
+		outTypes[i] = noise[i] > ROCK_THRESHOLD ? TileType::ROCK : TileType::GRASS;
+	}
+}
+
+void WorldGenerator::MeshChunk(glm::ivec2 chunkCoord, const AutotileWindow& window, const GameTile* tiles, const TileRenderMapping& mapping, ChunkMesh& outMesh)
+{
+	window.ComputeMasks(outMesh.Masks);
+	BuildRenderTiles(chunkCoord, tiles, outMesh.Masks, mapping, outMesh.Tiles);
+}
+
+void WorldGenerator::GenerateChunkNow(Chunk& chunk)
+{
+	const glm::ivec2 position = chunk.GetPosition();
+	TileType types[Chunk::CHUNK_TILE_COUNT];
+	ClassifyChunk(position.x, position.y, types);
+
+	GameTile tiles[Chunk::CHUNK_TILE_COUNT];
+	for (uint32_t i = 0; i < Chunk::CHUNK_TILE_COUNT; i++)
+		tiles[i].Type = types[i];
+	chunk.SetTiles(tiles);
+	chunk.MarkDirty();
+}
+
+TileType WorldGenerator::getEdgeTile(const Entry& entry, int32_t localX, int32_t localY)
+{
+	if (localY == 0)
+		return entry.Edges[EDGE_SOUTH][localX];
+	if (localY == static_cast<int32_t>(Chunk::CHUNK_HEIGHT) - 1)
+		return entry.Edges[EDGE_NORTH][localX];
+	if (localX == 0)
+		return entry.Edges[EDGE_WEST][localY];
+	return entry.Edges[EDGE_EAST][localY];
+}
+
+WorldGenerator::Entry& WorldGenerator::getOrCreateEntry(int32_t chunkX, int32_t chunkY, float priority)
+{
+	if (std::unique_ptr<Entry>* found = m_entries.Find(chunkX, chunkY)) {
+		(*found)->Priority = std::min((*found)->Priority, priority);
+		return **found;
+	}
+
+	Entry& entry = *m_entries.Insert(chunkX, chunkY, std::make_unique<Entry>());
+	entry.Priority = priority;
+	queueJob({chunkX, chunkY}, entry);
+	return entry;
+}
+
+void WorldGenerator::releaseEntry(glm::ivec2 coord, Entry& entry)
+{
+	// The edges stay valid, so it can still be a neighbour without classifying it again
+	entry.Requested = false;
+	if (entry.Stage == GenerationStage::Finished || entry.Stage == GenerationStage::Collected) {
+		entry.Result = {};
+		entry.Stage = GenerationStage::Classified;
+	}
+	addPruneCandidates(coord);
+}
+
+void WorldGenerator::queueJob(glm::ivec2 coord, Entry& entry)
+{
+	entry.JobQueued = true;
+	m_jobs.push_back(coord);
+	m_condition.notify_one();
+}
+
+bool WorldGenerator::isAutotileReady(glm::ivec2 coord, const Entry& entry) const
+{
+	if (!entry.Requested || entry.Stage != GenerationStage::Classified || !entry.Types)
+		return false;
+
+	for (const glm::ivec2& offset : NEIGHBOUR_OFFSETS) {
+		const std::unique_ptr<Entry>* neighbour = m_entries.Find(coord.x + offset.x, coord.y + offset.y);
+		if (!neighbour || (*neighbour)->Stage == GenerationStage::Queued)
+			return false;
+	}
+	return true;
+}
+
+void WorldGenerator::queueAutotileIfReady(glm::ivec2 coord)
+{
+	std::unique_ptr<Entry>* found = m_entries.Find(coord.x, coord.y);
+	if (!found || (*found)->Busy || (*found)->JobQueued || !isAutotileReady(coord, **found))
+		return;
+
+	queueJob(coord, **found);
+}
+
+void WorldGenerator::addPruneCandidates(glm::ivec2 coord)
+{
+	m_pruneCandidates.push_back(coord);
+	for (const glm::ivec2& offset : NEIGHBOUR_OFFSETS) {
+		m_pruneCandidates.push_back(coord + offset);
+	}
+}
+
+void WorldGenerator::pruneEntries()
+{
+	for (const glm::ivec2& coord : m_pruneCandidates) {
+		std::unique_ptr<Entry>* found = m_entries.Find(coord.x, coord.y);
+		if (!found || (*found)->Requested || (*found)->Busy)
+			continue;
+
+		// Kept while a neighbour still has to be autotiled against it (or is reading it right now)
+		bool needed = false;
+		for (const glm::ivec2& offset : NEIGHBOUR_OFFSETS) {
+			const std::unique_ptr<Entry>* neighbour = m_entries.Find(coord.x + offset.x, coord.y + offset.y);
+			if (neighbour && ((*neighbour)->Busy || ((*neighbour)->Requested && (*neighbour)->Stage != GenerationStage::Collected))) {
+				needed = true;
+				break;
+			}
+		}
+		if (!needed) {
+			m_entries.Erase(coord.x, coord.y); // A queued job for it is skipped when picked
+		}
+	}
+	m_pruneCandidates.clear();
+}
+
+void WorldGenerator::workerLoop()
+{
+	constexpr int32_t width = Chunk::CHUNK_WIDTH;
+	constexpr int32_t height = Chunk::CHUNK_HEIGHT;
+	TileType types[Chunk::CHUNK_TILE_COUNT];
+
+	// Queued chunks, and requested ones released after autotiling, need their types (again)
+	auto needsClassifying = [](const Entry& entry)
+	{
+		return entry.Stage == GenerationStage::Queued || (entry.Requested && entry.Stage == GenerationStage::Classified && !entry.Types);
+	};
+
+	while (true) {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this] { return m_stopWorkers || !m_jobs.empty(); });
+		if (m_stopWorkers)
+			return;
+
+		// Lowest priority value first, dropping jobs whose chunk went away or can't be worked on anymore
+		Entry* entry = nullptr;
+		size_t best = 0;
+		for (size_t i = 0; i < m_jobs.size();) {
+			std::unique_ptr<Entry>* found = m_entries.Find(m_jobs[i].x, m_jobs[i].y);
+			const bool stale = !found || !(*found)->JobQueued || (!needsClassifying(**found) && !isAutotileReady(m_jobs[i], **found));
+			if (stale) {
+				if (found)
+					(*found)->JobQueued = false;
+				m_jobs[i] = m_jobs.back();
+				m_jobs.pop_back();
+				continue;
+			}
+			if (!entry || (*found)->Priority < entry->Priority) {
+				entry = found->get();
+				best = i;
+			}
+			i++;
+		}
+		if (!entry)
+			continue;
+
+		const glm::ivec2 coord = m_jobs[best];
+		m_jobs[best] = m_jobs.back();
+		m_jobs.pop_back();
+		entry->JobQueued = false;
+		entry->Busy = true;
+
+		if (needsClassifying(*entry)) {
+			lock.unlock();
+			ClassifyChunk(coord.x, coord.y, types);
+			lock.lock();
+
+			if (!entry->Types)
+				entry->Types = std::make_unique<TileType[]>(Chunk::CHUNK_TILE_COUNT);
+			std::copy(std::begin(types), std::end(types), entry->Types.get());
+			if (entry->Stage == GenerationStage::Queued) {
+				// Neighbours may read the edges outside the lock from now on, so they're only written this once
+				for (int32_t i = 0; i < width; i++) {
+					entry->Edges[EDGE_SOUTH][i] = types[i];
+					entry->Edges[EDGE_NORTH][i] = types[(height - 1) * width + i];
+					entry->Edges[EDGE_WEST][i] = types[i * width];
+					entry->Edges[EDGE_EAST][i] = types[i * width + width - 1];
+				}
+				entry->Stage = GenerationStage::Classified;
+			}
+			entry->Busy = false;
+
+			// This may have been the last neighbour something was waiting for
+			queueAutotileIfReady(coord);
+			for (const glm::ivec2& offset : NEIGHBOUR_OFFSETS) {
+				queueAutotileIfReady(coord + offset);
+			}
+		} else {
+			// Neighbours can't be pruned while this entry is busy, and their edges don't change anymore
+			const Entry* neighbours[8];
+			for (uint32_t n = 0; n < 8; n++) {
+				neighbours[n] = m_entries.Find(coord.x + NEIGHBOUR_OFFSETS[n].x, coord.y + NEIGHBOUR_OFFSETS[n].y)->get();
+			}
+			std::shared_ptr<const TileRenderMapping> mapping = m_renderMapping;
+			lock.unlock();
+
+			AutotileWindow window;
+			window.SetChunkTypes(entry->Types.get());
+			for (uint32_t n = 0; n < 8; n++) {
+				window.SetNeighbour(NEIGHBOUR_OFFSETS[n], [&](int32_t localX, int32_t localY)
+				{
+					return getEdgeTile(*neighbours[n], localX, localY);
+				});
+			}
+
+			GameTile tiles[Chunk::CHUNK_TILE_COUNT];
+			for (uint32_t i = 0; i < Chunk::CHUNK_TILE_COUNT; i++)
+				tiles[i].Type = entry->Types[i];
+			GeneratedChunk result;
+			result.Result = std::make_unique<Chunk>(coord.x, coord.y);
+			result.Result->SetTiles(tiles); // Palette packing happens here on the worker too
+			if (mapping) {
+				result.Mesh = std::make_unique<ChunkMesh>();
+				MeshChunk(coord, window, tiles, *mapping, *result.Mesh);
+				result.Mesh->Mapping = std::move(mapping);
+			}
+			lock.lock();
+
+			entry->Busy = false;
+			if (entry->Requested) {
+				entry->Types.reset(); // The chunk has them now, neighbours only need the edges
+				entry->Result = std::move(result);
+				entry->Stage = GenerationStage::Finished;
+				m_finished.push_back(coord);
+			}
+		}
+
+		if (!entry->Requested) {
+			addPruneCandidates(coord);
+		}
+	}
+}
+
+} // namespace TerracottaGame
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "glm/glm.hpp"
+#include "ChunkHashMap.hpp"
+#include "Chunk.hpp"
+#include "ChunkMesh.hpp"
+
+namespace TerracottaGame
+{
+using TerracottaEngine::ChunkHashMap;
+
+enum class GenerationStage : uint8_t
+{
+	Queued, // Waiting for noise and classification
+	Classified, // Tile types are final, waiting for all 8 neighbours to get here before autotiling
+	Finished, // Autotiled and meshed, waiting for the world to collect it
+	Collected // The world owns the chunk, its edge tiles stay for chunks generated next to it later
+};
+
+// Requested chunks by stage, chunks only generated as someone's neighbour aren't counted
+struct WorldGenerationProgress
+{
+	uint32_t Queued = 0;
+	uint32_t Classified = 0;
+	uint32_t Finished = 0;
+	uint32_t Collected = 0; // Total handed to the world since Init
+
+	uint32_t GetPending() const { return Queued + Classified + Finished; }
+};
+
+// A finished chunk with the mesh its workers built against the generated neighbours
+struct GeneratedChunk
+{
+	std::unique_ptr<Chunk> Result;
+	std::unique_ptr<ChunkMesh> Mesh; // nullptr if there was no render mapping yet
+};
+
+// Generates chunks on a pool of worker threads in stages: noise and tile classification for each chunk on its own,
+// then autotiling and building its RenderTiles once its neighbours are classified. Finished chunks are handed back
+// to the main thread, which keeps everything that talks to the renderer. Chunk palettes only ever hold tile types,
+// the masks travel with the mesh.
+class WorldGenerator
+{
+public:
+	static constexpr uint32_t MAX_WORKERS = 4;
+
+	WorldGenerator();
+	~WorldGenerator();
+
+	// 0 workers picks from the core count, leaving one for the main thread. The noise seed has to be set already.
+	void Init(uint32_t workerCount = 0);
+	// Joins the workers, anything unfinished is dropped
+	void Shutdown();
+
+	// Chunks finished after this are meshed with it, nullptr leaves meshing to the main thread
+	void SetRenderMapping(std::shared_ptr<const TileRenderMapping> mapping);
+
+	// Queues the chunk, or moves it in the queue if it's already there (lower priority goes first).
+	// Its neighbours get classified too, but only requested chunks are handed out.
+	void Request(int32_t chunkX, int32_t chunkY, float priority);
+	// Moves an already requested chunk in the queue, false (and nothing queued) if it isn't requested
+	bool UpdatePriority(int32_t chunkX, int32_t chunkY, float priority);
+	// The world unloaded the chunk or doesn't want it anymore
+	void Release(int32_t chunkX, int32_t chunkY);
+	// Releases requested chunks that weren't requested again or updated since the last call, so the queue only holds
+	// what's still in range. Call once per update after requesting, collected chunks are left to the world.
+	uint32_t ReleaseUnrefreshed();
+	// Moves up to maxCount finished chunks into outChunks, and frees what nothing depends on anymore
+	void Collect(std::vector<GeneratedChunk>& outChunks, uint32_t maxCount);
+	WorldGenerationProgress GetProgress() const;
+	uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+	// Pipeline stages, pure functions of the seed and chunk coordinates
+	static void ClassifyChunk(int32_t chunkX, int32_t chunkY, TileType* outTypes);
+	// window holds the chunk's types and its generated neighbours' edges
+	static void MeshChunk(glm::ivec2 chunkCoord, const AutotileWindow& window, const GameTile* tiles, const TileRenderMapping& mapping, ChunkMesh& outMesh);
+	// Generates one chunk's tiles on the calling thread, same result as the workers. World meshes it when it draws it.
+	static void GenerateChunkNow(Chunk& chunk);
+private:
+	enum EdgeSide : uint8_t
+	{
+		EDGE_SOUTH = 0, // Row y = 0
+		EDGE_NORTH = 1, // Row y = CHUNK_HEIGHT - 1
+		EDGE_WEST = 2, // Column x = 0
+		EDGE_EAST = 3 // Column x = CHUNK_WIDTH - 1
+	};
+	static_assert(Chunk::CHUNK_WIDTH == Chunk::CHUNK_HEIGHT, "Edges are stored as rows of one length");
+
+	struct Entry
+	{
+		std::unique_ptr<TileType[]> Types; // CHUNK_TILE_COUNT, from classification until the chunk is autotiled
+		TileType Edges[4][Chunk::CHUNK_WIDTH]; // By EdgeSide, written once by classification, what neighbours read
+		GeneratedChunk Result; // Only while Finished
+		GenerationStage Stage = GenerationStage::Queued;
+		float Priority = 0.0f;
+		uint32_t RefreshedUpdate = 0; // m_update when it was last requested or had its priority updated
+		bool Requested = false; // Otherwise it's only here as a neighbour
+		bool JobQueued = false;
+		bool Busy = false; // A worker is using it outside the lock
+	};
+
+	// Entries are boxed so workers can keep pointers while the map grows
+	ChunkHashMap<std::unique_ptr<Entry>> m_entries;
+	std::vector<glm::ivec2> m_jobs; // Picked by the entry's current priority, a linear scan is fine at these counts
+	std::vector<glm::ivec2> m_finished;
+	std::vector<glm::ivec2> m_pruneCandidates;
+	std::shared_ptr<const TileRenderMapping> m_renderMapping;
+	uint32_t m_collectedTotal = 0;
+	uint32_t m_update = 0; // Counts ReleaseUnrefreshed calls
+
+	std::vector<std::thread> m_workers;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_stopWorkers = false;
+
+	// A classified entry's tile, in its local coordinates, on one of its edges
+	static TileType getEdgeTile(const Entry& entry, int32_t localX, int32_t localY);
+	Entry& getOrCreateEntry(int32_t chunkX, int32_t chunkY, float priority);
+	void releaseEntry(glm::ivec2 coord, Entry& entry);
+	void queueJob(glm::ivec2 coord, Entry& entry);
+	// Requested, classified, and so are all 8 neighbours
+	bool isAutotileReady(glm::ivec2 coord, const Entry& entry) const;
+	void queueAutotileIfReady(glm::ivec2 coord);
+	void addPruneCandidates(glm::ivec2 coord);
+	void pruneEntries();
+	void workerLoop();
+};
+} // namespace TerracottaGame
\ No newline at end of file